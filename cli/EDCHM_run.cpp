@@ -0,0 +1,160 @@
+// Runs one of the example models (EDCHM_mini, EDCHM_snow, EDCHM_GR4J) without R
+//
+// EDCHM_run MODELL N_TIME N_SPAT DIR_IN DIR_OUT [--thread N] [--out NAME ...]
+//
+// Every argument of the R function is read from `DIR_IN/<argument name>.bin`,
+// raw float64 in the byte order of the machine (e.g. `writeBin()` in R or
+// `numpy.ndarray.tofile()`):
+// - a forcing matrix has N_TIME x N_SPAT values, column major (one column per spatial unit)
+// - a constant or parameter has N_SPAT values, or one value for all spatial units
+// Every asked output variable (`--out`, default the streamflow) is written to
+// `DIR_OUT/<name>.bin`, N_TIME x N_SPAT values in the same layout.
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EDCHM_core.h"
+
+using namespace EDCHM;
+
+struct modell_info {
+  const char* name;
+  std::vector<std::string> forcing, param;
+  const std::vector<std::string>* output;
+  const char* output_default;
+};
+
+static const std::vector<modell_info> modell_list = {
+  {"EDCHM_mini",
+   {"atmos_potentialEvatrans_mm", "atmos_precipitation_mm"},
+   {"ground_capacity_mm", "ground_water_mm", "land_impermeableFrac_1", "soil_capacity_mm",
+    "soil_potentialPercola_mm", "soil_water_mm", "confluenLand_responseTime_TS", "confluenGround_responseTime_TS",
+    "param_baseflow_grf_gamma", "param_confluenLand_kel_k", "param_evatrans_ubc_gamma", "param_infilt_ubc_P0AGEN",
+    "param_percola_arn_k", "param_percola_arn_thresh"},
+   &core::EDCHM_mini_output, "streamflow_mm"},
+  {"EDCHM_snow",
+   {"atmos_potentialEvatrans_mm", "atmos_precipitation_mm", "atmos_temperature_Cel"},
+   {"ground_capacity_mm", "ground_water_mm", "land_impermeableFrac_1", "snow_ice_mm", "soil_capacity_mm",
+    "soil_potentialPercola_mm", "soil_water_mm", "confluenLand_responseTime_TS", "confluenGround_responseTime_TS",
+    "param_atmos_thr_Ts", "param_baseflow_grf_gamma", "param_confluenLand_kel_k", "param_evatrans_ubc_gamma",
+    "param_infilt_ubc_P0AGEN", "param_percola_arn_k", "param_percola_arn_thresh", "param_snow_fac_f",
+    "param_snow_fac_Tmelt"},
+   &core::EDCHM_snow_output, "streamflow_mm"},
+  {"EDCHM_GR4J",
+   {"atmos_potentialEvatrans_mm", "atmos_precipitation_mm"},
+   {"S_", "R_", "X_1", "X_2", "X_3", "X_4"},
+   &core::EDCHM_GR4J_output, "Q"}
+};
+
+static std::vector<double> read_bin(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) throw std::runtime_error("can not open `" + path + "`.");
+  std::streamsize n_byte = in.tellg();
+  if (n_byte % sizeof(double) != 0) throw std::runtime_error("`" + path + "` is not a float64 file.");
+  std::vector<double> x(n_byte / sizeof(double));
+  in.seekg(0);
+  in.read(reinterpret_cast<char*>(x.data()), n_byte);
+  if (!in) throw std::runtime_error("can not read `" + path + "`.");
+  return x;
+}
+
+static void write_bin(const std::string& path, const std::vector<double>& x)
+{
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(x.data()), x.size() * sizeof(double));
+  if (!out) throw std::runtime_error("can not write `" + path + "`.");
+}
+
+static int to_int(const char* arg, const char* what)
+{
+  char* end = nullptr;
+  long x = std::strtol(arg, &end, 10);
+  if (end == arg || *end != '\0') throw std::runtime_error(std::string("`") + what + "` must be an integer.");
+  return (int)x;
+}
+
+static void usage()
+{
+  std::fprintf(stderr,
+    "usage: EDCHM_run MODELL N_TIME N_SPAT DIR_IN DIR_OUT [--thread N] [--out NAME ...]\n"
+    "  MODELL is EDCHM_mini, EDCHM_snow or EDCHM_GR4J, the inputs are DIR_IN/<argument>.bin (float64)\n");
+}
+
+static int run(int argc, char** argv)
+{
+  if (argc < 6) {
+    usage();
+    return 2;
+  }
+  std::string name_modell = argv[1];
+  const modell_info* info = nullptr;
+  for (const modell_info& m : modell_list) if (name_modell == m.name) info = &m;
+  if (!info) throw std::runtime_error("`" + name_modell + "` is not a model.");
+  int n_time = to_int(argv[2], "N_TIME"), n_spat = to_int(argv[3], "N_SPAT");
+  std::string dir_in = argv[4], dir_out = argv[5];
+
+  int n_thread = 1;
+  std::vector<std::string> out_variable;
+  for (int a = 6; a < argc; a++) {
+    std::string arg = argv[a];
+    if (arg == "--thread" && a + 1 < argc) {
+      n_thread = to_int(argv[++a], "--thread");
+    } else if (arg == "--out") {
+      while (a + 1 < argc && std::string(argv[a + 1]).rfind("--", 0) != 0) out_variable.push_back(argv[++a]);
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (out_variable.empty()) out_variable.push_back(info->output_default);
+
+  // inputs, a parameter with one value is used for all spatial units
+  std::vector<std::vector<double>> input;
+  for (const std::string& f : info->forcing) input.push_back(read_bin(dir_in + "/" + f + ".bin"));
+  for (const std::string& p : info->param) {
+    std::vector<double> x = read_bin(dir_in + "/" + p + ".bin");
+    if (x.size() == 1) x.assign(n_spat, x[0]);
+    input.push_back(x);
+  }
+
+  // outputs, only the asked variables are allocated
+  const std::vector<std::string>& vari_name = *info->output;
+  std::vector<std::vector<double>> output(vari_name.size());
+  std::vector<double*> out(vari_name.size(), nullptr);
+  for (const std::string& v : out_variable) {
+    size_t k = 0;
+    while (k < vari_name.size() && vari_name[k] != v) k++;
+    if (k == vari_name.size()) throw std::runtime_error("`" + v + "` is not an output of " + name_modell + ".");
+    output[k].assign((size_t)n_time * n_spat, 0.0);
+    out[k] = output[k].data();
+  }
+
+  std::vector<view<const double>> x(input.begin(), input.end());
+  if (name_modell == "EDCHM_mini") {
+    core::EDCHM_mini(n_time, n_spat, x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8], x[9],
+                     x[10], x[11], x[12], x[13], x[14], x[15], n_thread, out);
+  } else if (name_modell == "EDCHM_snow") {
+    core::EDCHM_snow(n_time, n_spat, x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8], x[9],
+                     x[10], x[11], x[12], x[13], x[14], x[15], x[16], x[17], x[18], x[19], x[20], n_thread, out);
+  } else {
+    core::EDCHM_GR4J(n_time, n_spat, x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], n_thread, out);
+  }
+
+  for (size_t k = 0; k < vari_name.size(); k++) {
+    if (out[k]) write_bin(dir_out + "/" + vari_name[k] + ".bin", output[k]);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  try {
+    return run(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "EDCHM_run: %s\n", e.what());
+    return 1;
+  }
+}
@@ -24,17 +24,80 @@ namespace EDCHM {
         }
     }
 
-    inline NumericMatrix EDCHM_GR4J(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4) {
-        typedef SEXP(*Ptr_EDCHM_GR4J)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+    inline std::string EDCHM_mathMode(std::string mode = "") {
+        typedef SEXP(*Ptr_EDCHM_mathMode)(SEXP);
+        static Ptr_EDCHM_mathMode p_EDCHM_mathMode = NULL;
+        if (p_EDCHM_mathMode == NULL) {
+            validateSignature("std::string(*EDCHM_mathMode)(std::string)");
+            p_EDCHM_mathMode = (Ptr_EDCHM_mathMode)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_mathMode");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_EDCHM_mathMode(Shield<SEXP>(Rcpp::wrap(mode)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<std::string >(rcpp_result_gen);
+    }
+
+    inline RObject EDCHM_GR4J(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4, int n_thread = 1, CharacterVector out_variable = CharacterVector::create("Q"), bool fast_pow = true) {
+        typedef SEXP(*Ptr_EDCHM_GR4J)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
         static Ptr_EDCHM_GR4J p_EDCHM_GR4J = NULL;
         if (p_EDCHM_GR4J == NULL) {
-            validateSignature("NumericMatrix(*EDCHM_GR4J)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
+            validateSignature("RObject(*EDCHM_GR4J)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector,bool)");
             p_EDCHM_GR4J = (Ptr_EDCHM_GR4J)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_GR4J");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_GR4J(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(S_)), Shield<SEXP>(Rcpp::wrap(R_)), Shield<SEXP>(Rcpp::wrap(X_1)), Shield<SEXP>(Rcpp::wrap(X_2)), Shield<SEXP>(Rcpp::wrap(X_3)), Shield<SEXP>(Rcpp::wrap(X_4)));
+            rcpp_result_gen = p_EDCHM_GR4J(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(S_)), Shield<SEXP>(Rcpp::wrap(R_)), Shield<SEXP>(Rcpp::wrap(X_1)), Shield<SEXP>(Rcpp::wrap(X_2)), Shield<SEXP>(Rcpp::wrap(X_3)), Shield<SEXP>(Rcpp::wrap(X_4)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(out_variable)), Shield<SEXP>(Rcpp::wrap(fast_pow)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<RObject >(rcpp_result_gen);
+    }
+
+    inline RObject EDCHM_engine(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, int n_thread = 1, CharacterVector out_variable = CharacterVector::create("streamflow_mm"), bool single = false) {
+        typedef SEXP(*Ptr_EDCHM_engine)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_engine p_EDCHM_engine = NULL;
+        if (p_EDCHM_engine == NULL) {
+            validateSignature("RObject(*EDCHM_engine)(CharacterVector,int,int,List,List,int,CharacterVector,bool)");
+            p_EDCHM_engine = (Ptr_EDCHM_engine)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_engine");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_EDCHM_engine(Shield<SEXP>(Rcpp::wrap(process_method)), Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(boundary)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(out_variable)), Shield<SEXP>(Rcpp::wrap(single)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<RObject >(rcpp_result_gen);
+    }
+
+    inline double EDCHM_engine_SSE(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, double SSE_bound = -1, NumericVector weight = NumericVector::create(), int n_thread = 1, bool single = false) {
+        typedef SEXP(*Ptr_EDCHM_engine_SSE)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_engine_SSE p_EDCHM_engine_SSE = NULL;
+        if (p_EDCHM_engine_SSE == NULL) {
+            validateSignature("double(*EDCHM_engine_SSE)(CharacterVector,int,int,List,List,NumericVector,double,NumericVector,int,bool)");
+            p_EDCHM_engine_SSE = (Ptr_EDCHM_engine_SSE)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_engine_SSE");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_EDCHM_engine_SSE(Shield<SEXP>(Rcpp::wrap(process_method)), Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(boundary)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(SSE_bound)), Shield<SEXP>(Rcpp::wrap(weight)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(single)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -42,20 +105,41 @@ namespace EDCHM {
             throw Rcpp::LongjumpException(rcpp_result_gen);
         if (rcpp_result_gen.inherits("try-error"))
             throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
-        return Rcpp::as<NumericMatrix >(rcpp_result_gen);
+        return Rcpp::as<double >(rcpp_result_gen);
     }
 
-    inline List EDCHM_GR4J_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4) {
-        typedef SEXP(*Ptr_EDCHM_GR4J_full)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
-        static Ptr_EDCHM_GR4J_full p_EDCHM_GR4J_full = NULL;
-        if (p_EDCHM_GR4J_full == NULL) {
-            validateSignature("List(*EDCHM_GR4J_full)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-            p_EDCHM_GR4J_full = (Ptr_EDCHM_GR4J_full)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_full");
+    inline NumericVector EDCHM_engine_objective(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, CharacterVector out_objective = CharacterVector::create("NSE", "KGE"), NumericVector weight = NumericVector::create(), int n_thread = 1, bool single = false) {
+        typedef SEXP(*Ptr_EDCHM_engine_objective)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_engine_objective p_EDCHM_engine_objective = NULL;
+        if (p_EDCHM_engine_objective == NULL) {
+            validateSignature("NumericVector(*EDCHM_engine_objective)(CharacterVector,int,int,List,List,NumericVector,CharacterVector,NumericVector,int,bool)");
+            p_EDCHM_engine_objective = (Ptr_EDCHM_engine_objective)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_engine_objective");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_GR4J_full(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(S_)), Shield<SEXP>(Rcpp::wrap(R_)), Shield<SEXP>(Rcpp::wrap(X_1)), Shield<SEXP>(Rcpp::wrap(X_2)), Shield<SEXP>(Rcpp::wrap(X_3)), Shield<SEXP>(Rcpp::wrap(X_4)));
+            rcpp_result_gen = p_EDCHM_engine_objective(Shield<SEXP>(Rcpp::wrap(process_method)), Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(boundary)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(out_objective)), Shield<SEXP>(Rcpp::wrap(weight)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(single)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<NumericVector >(rcpp_result_gen);
+    }
+
+    inline List cali_DDS_engine(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, NumericVector x_Min, NumericVector x_Max, NumericVector x_Init = NumericVector::create(), std::string objective = "NSE", NumericVector weight = NumericVector::create(), int max_iter = 100, double r = 0.2, int seed = -1, int n_chain = 1, bool async = false, int n_thread = 1, double cache_MB = 256, bool single = false) {
+        typedef SEXP(*Ptr_cali_DDS_engine)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_cali_DDS_engine p_cali_DDS_engine = NULL;
+        if (p_cali_DDS_engine == NULL) {
+            validateSignature("List(*cali_DDS_engine)(CharacterVector,int,int,List,List,NumericVector,NumericVector,NumericVector,NumericVector,std::string,NumericVector,int,double,int,int,bool,int,double,bool)");
+            p_cali_DDS_engine = (Ptr_cali_DDS_engine)R_GetCCallable("EDCHM", "_EDCHM_cali_DDS_engine");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_cali_DDS_engine(Shield<SEXP>(Rcpp::wrap(process_method)), Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(boundary)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(x_Min)), Shield<SEXP>(Rcpp::wrap(x_Max)), Shield<SEXP>(Rcpp::wrap(x_Init)), Shield<SEXP>(Rcpp::wrap(objective)), Shield<SEXP>(Rcpp::wrap(weight)), Shield<SEXP>(Rcpp::wrap(max_iter)), Shield<SEXP>(Rcpp::wrap(r)), Shield<SEXP>(Rcpp::wrap(seed)), Shield<SEXP>(Rcpp::wrap(n_chain)), Shield<SEXP>(Rcpp::wrap(async)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(cache_MB)), Shield<SEXP>(Rcpp::wrap(single)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -66,17 +150,59 @@ namespace EDCHM {
         return Rcpp::as<List >(rcpp_result_gen);
     }
 
-    inline NumericMatrix EDCHM_mini(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh) {
-        typedef SEXP(*Ptr_EDCHM_mini)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+    inline RObject EDCHM_GR4J_ensemble(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, NumericVector observe = NumericVector::create(), CharacterVector out_objective = CharacterVector::create(), int n_thread = 1) {
+        typedef SEXP(*Ptr_EDCHM_GR4J_ensemble)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_GR4J_ensemble p_EDCHM_GR4J_ensemble = NULL;
+        if (p_EDCHM_GR4J_ensemble == NULL) {
+            validateSignature("RObject(*EDCHM_GR4J_ensemble)(int,NumericVector,NumericVector,List,NumericVector,CharacterVector,int)");
+            p_EDCHM_GR4J_ensemble = (Ptr_EDCHM_GR4J_ensemble)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_ensemble");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_EDCHM_GR4J_ensemble(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(out_objective)), Shield<SEXP>(Rcpp::wrap(n_thread)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<RObject >(rcpp_result_gen);
+    }
+
+    inline RObject EDCHM_mini_ensemble(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, NumericVector observe = NumericVector::create(), CharacterVector out_objective = CharacterVector::create(), int n_thread = 1) {
+        typedef SEXP(*Ptr_EDCHM_mini_ensemble)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_mini_ensemble p_EDCHM_mini_ensemble = NULL;
+        if (p_EDCHM_mini_ensemble == NULL) {
+            validateSignature("RObject(*EDCHM_mini_ensemble)(int,NumericVector,NumericVector,List,NumericVector,CharacterVector,int)");
+            p_EDCHM_mini_ensemble = (Ptr_EDCHM_mini_ensemble)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_mini_ensemble");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_EDCHM_mini_ensemble(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(out_objective)), Shield<SEXP>(Rcpp::wrap(n_thread)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<RObject >(rcpp_result_gen);
+    }
+
+    inline RObject EDCHM_mini(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, int n_thread = 1, CharacterVector out_variable = CharacterVector::create("streamflow_mm")) {
+        typedef SEXP(*Ptr_EDCHM_mini)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
         static Ptr_EDCHM_mini p_EDCHM_mini = NULL;
         if (p_EDCHM_mini == NULL) {
-            validateSignature("NumericMatrix(*EDCHM_mini)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
+            validateSignature("RObject(*EDCHM_mini)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector)");
             p_EDCHM_mini = (Ptr_EDCHM_mini)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_mini");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_mini(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)));
+            rcpp_result_gen = p_EDCHM_mini(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(out_variable)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -84,20 +210,20 @@ namespace EDCHM {
             throw Rcpp::LongjumpException(rcpp_result_gen);
         if (rcpp_result_gen.inherits("try-error"))
             throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
-        return Rcpp::as<NumericMatrix >(rcpp_result_gen);
+        return Rcpp::as<RObject >(rcpp_result_gen);
     }
 
-    inline List EDCHM_mini_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh) {
-        typedef SEXP(*Ptr_EDCHM_mini_full)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
-        static Ptr_EDCHM_mini_full p_EDCHM_mini_full = NULL;
-        if (p_EDCHM_mini_full == NULL) {
-            validateSignature("List(*EDCHM_mini_full)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-            p_EDCHM_mini_full = (Ptr_EDCHM_mini_full)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_mini_full");
+    inline List EDCHM_GR4J_sensitivity(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, CharacterVector sensitivity_param = CharacterVector::create(), NumericVector observe = NumericVector::create(), std::string objective = "NSE") {
+        typedef SEXP(*Ptr_EDCHM_GR4J_sensitivity)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_GR4J_sensitivity p_EDCHM_GR4J_sensitivity = NULL;
+        if (p_EDCHM_GR4J_sensitivity == NULL) {
+            validateSignature("List(*EDCHM_GR4J_sensitivity)(int,NumericVector,NumericVector,List,CharacterVector,NumericVector,std::string)");
+            p_EDCHM_GR4J_sensitivity = (Ptr_EDCHM_GR4J_sensitivity)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_sensitivity");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_mini_full(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)));
+            rcpp_result_gen = p_EDCHM_GR4J_sensitivity(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(sensitivity_param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(objective)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -108,17 +234,17 @@ namespace EDCHM {
         return Rcpp::as<List >(rcpp_result_gen);
     }
 
-    inline NumericMatrix EDCHM_snow(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt) {
-        typedef SEXP(*Ptr_EDCHM_snow)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
-        static Ptr_EDCHM_snow p_EDCHM_snow = NULL;
-        if (p_EDCHM_snow == NULL) {
-            validateSignature("NumericMatrix(*EDCHM_snow)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-            p_EDCHM_snow = (Ptr_EDCHM_snow)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_snow");
+    inline List EDCHM_mini_sensitivity(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, CharacterVector sensitivity_param = CharacterVector::create(), NumericVector observe = NumericVector::create(), std::string objective = "NSE") {
+        typedef SEXP(*Ptr_EDCHM_mini_sensitivity)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_mini_sensitivity p_EDCHM_mini_sensitivity = NULL;
+        if (p_EDCHM_mini_sensitivity == NULL) {
+            validateSignature("List(*EDCHM_mini_sensitivity)(int,NumericVector,NumericVector,List,CharacterVector,NumericVector,std::string)");
+            p_EDCHM_mini_sensitivity = (Ptr_EDCHM_mini_sensitivity)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_mini_sensitivity");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_snow(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(atmos_temperature_Cel)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(snow_ice_mm)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_atmos_thr_Ts)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_f)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_Tmelt)));
+            rcpp_result_gen = p_EDCHM_mini_sensitivity(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(param)), Shield<SEXP>(Rcpp::wrap(sensitivity_param)), Shield<SEXP>(Rcpp::wrap(observe)), Shield<SEXP>(Rcpp::wrap(objective)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -126,20 +252,20 @@ namespace EDCHM {
             throw Rcpp::LongjumpException(rcpp_result_gen);
         if (rcpp_result_gen.inherits("try-error"))
             throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
-        return Rcpp::as<NumericMatrix >(rcpp_result_gen);
+        return Rcpp::as<List >(rcpp_result_gen);
     }
 
-    inline List EDCHM_snow_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt) {
-        typedef SEXP(*Ptr_EDCHM_snow_full)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
-        static Ptr_EDCHM_snow_full p_EDCHM_snow_full = NULL;
-        if (p_EDCHM_snow_full == NULL) {
-            validateSignature("List(*EDCHM_snow_full)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-            p_EDCHM_snow_full = (Ptr_EDCHM_snow_full)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_snow_full");
+    inline RObject EDCHM_snow(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt, int n_thread = 1, CharacterVector out_variable = CharacterVector::create("streamflow_mm")) {
+        typedef SEXP(*Ptr_EDCHM_snow)(SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP,SEXP);
+        static Ptr_EDCHM_snow p_EDCHM_snow = NULL;
+        if (p_EDCHM_snow == NULL) {
+            validateSignature("RObject(*EDCHM_snow)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector)");
+            p_EDCHM_snow = (Ptr_EDCHM_snow)R_GetCCallable("EDCHM", "_EDCHM_EDCHM_snow");
         }
         RObject rcpp_result_gen;
         {
             RNGScope RCPP_rngScope_gen;
-            rcpp_result_gen = p_EDCHM_snow_full(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(atmos_temperature_Cel)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(snow_ice_mm)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_atmos_thr_Ts)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_f)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_Tmelt)));
+            rcpp_result_gen = p_EDCHM_snow(Shield<SEXP>(Rcpp::wrap(n_time)), Shield<SEXP>(Rcpp::wrap(n_spat)), Shield<SEXP>(Rcpp::wrap(atmos_potentialEvatrans_mm)), Shield<SEXP>(Rcpp::wrap(atmos_precipitation_mm)), Shield<SEXP>(Rcpp::wrap(atmos_temperature_Cel)), Shield<SEXP>(Rcpp::wrap(ground_capacity_mm)), Shield<SEXP>(Rcpp::wrap(ground_water_mm)), Shield<SEXP>(Rcpp::wrap(land_impermeableFrac_1)), Shield<SEXP>(Rcpp::wrap(snow_ice_mm)), Shield<SEXP>(Rcpp::wrap(soil_capacity_mm)), Shield<SEXP>(Rcpp::wrap(soil_potentialPercola_mm)), Shield<SEXP>(Rcpp::wrap(soil_water_mm)), Shield<SEXP>(Rcpp::wrap(confluenLand_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(confluenGround_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_atmos_thr_Ts)), Shield<SEXP>(Rcpp::wrap(param_baseflow_grf_gamma)), Shield<SEXP>(Rcpp::wrap(param_confluenLand_kel_k)), Shield<SEXP>(Rcpp::wrap(param_evatrans_ubc_gamma)), Shield<SEXP>(Rcpp::wrap(param_infilt_ubc_P0AGEN)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_k)), Shield<SEXP>(Rcpp::wrap(param_percola_arn_thresh)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_f)), Shield<SEXP>(Rcpp::wrap(param_snow_fac_Tmelt)), Shield<SEXP>(Rcpp::wrap(n_thread)), Shield<SEXP>(Rcpp::wrap(out_variable)));
         }
         if (rcpp_result_gen.inherits("interrupted-error"))
             throw Rcpp::internal::InterruptedException();
@@ -147,7 +273,7 @@ namespace EDCHM {
             throw Rcpp::LongjumpException(rcpp_result_gen);
         if (rcpp_result_gen.inherits("try-error"))
             throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
-        return Rcpp::as<List >(rcpp_result_gen);
+        return Rcpp::as<RObject >(rcpp_result_gen);
     }
 
     inline NumericVector atmosSnow_ThresholdT(NumericVector atmos_precipitation_mm, NumericVector atmos_temperature_Cel, NumericVector param_atmos_thr_Ts) {
@@ -486,6 +612,48 @@ namespace EDCHM {
         return Rcpp::as<NumericVector >(rcpp_result_gen);
     }
 
+    inline NumericVector confluen_IIR_Clark(NumericVector confluen_inputWater_mm, double confluen_responseTime_TS) {
+        typedef SEXP(*Ptr_confluen_IIR_Clark)(SEXP,SEXP);
+        static Ptr_confluen_IIR_Clark p_confluen_IIR_Clark = NULL;
+        if (p_confluen_IIR_Clark == NULL) {
+            validateSignature("NumericVector(*confluen_IIR_Clark)(NumericVector,double)");
+            p_confluen_IIR_Clark = (Ptr_confluen_IIR_Clark)R_GetCCallable("EDCHM", "_EDCHM_confluen_IIR_Clark");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_confluen_IIR_Clark(Shield<SEXP>(Rcpp::wrap(confluen_inputWater_mm)), Shield<SEXP>(Rcpp::wrap(confluen_responseTime_TS)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<NumericVector >(rcpp_result_gen);
+    }
+
+    inline NumericVector confluen_IIR_Nash(NumericVector confluen_inputWater_mm, double confluen_responseTime_TS, double param_confluen_nas_n) {
+        typedef SEXP(*Ptr_confluen_IIR_Nash)(SEXP,SEXP,SEXP);
+        static Ptr_confluen_IIR_Nash p_confluen_IIR_Nash = NULL;
+        if (p_confluen_IIR_Nash == NULL) {
+            validateSignature("NumericVector(*confluen_IIR_Nash)(NumericVector,double,double)");
+            p_confluen_IIR_Nash = (Ptr_confluen_IIR_Nash)R_GetCCallable("EDCHM", "_EDCHM_confluen_IIR_Nash");
+        }
+        RObject rcpp_result_gen;
+        {
+            RNGScope RCPP_rngScope_gen;
+            rcpp_result_gen = p_confluen_IIR_Nash(Shield<SEXP>(Rcpp::wrap(confluen_inputWater_mm)), Shield<SEXP>(Rcpp::wrap(confluen_responseTime_TS)), Shield<SEXP>(Rcpp::wrap(param_confluen_nas_n)));
+        }
+        if (rcpp_result_gen.inherits("interrupted-error"))
+            throw Rcpp::internal::InterruptedException();
+        if (Rcpp::internal::isLongjumpSentinel(rcpp_result_gen))
+            throw Rcpp::LongjumpException(rcpp_result_gen);
+        if (rcpp_result_gen.inherits("try-error"))
+            throw Rcpp::exception(Rcpp::as<std::string>(rcpp_result_gen).c_str());
+        return Rcpp::as<NumericVector >(rcpp_result_gen);
+    }
+
     inline NumericVector confluenIUH_GR4J1(double confluen_responseTime_TS) {
         typedef SEXP(*Ptr_confluenIUH_GR4J1)(SEXP);
         static Ptr_confluenIUH_GR4J1 p_confluenIUH_GR4J1 = NULL;
@@ -0,0 +1,412 @@
+// Defines a header file for the calibration in C++
+//
+// `cali::DDS()` is the dynamically dimensioned search of `cali_DDS()`
+// (Tolson and Shoemaker 2007) on a C++ fitness, so a calibration of the engine
+// (EDCHM_engine.h) runs without a call to R per iteration:
+// `cali::engine_fitness` sets the calibrated parameters, runs the engine to
+// the outlet and accumulates the objective against the observation
+// (EDCHM_objective.h), no series of the spatial units is kept.
+// As in `cali_DDS()` the fitness is minimised, for an objective with the
+// optimum 1 (NSE, KGE) the fitness is `1 - objective`.
+// `cali::DDS_multi()` (independent chains) and `cali::DDS_async()` (workers on
+// one shared best) run the fitness of every chain or worker in parallel, so
+// every chain or worker has its own fitness object and its own random stream.
+// The random numbers come from `std::mt19937_64`, which gives the same stream
+// on every platform, so a seed repeats a calibration.
+// The header is free of Rcpp.
+#ifndef EDCHM_CALI_H
+#define EDCHM_CALI_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EDCHM_engine.h"
+#include "EDCHM_objective.h"
+
+namespace EDCHM {
+namespace cali {
+
+// the random numbers of one search
+class random_stream {
+public:
+  explicit random_stream(std::uint64_t seed) : engine_(seed) {}
+
+  // uniform in [0, 1), from the upper 53 bits
+  double uniform() { return (engine_() >> 11) * 0x1.0p-53; }
+
+  // standard normal (Box-Muller)
+  double normal()
+  {
+    double u_1 = 1.0 - uniform(), u_2 = uniform();
+    return std::sqrt(-2.0 * std::log(u_1)) * std::cos(6.283185307179586 * u_2);
+  }
+
+  int integer(int n) { return (int)(uniform() * n); }
+
+private:
+  std::mt19937_64 engine_;
+};
+
+struct DDS_result {
+  std::vector<double> x_best;
+  double y_best;
+  // fitness of the candidate and of the best of every iteration (the first is the initial)
+  std::vector<double> y_new, y_trace;
+};
+
+// one perturbed parameter, reflected at the bounds and set to the bound
+// when the reflection leaves the range
+inline double DDS_perturb(double x_best, double x_min, double x_max, double r, random_stream& random)
+{
+  double x_ = x_best + r * (x_max - x_min) * random.normal();
+  if (x_ < x_min) {
+    x_ = 2 * x_min - x_;
+    if (x_ > x_max) x_ = x_min;
+  } else if (x_ > x_max) {
+    x_ = 2 * x_max - x_;
+    if (x_ < x_min) x_ = x_max;
+  }
+  return x_;
+}
+
+// the candidate of iteration i from `x_best`: every parameter is perturbed with the
+// probability 1 - log(i) / log(max_iter) (at least one) by N(0, 1) * r * (x_max - x_min)
+inline void DDS_candidate(
+    const std::vector<double>& x_best,
+    const std::vector<double>& x_min,
+    const std::vector<double>& x_max,
+    int i,
+    int max_iter,
+    double r,
+    random_stream& random,
+    std::vector<double>& x_new
+)
+{
+  int n_x = x_best.size();
+  double P_i = 1 - std::log((double)i) / std::log((double)max_iter);
+  x_new = x_best;
+  int n_perturb = 0;
+  for (int d = 0; d < n_x; d++) {
+    if (random.uniform() >= P_i) continue;
+    n_perturb++;
+    x_new[d] = DDS_perturb(x_best[d], x_min[d], x_max[d], r, random);
+  }
+  if (n_perturb == 0) {
+    int d = random.integer(n_x);
+    x_new[d] = DDS_perturb(x_best[d], x_min[d], x_max[d], r, random);
+  }
+}
+
+inline bool DDS_better(double y_new, double y_best)
+{
+  return y_new < y_best || (std::isnan(y_best) && !std::isnan(y_new));
+}
+
+inline void DDS_check(const std::vector<double>& x_min, const std::vector<double>& x_max, const std::vector<double>& x_init, int max_iter)
+{
+  if (x_max.size() != x_min.size() || x_init.size() != x_min.size()) throw std::invalid_argument("`x_Min`, `x_Max` and `x_Init` must have the same length.");
+  if (max_iter < 1) throw std::invalid_argument("`max_iter` must be at least 1.");
+}
+
+// the seed of stream k of a search: stream 0 is `seed` itself, so one chain or
+// one worker repeats `DDS()`, the others are mixed with splitmix64
+inline std::uint64_t random_seed(std::uint64_t seed, int k)
+{
+  if (k == 0) return seed;
+  std::uint64_t z = seed + (std::uint64_t)k * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// DDS: iteration 1 is `x_init`, iteration i > 1 evaluates the candidate from the best so far.
+// The fitness is called as `fitness(x)` for `x_init` and as `fitness(x, y_best)`
+// for a candidate, it may stop early when the candidate can not beat `y_best`.
+// `monitor(i)` is called after every iteration.
+template <class Fitness, class Monitor>
+DDS_result DDS(
+    Fitness&& fitness,
+    const std::vector<double>& x_min,
+    const std::vector<double>& x_max,
+    const std::vector<double>& x_init,
+    int max_iter,
+    double r,
+    random_stream& random,
+    Monitor&& monitor
+)
+{
+  DDS_check(x_min, x_max, x_init, max_iter);
+
+  DDS_result result_;
+  result_.x_best = x_init;
+  result_.y_best = fitness(x_init);
+  result_.y_new.push_back(result_.y_best);
+  result_.y_trace.push_back(result_.y_best);
+
+  std::vector<double> x_new;
+  for (int i = 2; i <= max_iter; i++) {
+    DDS_candidate(result_.x_best, x_min, x_max, i, max_iter, r, random, x_new);
+    double y_new = fitness(x_new, result_.y_best);
+    if (DDS_better(y_new, result_.y_best)) {
+      result_.x_best = x_new;
+      result_.y_best = y_new;
+    }
+    result_.y_new.push_back(y_new);
+    result_.y_trace.push_back(result_.y_best);
+    monitor(i);
+  }
+  return result_;
+}
+
+// Multi-start DDS: `n_chain` independent chains of `max_iter` iterations run in
+// parallel, chain c uses `fitness[c]` and the stream `random_seed(seed, c)`,
+// chain 0 starts at `x_init`, the others at a uniform random point. Every chain
+// is the same for every number of threads.
+template <class Fitness>
+std::vector<DDS_result> DDS_multi(
+    std::vector<Fitness>& fitness,
+    const std::vector<double>& x_min,
+    const std::vector<double>& x_max,
+    const std::vector<double>& x_init,
+    int max_iter,
+    double r,
+    std::uint64_t seed,
+    int n_thread
+)
+{
+  DDS_check(x_min, x_max, x_init, max_iter);
+  int n_chain = fitness.size();
+  std::vector<DDS_result> result_(n_chain);
+  std::exception_ptr error_;
+  std::mutex error_mutex;
+
+#pragma omp parallel for num_threads(n_thread) schedule(dynamic)
+  for (int c = 0; c < n_chain; c++) {
+    try {
+      random_stream random_(random_seed(seed, c));
+      std::vector<double> x_init_c = x_init;
+      if (c > 0) {
+        for (std::size_t d = 0; d < x_init_c.size(); d++) x_init_c[d] = x_min[d] + random_.uniform() * (x_max[d] - x_min[d]);
+      }
+      result_[c] = DDS(fitness[c], x_min, x_max, x_init_c, max_iter, r, random_, [](int) {});
+    } catch (...) {
+      std::lock_guard<std::mutex> lock_(error_mutex);
+      if (!error_) error_ = std::current_exception();
+    }
+  }
+  if (error_) std::rethrow_exception(error_);
+  return result_;
+}
+
+// Asynchronous parallel DDS: one chain of `max_iter` iterations, every worker w
+// (`fitness[w]`, stream `random_seed(seed, w)`) takes the next iteration, builds
+// its candidate from the shared best, evaluates it without a lock and updates
+// the best when it is better, so no worker waits for the others.
+// `y_trace[i]` is the best when iteration i is done. The candidates of every
+// worker come from its own stream, but which best they see depends on the order
+// the evaluations end, so only one worker repeats `DDS()` exactly.
+template <class Fitness>
+DDS_result DDS_async(
+    std::vector<Fitness>& fitness,
+    const std::vector<double>& x_min,
+    const std::vector<double>& x_max,
+    const std::vector<double>& x_init,
+    int max_iter,
+    double r,
+    std::uint64_t seed
+)
+{
+  DDS_check(x_min, x_max, x_init, max_iter);
+  int n_worker = fitness.size();
+  DDS_result result_;
+  result_.x_best = x_init;
+  result_.y_best = fitness[0](x_init);
+  result_.y_new.assign(max_iter, result_.y_best);
+  result_.y_trace.assign(max_iter, result_.y_best);
+  int i_next = 2;
+  std::mutex mutex_;
+  std::exception_ptr error_;
+
+#pragma omp parallel for num_threads(n_worker) schedule(static, 1)
+  for (int w = 0; w < n_worker; w++) {
+    random_stream random_(random_seed(seed, w));
+    std::vector<double> x_best, x_new;
+    for (;;) {
+      int i;
+      double y_best;
+      {
+        std::lock_guard<std::mutex> lock_(mutex_);
+        if (i_next > max_iter || error_) break;
+        i = i_next++;
+        x_best = result_.x_best;
+        y_best = result_.y_best;
+      }
+      DDS_candidate(x_best, x_min, x_max, i, max_iter, r, random_, x_new);
+      double y_new;
+      try {
+        y_new = fitness[w](x_new, y_best);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock_(mutex_);
+        if (!error_) error_ = std::current_exception();
+        break;
+      }
+      std::lock_guard<std::mutex> lock_(mutex_);
+      if (DDS_better(y_new, result_.y_best)) {
+        result_.x_best = x_new;
+        result_.y_best = y_new;
+      }
+      result_.y_new[i - 1] = y_new;
+      result_.y_trace[i - 1] = result_.y_best;
+    }
+  }
+  if (error_) std::rethrow_exception(error_);
+  return result_;
+}
+
+// the fitness of one parameter set of an engine model: the calibrated
+// parameters get one value for all spatial units, the other parameters keep
+// their values, the outlet is compared with `observe`; the stage groups of the
+// model that a candidate does not change are replayed from the engine cache of
+// the fitness (every copy has its own, with `cache_byte` as budget)
+class engine_fitness {
+public:
+  engine_fitness(
+      const core::engine& modell,
+      int n_time,
+      int n_spat,
+      const std::vector<view<const double>>& boundary,
+      const std::vector<view<const double>>& param,
+      const std::vector<std::string>& cali_name,
+      view<const double> weight,
+      view<const double> observe,
+      const std::string& objective_name,
+      int n_thread,
+      std::size_t cache_byte = core::engine_cacheByte
+  )
+    : modell_(modell), n_time_(n_time), n_spat_(n_spat), boundary_(boundary), param_(param),
+      weight_(weight), observe_(observe), n_thread_(n_thread), outlet_(n_time > 0 ? n_time : 0),
+      out_(core::engine_output.size(), nullptr), cache_(cache_byte)
+  {
+    const std::vector<std::string>& param_name = modell.param_name();
+    for (const std::string& name_ : cali_name) {
+      std::size_t k = std::find(param_name.begin(), param_name.end(), name_) - param_name.begin();
+      if (k == param_name.size()) throw std::invalid_argument("`" + name_ + "` is not a parameter of the model.");
+      cali_index_.push_back(k);
+    }
+    if (observe.size() < (std::size_t)n_time) throw std::invalid_argument("`observe` must have `n_time` values.");
+    objective_k_ = objective::gof_index(objective_name);
+    if (objective_k_ < 0) throw std::invalid_argument("`" + objective_name + "` is not an objective.");
+    cali_value_.resize(cali_index_.size());
+    if (objective_name == "logNSE") gof_0_ = objective::gof_sum(objective::gof_logEpsilon(observe.data(), n_time));
+    // n and M2 of the observation alone, bitwise the ones of the full `gof_sum`
+    objective::gof_sum gof_obs = gof_0_;
+    for (int i = 0; i < n_time; i++) gof_obs.add(0.0, observe[i]);
+    n_obs_ = gof_obs.n;
+    M2_obs_ = gof_obs.M2_obs;
+    M2_logObs_ = gof_obs.M2_logObs;
+  }
+
+  // index of the objective in `objective::gof_name`
+  int objective_index() const { return objective_k_; }
+
+  // the sums of the outlet of the parameter set `x` against the observation
+  objective::gof_sum gof(const std::vector<double>& x)
+  {
+    objective::gof_sum gof_ = gof_0_;
+    run(x, gof_, nullptr);
+    return gof_;
+  }
+
+  // the objective of the parameter set `x`
+  double objective(const std::vector<double>& x)
+  {
+    return objective::gof_value(gof(x), objective_k_);
+  }
+
+  // The fitness of `objective::gof_fitness()`. For the NSE, RMSE and log-NSE the
+  // fitness only grows while the model runs (the SSE over the fixed M2 or number
+  // of the observation), so the run stops as soon as it is above `y_bound` (the
+  // fitness of the best): the candidate is rejected all the same, the returned
+  // fitness is then the one of the steps that ran (still above `y_bound`).
+  double operator()(const std::vector<double>& x, double y_bound = std::numeric_limits<double>::infinity())
+  {
+    objective::gof_sum gof_ = gof_0_;
+    if (!fitness_bounded() || !(y_bound < std::numeric_limits<double>::infinity())) {
+      run(x, gof_, nullptr);
+      return objective::gof_fitness(objective::gof_value(gof_, objective_k_), objective_k_);
+    }
+    if (!run(x, gof_, [&]() { return !(fitness_partial(gof_) > y_bound); })) return fitness_partial(gof_);
+    return objective::gof_fitness(objective::gof_value(gof_, objective_k_), objective_k_);
+  }
+
+  // the sum of squared errors of the outlet, the run stops as soon as it is
+  // above `SSE_bound` (when it is not negative)
+  double SSE(const std::vector<double>& x, double SSE_bound)
+  {
+    objective::gof_sum gof_;
+    if (SSE_bound < 0) run(x, gof_, nullptr);
+    else run(x, gof_, [&]() { return !(gof_.SSE > SSE_bound); });
+    return gof_.SSE;
+  }
+
+private:
+  // runs `x` and adds the outlet to `gof_`, with `proceed` the run stops when it
+  // returns false; returns true when all steps ran
+  bool run(const std::vector<double>& x, objective::gof_sum& gof_, const std::function<bool()>& proceed)
+  {
+    for (std::size_t k = 0; k < cali_index_.size(); k++) {
+      cali_value_[k] = x[k];
+      param_[cali_index_[k]] = view<const double>(&cali_value_[k], 1);
+    }
+    int i_added = 0;
+    core::engine_check check_;
+    if (proceed) check_ = [&](int i_end) {
+      for (; i_added < i_end; i_added++) gof_.add(outlet_[i_added], observe_[i_added]);
+      return proceed();
+    };
+    int n_run = modell_.run(n_time_, n_spat_, boundary_, param_, n_thread_, out_, outlet_.data(), weight_, check_, &cache_);
+    for (; i_added < n_run; i_added++) gof_.add(outlet_[i_added], observe_[i_added]);
+    return n_run == n_time_;
+  }
+
+  bool fitness_bounded() const
+  {
+    const std::string& name_ = objective::gof_name[objective_k_];
+    return name_ == "NSE" || name_ == "RMSE" || name_ == "logNSE";
+  }
+
+  // the fitness of the steps in `gof_`, with the sums of the whole observation it
+  // is bitwise the final one after the last step
+  double fitness_partial(const objective::gof_sum& gof_) const
+  {
+    const std::string& name_ = objective::gof_name[objective_k_];
+    if (name_ == "RMSE") return std::sqrt(gof_.SSE / n_obs_);
+    if (name_ == "logNSE") return 1 - (1 - gof_.SSE_log / M2_logObs_);
+    return 1 - (1 - gof_.SSE / M2_obs_);
+  }
+
+  const core::engine& modell_;
+  int n_time_, n_spat_;
+  std::vector<view<const double>> boundary_, param_;
+  view<const double> weight_, observe_;
+  int n_thread_, objective_k_;
+  objective::gof_sum gof_0_;
+  double n_obs_, M2_obs_, M2_logObs_;
+  std::vector<std::size_t> cali_index_;
+  std::vector<double> cali_value_, outlet_;
+  std::vector<double*> out_;
+  core::engine_cache cache_;
+};
+
+} // namespace cali
+} // namespace EDCHM
+
+#endif // EDCHM_CALI_H
@@ -0,0 +1,281 @@
+// Defines a header file for the compile-time composition of models
+//
+// Every process method of the slots below is a stateless functor over its
+// scalar kernel (EDCHM_kernel.h), e.g. `compose::infilt_UBC`, that reads its
+// inputs from the `cell` and `param` of one spatial unit and returns the flux.
+// A process slot, e.g. `compose::infilt<Method>`, calls the method and applies
+// the flux to the storages, with the same updates as `build_modell()`. A model
+// is a type list of slots, `compose::modell<...>::step()` runs them in the
+// order of the list, so the compiler inlines the whole chain into one loop
+// body, and a method in the wrong slot or a slot used twice does not compile.
+// The cell, param and the steps are templated on the scalar like the kernels,
+// `cell` and `param` are the `double` ones the models run with.
+// The header is free of Rcpp.
+#ifndef EDCHM_COMPOSE_H
+#define EDCHM_COMPOSE_H
+
+#include <type_traits>
+#include "EDCHM_kernel.h"
+
+namespace EDCHM {
+namespace compose {
+
+// storages and fluxes of one spatial unit, named as in `all_vari`,
+// the forcing is set by the model driver at every step
+template <class T>
+struct basic_cell {
+  // forcing
+  T atmos_precipitation_mm = 0, atmos_potentialEvatrans_mm = 0, atmos_temperature_Cel = 0;
+  // storages
+  T snow_ice_mm = 0, soil_water_mm = 0, ground_water_mm = 0;
+  // fluxes of the current step
+  T atmos_snow_mm = 0, snow_melt_mm = 0, land_water_mm = 0,
+    soil_evatrans_mm = 0, soil_infilt_mm = 0, land_runoff_mm = 0, soil_percolation_mm = 0,
+    ground_baseflow_mm = 0, ground_lateral_mm = 0;
+};
+
+// constants and parameters of one spatial unit, named as in `all_vari` and `all_param`
+template <class T>
+struct basic_param {
+  T land_impermeableFrac_1 = 0, soil_capacity_mm = 0, soil_potentialPercola_mm = 0,
+    ground_capacity_mm = 0, ground_potentialLateral_mm = 0;
+  T param_atmos_thr_Ts = 0, param_snow_fac_f = 0, param_snow_fac_Tmelt = 0,
+    param_evatrans_ubc_gamma = 0, param_infilt_ubc_P0AGEN = 0,
+    param_percola_arn_thresh = 0, param_percola_arn_k = 0, param_baseflow_grf_gamma = 0;
+};
+
+typedef basic_cell<double> cell;
+typedef basic_param<double> param;
+
+// process tags, every method and every slot names the process it belongs to
+struct process_atmosSnow {};
+struct process_snowMelt {};
+struct process_evatransSoil {};
+struct process_infilt {};
+struct process_percola {};
+struct process_baseflow {};
+struct process_lateral {};
+
+// methods ----------
+
+struct atmosSnow_ThresholdT {
+  typedef process_atmosSnow process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::atmosSnow_ThresholdT(c.atmos_precipitation_mm, c.atmos_temperature_Cel, p.param_atmos_thr_Ts);
+  }
+};
+
+struct snowMelt_Factor {
+  typedef process_snowMelt process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::snowMelt_Factor(c.snow_ice_mm, c.atmos_temperature_Cel, p.param_snow_fac_f, p.param_snow_fac_Tmelt);
+  }
+};
+
+struct evatransActual_UBC {
+  typedef process_evatransSoil process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::evatransActual_UBC(c.atmos_potentialEvatrans_mm, c.soil_water_mm, p.soil_capacity_mm, p.param_evatrans_ubc_gamma);
+  }
+};
+
+struct evatransActual_GR4J {
+  typedef process_evatransSoil process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::evatransActual_GR4J(c.atmos_potentialEvatrans_mm, c.soil_water_mm, p.soil_capacity_mm);
+  }
+};
+
+struct infilt_UBC {
+  typedef process_infilt process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::infilt_UBC(c.land_water_mm, p.land_impermeableFrac_1, c.soil_water_mm, p.soil_capacity_mm, p.param_infilt_ubc_P0AGEN);
+  }
+};
+
+struct infilt_GR4J {
+  typedef process_infilt process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::infilt_GR4J(c.land_water_mm, c.soil_water_mm, p.soil_capacity_mm);
+  }
+};
+
+struct percola_Arno {
+  typedef process_percola process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::percola_Arno(c.soil_water_mm, p.soil_capacity_mm, p.soil_potentialPercola_mm, p.param_percola_arn_thresh, p.param_percola_arn_k);
+  }
+};
+
+struct percola_GR4J {
+  typedef process_percola process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::percola_GR4J(c.soil_water_mm, p.soil_capacity_mm);
+  }
+};
+
+struct baseflow_GR4J {
+  typedef process_baseflow process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::baseflow_GR4J(c.ground_water_mm, p.ground_capacity_mm);
+  }
+};
+
+struct baseflow_GR4Jfix {
+  typedef process_baseflow process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::baseflow_GR4Jfix(c.ground_water_mm, p.ground_capacity_mm, p.param_baseflow_grf_gamma);
+  }
+};
+
+struct lateral_GR4J {
+  typedef process_lateral process;
+  template <class T>
+  static T flux(const basic_cell<T>& c, const basic_param<T>& p)
+  {
+    return kernel::lateral_GR4J(c.ground_water_mm, p.ground_capacity_mm, p.ground_potentialLateral_mm);
+  }
+};
+
+// slots ----------
+
+template <class Method, class Process>
+struct slot_check {
+  static_assert(std::is_same<typename Method::process, Process>::value,
+                "the method does not belong to this process");
+  typedef Process process;
+};
+
+// the snow is taken out of the precipitation, the rest is on the land
+template <class Method>
+struct atmosSnow : slot_check<Method, process_atmosSnow> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.atmos_snow_mm = Method::flux(c, p);
+    c.atmos_precipitation_mm = c.atmos_precipitation_mm - c.atmos_snow_mm;
+    c.land_water_mm = c.atmos_precipitation_mm;
+  }
+};
+
+template <class Method>
+struct snowMelt : slot_check<Method, process_snowMelt> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.snow_melt_mm = Method::flux(c, p);
+    c.land_water_mm += c.snow_melt_mm;
+    c.snow_ice_mm += - c.snow_melt_mm;
+    c.snow_ice_mm += c.atmos_snow_mm;
+  }
+};
+
+template <class Method>
+struct evatransSoil : slot_check<Method, process_evatransSoil> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.soil_evatrans_mm = Method::flux(c, p);
+    c.soil_water_mm += - c.soil_evatrans_mm;
+  }
+};
+
+template <class Method>
+struct infilt : slot_check<Method, process_infilt> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.soil_infilt_mm = Method::flux(c, p);
+    c.soil_water_mm += c.soil_infilt_mm;
+    c.land_runoff_mm = c.land_water_mm - c.soil_infilt_mm;
+  }
+};
+
+template <class Method>
+struct percola : slot_check<Method, process_percola> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.soil_percolation_mm = Method::flux(c, p);
+    c.ground_water_mm += c.soil_percolation_mm;
+    c.soil_water_mm += - c.soil_percolation_mm;
+  }
+};
+
+// the water above the capacity leaves with the baseflow
+template <class Method>
+struct baseflow : slot_check<Method, process_baseflow> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    T baseflow_temp = c.ground_water_mm < p.ground_capacity_mm ? 0 : c.ground_water_mm - p.ground_capacity_mm;
+    c.ground_water_mm = c.ground_water_mm < p.ground_capacity_mm ? c.ground_water_mm : p.ground_capacity_mm;
+    c.ground_baseflow_mm = Method::flux(c, p);
+    c.ground_water_mm += - c.ground_baseflow_mm;
+    c.ground_baseflow_mm = c.ground_baseflow_mm + baseflow_temp;
+  }
+};
+
+template <class Method>
+struct lateral : slot_check<Method, process_lateral> {
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    c.ground_lateral_mm = Method::flux(c, p);
+    c.ground_water_mm += c.ground_lateral_mm;
+  }
+};
+
+// model ----------
+
+template <class Process, class... Slot>
+struct count_process {
+  static const int value = (0 + ... + (std::is_same<typename Slot::process, Process>::value ? 1 : 0));
+};
+
+// At the start of a step all the precipitation is on the land, then the slots
+// run in the order of the list. The runoff and baseflow of the step are left in
+// `land_runoff_mm` and `ground_baseflow_mm` for the confluen.
+template <class T>
+inline void modell_begin(basic_cell<T>& c)
+{
+  c.land_water_mm = c.atmos_precipitation_mm;
+}
+
+template <class... Slot>
+struct modell {
+  static_assert(((count_process<typename Slot::process, Slot...>::value == 1) && ...),
+                "every process can only be used once in a model");
+
+  template <class T>
+  static void step(basic_cell<T>& c, const basic_param<T>& p)
+  {
+    modell_begin(c);
+    (Slot::step(c, p), ...);
+  }
+};
+
+} // namespace compose
+} // namespace EDCHM
+
+#endif // EDCHM_COMPOSE_H
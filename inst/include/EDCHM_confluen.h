@@ -0,0 +1,583 @@
+// Defines a header file containing the confluence (routing) kernels
+//
+// The kernels work on raw `double` series of one spatial unit, so the models
+// can route a column of the runoff matrix in place, without copying it into
+// a NumericVector first. The IUH tables and their process-wide cache are here
+// too, so a model can be run without R (EDCHM_core.h).
+// The header is free of Rcpp.
+#ifndef EDCHM_CONFLUEN_H
+#define EDCHM_CONFLUEN_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace EDCHM {
+namespace kernel {
+
+using std::exp;
+using std::pow;
+using std::sqrt;
+
+// Convolution of one series with one IUH, the same sum as `confluen_IUH()`:
+// out[i] = sum_{j = 0}^{min(i, n_iuh - 1)} in[i - j] * iuh[j]
+inline double confluen_IUH_step(
+    int i,
+    const double* confluen_inputWater_mm,
+    int n_iuh,
+    const double* confluen_iuh_1
+)
+{
+  int n_j = i < n_iuh ? i + 1 : n_iuh;
+  double confluen_outputWater_mm = 0.0;
+  for (int j = 0; j < n_j; j++) {
+    confluen_outputWater_mm += confluen_inputWater_mm[i-j] * confluen_iuh_1[j];
+  }
+  return confluen_outputWater_mm;
+}
+
+// Overlap-add FFT convolution, used by `confluen_IUH_add()` for long IUHs
+// (slow groundwater with Clark or Nash on hourly data). The series is cut in
+// blocks of n_fft - n_iuh + 1, two real blocks go through one complex FFT (as
+// real and imaginary part), so the cost per step is O(log n_iuh) instead of
+// O(n_iuh). The result matches the direct sum up to round-off.
+const int confluen_FFT_minIUH = 64;
+
+// radix-2 FFT in place, n_fft is a power of 2, `twiddle` holds exp(-2 pi i k / n_fft)
+// for k < n_fft / 2, the inverse transform is not scaled
+inline void confluen_fft(
+    std::complex<double>* x,
+    int n_fft,
+    const std::complex<double>* twiddle,
+    bool inverse
+)
+{
+  for (int i = 1, j = 0; i < n_fft; i++) {
+    int bit = n_fft >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(x[i], x[j]);
+  }
+  for (int len = 2; len <= n_fft; len <<= 1) {
+    int half = len >> 1, step = n_fft / len;
+    for (int i = 0; i < n_fft; i += len) {
+      for (int k = 0; k < half; k++) {
+        std::complex<double> w = inverse ? std::conj(twiddle[k * step]) : twiddle[k * step];
+        std::complex<double> u = x[i + k], v = x[i + k + half] * w;
+        x[i + k] = u + v;
+        x[i + k + half] = u - v;
+      }
+    }
+  }
+}
+
+inline void confluen_IUH_fft(
+    int n_time,
+    const double* confluen_inputWater_mm,
+    int n_iuh,
+    const double* confluen_iuh_1,
+    double* confluen_outputWater_mm
+)
+{
+  int n_fft = 1;
+  while (n_fft < 2 * n_iuh) n_fft <<= 1;
+  int n_block = n_fft - n_iuh + 1;
+  const double pi = 3.14159265358979323846;
+  
+  std::vector<std::complex<double>> twiddle(n_fft / 2), H(n_fft), X(n_fft);
+  for (int k = 0; k < n_fft / 2; k++) twiddle[k] = std::polar(1.0, -2.0 * pi * k / n_fft);
+  for (int k = 0; k < n_iuh; k++) H[k] = confluen_iuh_1[k];
+  confluen_fft(H.data(), n_fft, twiddle.data(), false);
+  
+  for (int t_0 = 0; t_0 < n_time; t_0 += 2 * n_block) {
+    int t_1 = t_0 + n_block;
+    std::fill(X.begin(), X.end(), std::complex<double>(0.0, 0.0));
+    for (int k = 0; k < n_block; k++) {
+      double re = t_0 + k < n_time ? confluen_inputWater_mm[t_0 + k] : 0.0;
+      double im = t_1 + k < n_time ? confluen_inputWater_mm[t_1 + k] : 0.0;
+      X[k] = std::complex<double>(re, im);
+    }
+    confluen_fft(X.data(), n_fft, twiddle.data(), false);
+    for (int k = 0; k < n_fft; k++) X[k] *= H[k];
+    confluen_fft(X.data(), n_fft, twiddle.data(), true);
+    for (int k = 0; k < n_fft; k++) {
+      if (t_0 + k < n_time) confluen_outputWater_mm[t_0 + k] += X[k].real() / n_fft;
+      if (t_1 + k < n_time) confluen_outputWater_mm[t_1 + k] += X[k].imag() / n_fft;
+    }
+  }
+}
+
+// Adds the convolution to `confluen_outputWater_mm`, direct sum for short IUHs,
+// overlap-add FFT from `confluen_FFT_minIUH` on. The part of the IUH beyond
+// n_time never reaches the output and is left out.
+inline void confluen_IUH_add(
+    int n_time,
+    const double* confluen_inputWater_mm,
+    int n_iuh,
+    const double* confluen_iuh_1,
+    double* confluen_outputWater_mm
+)
+{
+  if (n_iuh > n_time) n_iuh = n_time;
+  if (n_iuh >= confluen_FFT_minIUH) {
+    confluen_IUH_fft(n_time, confluen_inputWater_mm, n_iuh, confluen_iuh_1, confluen_outputWater_mm);
+    return;
+  }
+  for (int i = 0; i < n_time; i++) {
+    confluen_outputWater_mm[i] += confluen_IUH_step(i, confluen_inputWater_mm, n_iuh, confluen_iuh_1);
+  }
+}
+
+inline void confluen_IUH(
+    int n_time,
+    const double* confluen_inputWater_mm,
+    int n_iuh,
+    const double* confluen_iuh_1,
+    double* confluen_outputWater_mm
+)
+{
+  std::fill(confluen_outputWater_mm, confluen_outputWater_mm + n_time, 0.0);
+  confluen_IUH_add(n_time, confluen_inputWater_mm, n_iuh, confluen_iuh_1, confluen_outputWater_mm);
+}
+
+inline void confluen_IUH2S(
+    int n_time,
+    const double* land_runoff_mm,
+    const double* ground_baseflow_mm,
+    int n_iuhLand,
+    const double* confluen_iuhLand_1,
+    int n_iuhGround,
+    const double* confluen_iuhGround_1,
+    double* confluen_streamflow_mm
+)
+{
+  std::fill(confluen_streamflow_mm, confluen_streamflow_mm + n_time, 0.0);
+  confluen_IUH_add(n_time, land_runoff_mm, n_iuhLand, confluen_iuhLand_1, confluen_streamflow_mm);
+  confluen_IUH_add(n_time, ground_baseflow_mm, n_iuhGround, confluen_iuhGround_1, confluen_streamflow_mm);
+}
+
+inline void confluen_IUH3S(
+    int n_time,
+    const double* land_runoff_mm,
+    const double* soil_interflow_mm,
+    const double* ground_baseflow_mm,
+    int n_iuhLand,
+    const double* confluen_iuhLand_1,
+    int n_iuhSoil,
+    const double* confluen_iuhSoil_1,
+    int n_iuhGround,
+    const double* confluen_iuhGround_1,
+    double* confluen_streamflow_mm
+)
+{
+  std::fill(confluen_streamflow_mm, confluen_streamflow_mm + n_time, 0.0);
+  confluen_IUH_add(n_time, land_runoff_mm, n_iuhLand, confluen_iuhLand_1, confluen_streamflow_mm);
+  confluen_IUH_add(n_time, soil_interflow_mm, n_iuhSoil, confluen_iuhSoil_1, confluen_streamflow_mm);
+  confluen_IUH_add(n_time, ground_baseflow_mm, n_iuhGround, confluen_iuhGround_1, confluen_streamflow_mm);
+}
+
+// Unit hydrograph store as a ring buffer, for the models that route step by step
+// (GR4J). The ring of one spatial unit holds the last `n_uh` inputs twice
+// (length 2 * n_uh), so the window [head, head + n_uh) is always contiguous and
+// holds the newest input first, the same order as a store that is shifted by
+// one every step. The head moves one back per step, so one step costs two
+// writes and one dot product.
+inline int confluen_ringHead(int head, int n_uh)
+{
+  return head == 0 ? n_uh - 1 : head - 1;
+}
+
+// The ring and the UH are templated on the scalar (a dual number carries the
+// derivatives through the routing, see EDCHM_dual.h), the sum on S: a `float`
+// ring and UH are summed in `double`, so the routed volume keeps the one of
+// the inputs.
+template <class T, class U, class S = T>
+inline S confluen_ringStep(
+    int n_uh,
+    T* confluen_ring_mm,
+    int head,
+    T confluen_inputWater_mm,
+    const U* confluen_iuh_1
+)
+{
+  confluen_ring_mm[head] = confluen_inputWater_mm;
+  confluen_ring_mm[head + n_uh] = confluen_inputWater_mm;
+  const T* window = confluen_ring_mm + head;
+  S confluen_outputWater_mm = 0.0;
+  for (int k = 0; k < n_uh; k++) {
+    confluen_outputWater_mm += static_cast<S>(window[k]) * confluen_iuh_1[k];
+  }
+  return confluen_outputWater_mm;
+}
+
+// Streaming routing of one series, for the models that route inside the time
+// loop: `step()` takes the flux of one time step and returns the routed output
+// of that step right away, so no runoff history is kept beyond the last n_iuh
+// inputs. The sum is the one of `confluen_IUH_step()`, the inputs before the
+// first step are zero and add nothing, so the result is the same as the direct
+// convolution of the whole series. The ring (2 * n_iuh) belongs to the caller.
+// The IUH and the ring can be `float` (the single precision of the engine),
+// the output is summed in `double` all the same.
+template <class T = double>
+struct confluen_IUHStream {
+  int n_iuh;
+  const T* confluen_iuh_1;
+  T* confluen_ring_mm;
+  int head;
+
+  confluen_IUHStream(int n_iuh_, const T* confluen_iuh_1_, T* confluen_ring_mm_)
+    : n_iuh(n_iuh_), confluen_iuh_1(confluen_iuh_1_), confluen_ring_mm(confluen_ring_mm_), head(0)
+  {
+    std::fill(confluen_ring_mm, confluen_ring_mm + 2 * n_iuh, T(0));
+  }
+
+  double step(T confluen_inputWater_mm)
+  {
+    head = confluen_ringHead(head, n_iuh);
+    return confluen_ringStep<T, T, double>(n_iuh, confluen_ring_mm, head, confluen_inputWater_mm, confluen_iuh_1);
+  }
+};
+
+// IIR routing ----------
+// Clark (one linear reservoir) and Nash (cascade of n linear reservoirs with the
+// same storage constant t_r) have an exact recursive form, so they need no IUH
+// table, no truncation and only the reservoir storages as state.
+// As in the IUH tables, the input of one step enters the first reservoir at the
+// start of the step and the output is the volume that leaves the last one
+// during the step, i.e. the IUH integrated over every time step.
+// Over one step without input the storages go to S' = Phi S with
+// Phi[i][j] = e^{-1/t_r} (1/t_r)^(i-j) / (i-j)!  (j <= i),
+// and the outflow is c^T S with c[j] = the Poisson(1/t_r) tail P(X >= n - j).
+
+// Fills `phi` (n, first column of Phi) and `c` (n) for `confluenIIR_NashStep()`.
+inline void confluenIIR_NashCoef(
+    double confluen_responseTime_TS,
+    int n_reservoir,
+    double* phi,
+    double* c
+)
+{
+  double lambda = 1.0 / confluen_responseTime_TS, a = std::exp(- lambda);
+  double term = a;
+  for (int m = 0; m < n_reservoir; m++) {
+    phi[m] = term;
+    term *= lambda / (m + 1);
+  }
+  // term is now the Poisson probability of n_reservoir, sum the tail from there,
+  // so c stays accurate also when it is tiny (slow reservoirs)
+  double tail = 0.0;
+  for (int m = n_reservoir; m < n_reservoir + 1000; m++) {
+    tail += term;
+    term *= lambda / (m + 1);
+    if (term <= tail * 1e-17) break;
+  }
+  for (int j = 0; j < n_reservoir; j++) {
+    c[j] = tail;
+    tail += phi[n_reservoir - 1 - j];
+  }
+}
+
+// One step of the cascade, `S` (n) are the storages (mm), returns the outflow (mm).
+inline double confluenIIR_NashStep(
+    int n_reservoir,
+    const double* phi,
+    const double* c,
+    double* S,
+    double confluen_inputWater_mm
+)
+{
+  S[0] += confluen_inputWater_mm;
+  double confluen_outputWater_mm = 0.0;
+  for (int j = 0; j < n_reservoir; j++) confluen_outputWater_mm += c[j] * S[j];
+  for (int i = n_reservoir - 1; i >= 0; i--) {
+    double S_i = 0.0;
+    for (int j = 0; j <= i; j++) S_i += phi[i - j] * S[j];
+    S[i] = S_i;
+  }
+  return confluen_outputWater_mm;
+}
+
+// Clark is the cascade with one reservoir: S' = a S, outflow (1 - a) S.
+inline double confluenIIR_ClarkStep(
+    double a,
+    double& S,
+    double confluen_inputWater_mm
+)
+{
+  S += confluen_inputWater_mm;
+  double confluen_outputWater_mm = (1 - a) * S;
+  S *= a;
+  return confluen_outputWater_mm;
+}
+
+inline void confluen_IIR_Clark(
+    int n_time,
+    const double* confluen_inputWater_mm,
+    double confluen_responseTime_TS,
+    double* confluen_outputWater_mm
+)
+{
+  double a = std::exp(- 1.0 / confluen_responseTime_TS), S = 0.0;
+  for (int i = 0; i < n_time; i++) {
+    confluen_outputWater_mm[i] = confluenIIR_ClarkStep(a, S, confluen_inputWater_mm[i]);
+  }
+}
+
+// The cascade needs a whole number of reservoirs, `param_confluen_nas_n` is rounded
+inline int confluenIIR_NashN(double param_confluen_nas_n)
+{
+  int n_reservoir = (int)std::floor(param_confluen_nas_n + 0.5);
+  return n_reservoir < 1 ? 1 : n_reservoir;
+}
+
+inline void confluen_IIR_Nash(
+    int n_time,
+    const double* confluen_inputWater_mm,
+    double confluen_responseTime_TS,
+    double param_confluen_nas_n,
+    double* confluen_outputWater_mm
+)
+{
+  int n_reservoir = confluenIIR_NashN(param_confluen_nas_n);
+  std::vector<double> phi(n_reservoir), c(n_reservoir), S(n_reservoir, 0.0);
+  confluenIIR_NashCoef(confluen_responseTime_TS, n_reservoir, phi.data(), c.data());
+  for (int i = 0; i < n_time; i++) {
+    confluen_outputWater_mm[i] = confluenIIR_NashStep(n_reservoir, phi.data(), c.data(), S.data(), confluen_inputWater_mm[i]);
+  }
+}
+
+// IUH tables ----------
+// The IUH of one spatial unit from the method parameters, the same values as the
+// Rcpp sugar in `confluenIUH_*()` had. Kelly, Nash and Clark are sampled 20
+// times per step and averaged over the step, then normalised to a sum of 1.
+// A response time below one step gives an empty IUH.
+// GR4J, Kelly and the step mean are templated on the scalar like the kernels,
+// the length of the IUH only depends on the value (`scalar_value()`).
+// With `fast` the GR4J curves take x^2.5 as x x sqrt(x) (within 3 ulp of pow()),
+// the IUHs of the fast path of the GR4J models.
+
+inline double scalar_value(double x)
+{
+  return x;
+}
+
+template <class T>
+inline T confluenIUH_GR4Jpow(
+    T x,
+    bool fast
+)
+{
+  return fast ? x * x * sqrt(x) : pow(x, 2.5);
+}
+
+template <class T>
+inline std::vector<T> confluenIUH_GR4J1(
+    T confluen_responseTime_TS,
+    bool fast = false
+)
+{
+  double t_max = std::ceil(scalar_value(confluen_responseTime_TS));
+  if (!(t_max >= 1)) return std::vector<T>();
+  int n_t = (int)t_max;
+  std::vector<T> SH_1(n_t);
+  for (int i = 0; i < n_t; i++) {
+    SH_1[i] = confluenIUH_GR4Jpow((i + 1) / confluen_responseTime_TS, fast);
+  }
+  SH_1[n_t - 1] = 1;
+  for (int i = n_t - 1; i > 0; i--) {
+    SH_1[i] = SH_1[i] - SH_1[i - 1];
+  }
+  return SH_1;
+}
+
+template <class T>
+inline std::vector<T> confluenIUH_GR4J2(
+    T confluen_responseTime_TS,
+    bool fast = false
+)
+{
+  double t_max_1 = std::ceil(scalar_value(confluen_responseTime_TS));
+  double t_max_2 = std::ceil(2 * scalar_value(confluen_responseTime_TS));
+  if (!(t_max_1 >= 1)) return std::vector<T>();
+  int n_t1 = (int)t_max_1, n_t2 = (int)t_max_2;
+  std::vector<T> SH_2(n_t2, 1.0);
+  for (int i = 0; i < n_t1 - 1; i++) {
+    SH_2[i] = .5 * confluenIUH_GR4Jpow(((i + 1) / confluen_responseTime_TS), fast);
+  }
+  for (int i = n_t1 - 1; i < n_t2 - 1; i++) {
+    SH_2[i] = 1 - .5 * confluenIUH_GR4Jpow((2 - (i + 1) / confluen_responseTime_TS), fast);
+  }
+  for (int i = n_t2 - 1; i > 0; i--) {
+    SH_2[i] = SH_2[i] - SH_2[i - 1];
+  }
+  return SH_2;
+}
+
+// mean of every 20 samples, divided by the sum of the means
+template <class T>
+inline std::vector<T> confluenIUH_stepMean(
+    int n_t,
+    const std::vector<T>& iuh_
+)
+{
+  std::vector<T> vct_iuh(n_t);
+  T sum_iuh = 0.0;
+  for (int t = 0; t < n_t; t++) {
+    T s = 0.0;
+    for (int k = 0; k < 20; k++) s += iuh_[20 * t + k];
+    vct_iuh[t] = s / 20;
+    sum_iuh += vct_iuh[t];
+  }
+  for (int t = 0; t < n_t; t++) vct_iuh[t] = vct_iuh[t] / sum_iuh;
+  return vct_iuh;
+}
+
+template <class T>
+inline std::vector<T> confluenIUH_Kelly(
+    T confluen_responseTime_TS,
+    T param_confluen_kel_k
+)
+{
+  T confluen_concentratTime_TS = confluen_responseTime_TS * param_confluen_kel_k;
+  T num_temp_tc2 = (confluen_concentratTime_TS * confluen_concentratTime_TS);
+  T num_temp_12_34 = 4 * confluen_responseTime_TS  / num_temp_tc2 * 
+    (1 - 2 * exp(confluen_concentratTime_TS / confluen_responseTime_TS * 0.5));
+  T num_temp_12_35 = 4 * confluen_responseTime_TS  / num_temp_tc2 * 
+    (1 - 2 * exp(confluen_concentratTime_TS / confluen_responseTime_TS * 0.5) + exp(confluen_concentratTime_TS / confluen_responseTime_TS));
+  double t_max = std::ceil(std::max(scalar_value(confluen_concentratTime_TS), - scalar_value(confluen_responseTime_TS) * std::log(0.002 / scalar_value(num_temp_12_35))));
+  if (!(t_max >= 1)) return std::vector<T>();
+  int n_t = (int)t_max;
+  std::vector<T> iuh_(20 * n_t);
+  for (int k = 0; k < 20 * n_t; k++) {
+    double t_ = (k + 1) / 20.0;
+    T temp_etK = exp(- t_ / confluen_responseTime_TS);
+    if (t_ > confluen_concentratTime_TS) {
+      iuh_[k] = num_temp_12_35 * temp_etK;
+    } else if (t_ > confluen_concentratTime_TS * 0.5) {
+      iuh_[k] = num_temp_12_34 * temp_etK - 4 / num_temp_tc2 * (t_ - confluen_responseTime_TS - confluen_concentratTime_TS);
+    } else {
+      iuh_[k] = 4 / num_temp_tc2 * (t_ + confluen_responseTime_TS * (temp_etK - 1));
+    }
+  }
+  return confluenIUH_stepMean(n_t, iuh_);
+}
+
+inline std::vector<double> confluenIUH_Nash(
+    double confluen_responseTime_TS,
+    double param_confluen_nas_n
+)
+{
+  double t_max = std::ceil(std::max(4.0, param_confluen_nas_n) * 3 * confluen_responseTime_TS);
+  if (!(t_max >= 1)) return std::vector<double>();
+  int n_t = (int)t_max;
+  double gamma_n = std::tgamma(param_confluen_nas_n);
+  std::vector<double> iuh_(20 * n_t);
+  for (int k = 0; k < 20 * n_t; k++) {
+    double t_ = (k + 1) / 20.0;
+    iuh_[k] = std::pow(t_ / confluen_responseTime_TS, param_confluen_nas_n - 1) * std::exp(- t_ / confluen_responseTime_TS) / 
+      confluen_responseTime_TS / gamma_n;
+  }
+  return confluenIUH_stepMean(n_t, iuh_);
+}
+
+inline std::vector<double> confluenIUH_Clark(
+    double confluen_responseTime_TS
+)
+{
+  double t_max = std::ceil(- confluen_responseTime_TS * std::log(confluen_responseTime_TS * 0.005));
+  if (!(t_max >= 1)) return std::vector<double>();
+  int n_t = (int)t_max;
+  std::vector<double> iuh_(20 * n_t);
+  for (int k = 0; k < 20 * n_t; k++) {
+    double t_ = (k + 1) / 20.0;
+    iuh_[k] = 1 / confluen_responseTime_TS * std::exp(- t_ / confluen_responseTime_TS);
+  }
+  return confluenIUH_stepMean(n_t, iuh_);
+}
+
+} // namespace kernel
+
+// IUH cache ----------
+// The IUHs only depend on the method and one or two parameters, but building one
+// costs much more than using it. They are kept process-wide, so cells with equal
+// parameters and repeated runs (calibration) reuse them, the IUH stays valid as
+// long as the pointer is held. The parameters are keyed by their bits, so NaN
+// (an NA from R, a wild candidate) is a key like any other. When the cache is
+// full the least recently used IUH is dropped, and an IUH is built outside the
+// lock, so threads only wait for each other on the lookup.
+enum confluenIUH_method { IUH_GR4J1, IUH_GR4J2, IUH_Kelly, IUH_Nash, IUH_Clark, IUH_GR4J1fast, IUH_GR4J2fast };
+typedef std::shared_ptr<const std::vector<double>> IUH_ptr;
+
+inline std::uint64_t confluenIUH_bits(double x)
+{
+  std::uint64_t bits_;
+  std::memcpy(&bits_, &x, sizeof(double));
+  return bits_;
+}
+
+inline IUH_ptr confluenIUH_cached(
+    confluenIUH_method method,
+    double confluen_responseTime_TS,
+    double param_confluen = 0.0
+)
+{
+  typedef std::tuple<int, std::uint64_t, std::uint64_t> IUH_key;
+  // the IUH and its place in `IUH_age` (most recently used first)
+  struct IUH_entry {
+    IUH_ptr iuh;
+    std::list<IUH_key>::iterator age;
+  };
+  static std::map<IUH_key, IUH_entry> IUH_cache;
+  static std::list<IUH_key> IUH_age;
+  static std::mutex IUH_cache_mutex;
+  const size_t IUH_cache_max = 4096;
+  
+  IUH_key key(method, confluenIUH_bits(confluen_responseTime_TS), confluenIUH_bits(param_confluen));
+  {
+    std::lock_guard<std::mutex> lock(IUH_cache_mutex);
+    std::map<IUH_key, IUH_entry>::iterator it = IUH_cache.find(key);
+    if (it != IUH_cache.end()) {
+      IUH_age.splice(IUH_age.begin(), IUH_age, it->second.age);
+      return it->second.iuh;
+    }
+  }
+  
+  std::vector<double> iuh_;
+  switch (method) {
+  case IUH_GR4J1: iuh_ = kernel::confluenIUH_GR4J1(confluen_responseTime_TS); break;
+  case IUH_GR4J2: iuh_ = kernel::confluenIUH_GR4J2(confluen_responseTime_TS); break;
+  case IUH_Kelly: iuh_ = kernel::confluenIUH_Kelly(confluen_responseTime_TS, param_confluen); break;
+  case IUH_Nash: iuh_ = kernel::confluenIUH_Nash(confluen_responseTime_TS, param_confluen); break;
+  case IUH_Clark: iuh_ = kernel::confluenIUH_Clark(confluen_responseTime_TS); break;
+  case IUH_GR4J1fast: iuh_ = kernel::confluenIUH_GR4J1(confluen_responseTime_TS, true); break;
+  case IUH_GR4J2fast: iuh_ = kernel::confluenIUH_GR4J2(confluen_responseTime_TS, true); break;
+  }
+  IUH_ptr iuh_ptr = std::make_shared<const std::vector<double>>(std::move(iuh_));
+  
+  // another thread may have built the same IUH meanwhile, then that one is kept
+  std::lock_guard<std::mutex> lock(IUH_cache_mutex);
+  std::map<IUH_key, IUH_entry>::iterator it = IUH_cache.find(key);
+  if (it != IUH_cache.end()) {
+    IUH_age.splice(IUH_age.begin(), IUH_age, it->second.age);
+    return it->second.iuh;
+  }
+  if (IUH_cache.size() >= IUH_cache_max) {
+    IUH_cache.erase(IUH_age.back());
+    IUH_age.pop_back();
+  }
+  IUH_age.push_front(key);
+  IUH_cache[key] = IUH_entry{iuh_ptr, IUH_age.begin()};
+  return iuh_ptr;
+}
+
+} // namespace EDCHM
+
+#endif // EDCHM_CONFLUEN_H
@@ -0,0 +1,492 @@
+// Defines a header file for the models on plain arrays
+//
+// The drivers of `EDCHM_mini()`, `EDCHM_snow()` and `EDCHM_GR4J()` work on raw
+// `double` arrays, so a model can run without an R session: the Rcpp functions
+// of the same name are thin wrappers around them, and the command-line runner
+// (cli/EDCHM_run.cpp) calls them on binary files.
+// - a forcing matrix is column major, n_row x n_spat with n_row >= n_time
+// - a constant or parameter has one value per spatial unit
+// - `out` has one pointer per output variable (in the order of `*_output`),
+//   nullptr when the variable is not asked, otherwise n_time x n_spat column major
+// Wrong sizes throw `std::invalid_argument`, which Rcpp turns into an R error.
+// The header is free of Rcpp.
+#ifndef EDCHM_CORE_H
+#define EDCHM_CORE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "EDCHM_kernel.h"
+#include "EDCHM_confluen.h"
+#include "EDCHM_compose.h"
+
+namespace EDCHM {
+
+// A pointer and a length, the memory belongs to the caller
+// (the C++17 stand-in for `std::span`).
+template <class T>
+struct view {
+  typedef typename std::remove_const<T>::type value_type;
+  T* ptr = nullptr;
+  std::size_t n = 0;
+
+  view() {}
+  view(T* ptr_, std::size_t n_) : ptr(ptr_), n(n_) {}
+  view(std::vector<value_type>& x) : ptr(x.data()), n(x.size()) {}
+  view(const std::vector<value_type>& x) : ptr(x.data()), n(x.size()) {}
+
+  T* data() const { return ptr; }
+  std::size_t size() const { return n; }
+  T& operator[](std::size_t i) const { return ptr[i]; }
+  T* begin() const { return ptr; }
+  T* end() const { return ptr + n; }
+};
+
+namespace core {
+
+// the processes of one step, composed at compile time (EDCHM_compose.h)
+typedef compose::modell<
+  compose::evatransSoil<compose::evatransActual_UBC>,
+  compose::infilt<compose::infilt_UBC>,
+  compose::percola<compose::percola_Arno>,
+  compose::baseflow<compose::baseflow_GR4Jfix>
+> modell_mini;
+
+typedef compose::modell<
+  compose::atmosSnow<compose::atmosSnow_ThresholdT>,
+  compose::evatransSoil<compose::evatransActual_UBC>,
+  compose::snowMelt<compose::snowMelt_Factor>,
+  compose::infilt<compose::infilt_UBC>,
+  compose::percola<compose::percola_Arno>,
+  compose::baseflow<compose::baseflow_GR4Jfix>
+> modell_snow;
+
+// output variables, the index in the list is the index in `out`
+inline const std::vector<std::string> EDCHM_mini_output = {
+  "evatrans_mm", "soilwater_mm", "groundwater_mm", "runoff_mm", "baseflow_mm", "streamflow_mm"
+};
+inline const std::vector<std::string> EDCHM_snow_output = {
+  "evatrans_mm", "soilwater_mm", "groundwater_mm", "runoff_mm", "baseflow_mm", "streamflow_mm", "snowice_mm", "snowmelt_mm"
+};
+inline const std::vector<std::string> EDCHM_GR4J_output = {
+  "S", "Q9", "Q1", "Perc", "Pr", "AE", "R", "Qr", "Qd", "Q"
+};
+
+// checks ----------
+
+inline void modell_checkRun(int n_time, int n_spat, int n_thread)
+{
+  if (n_time < 0 || n_spat < 0) throw std::invalid_argument("`n_time` and `n_spat` can not be negative.");
+  if (n_thread < 1) throw std::invalid_argument("`n_thread` must be at least 1.");
+}
+
+// returns the number of rows of the forcing matrix
+inline int modell_checkForcing(const char* name, view<const double> x, int n_time, int n_spat)
+{
+  int n_row = n_spat > 0 ? (int)(x.size() / n_spat) : n_time;
+  if (n_row < n_time || (std::size_t)n_row * n_spat != x.size()) {
+    throw std::invalid_argument(std::string("`") + name + "` must be a matrix with at least `n_time` rows and `n_spat` columns.");
+  }
+  return n_row;
+}
+
+inline void modell_checkParam(const char* name, view<const double> x, int n_spat)
+{
+  if (x.size() < (std::size_t)n_spat) {
+    throw std::invalid_argument(std::string("`") + name + "` must have one value for every spatial unit.");
+  }
+}
+
+inline void modell_checkOutput(const std::vector<double*>& out, const std::vector<std::string>& vari_name)
+{
+  if (out.size() != vari_name.size()) throw std::invalid_argument("`out` must have one pointer for every output variable.");
+}
+
+// column of spatial unit j of the k-th output, or nullptr when it is not asked
+inline double* modell_outColumn(const std::vector<double*>& out, int k, int j, int n_time)
+{
+  return out[k] ? out[k] + (std::size_t)j * n_time : nullptr;
+}
+
+inline void modell_store(double* out_j, int i, double value)
+{
+  if (out_j) out_j[i] = value;
+}
+
+// models ----------
+
+inline void EDCHM_mini(
+    int n_time,
+    int n_spat,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    view<const double> ground_capacity_mm,
+    view<const double> ground_water_mm,
+    view<const double> land_impermeableFrac_1,
+    view<const double> soil_capacity_mm,
+    view<const double> soil_potentialPercola_mm,
+    view<const double> soil_water_mm,
+    view<const double> confluenLand_responseTime_TS,
+    view<const double> confluenGround_responseTime_TS,
+    view<const double> param_baseflow_grf_gamma,
+    view<const double> param_confluenLand_kel_k,
+    view<const double> param_evatrans_ubc_gamma,
+    view<const double> param_infilt_ubc_P0AGEN,
+    view<const double> param_percola_arn_k,
+    view<const double> param_percola_arn_thresh,
+    int n_thread,
+    const std::vector<double*>& out
+)
+{
+  modell_checkRun(n_time, n_spat, n_thread);
+  int n_row_PET = modell_checkForcing("atmos_potentialEvatrans_mm", atmos_potentialEvatrans_mm, n_time, n_spat);
+  int n_row_P = modell_checkForcing("atmos_precipitation_mm", atmos_precipitation_mm, n_time, n_spat);
+  modell_checkParam("ground_capacity_mm", ground_capacity_mm, n_spat);
+  modell_checkParam("ground_water_mm", ground_water_mm, n_spat);
+  modell_checkParam("land_impermeableFrac_1", land_impermeableFrac_1, n_spat);
+  modell_checkParam("soil_capacity_mm", soil_capacity_mm, n_spat);
+  modell_checkParam("soil_potentialPercola_mm", soil_potentialPercola_mm, n_spat);
+  modell_checkParam("soil_water_mm", soil_water_mm, n_spat);
+  modell_checkParam("confluenLand_responseTime_TS", confluenLand_responseTime_TS, n_spat);
+  modell_checkParam("confluenGround_responseTime_TS", confluenGround_responseTime_TS, n_spat);
+  modell_checkParam("param_baseflow_grf_gamma", param_baseflow_grf_gamma, n_spat);
+  modell_checkParam("param_confluenLand_kel_k", param_confluenLand_kel_k, n_spat);
+  modell_checkParam("param_evatrans_ubc_gamma", param_evatrans_ubc_gamma, n_spat);
+  modell_checkParam("param_infilt_ubc_P0AGEN", param_infilt_ubc_P0AGEN, n_spat);
+  modell_checkParam("param_percola_arn_k", param_percola_arn_k, n_spat);
+  modell_checkParam("param_percola_arn_thresh", param_percola_arn_thresh, n_spat);
+  modell_checkOutput(out, EDCHM_mini_output);
+  enum { OUT_evatrans, OUT_soilwater, OUT_groundwater, OUT_runoff, OUT_baseflow, OUT_streamflow };
+
+  // the IUHs come from the IUH cache, so they are ready before the parallel region
+  std::vector<IUH_ptr> confluenLand_iuh_1(n_spat), confluenGround_iuh_1(n_spat);
+  for (int j= 0; j < n_spat; j++) {
+    confluenLand_iuh_1[j] = confluenIUH_cached(IUH_Kelly, confluenLand_responseTime_TS[j], param_confluenLand_kel_k[j]);
+    confluenGround_iuh_1[j] = confluenIUH_cached(IUH_GR4J1, confluenGround_responseTime_TS[j]);
+  }
+
+  // the routing is streamed inside the time loop, the ring of every thread holds
+  // the last inputs for the longest IUH (the part beyond n_time never reaches the output);
+  // a unit with an IUH of `confluen_FFT_minIUH` steps or more keeps its runoff and
+  // baseflow series and routes them after the time loop (`confluen_IUH2S()`, FFT)
+  int n_iuhLand_max = 0, n_iuhGround_max = 0;
+  std::vector<char> confluen_batch(n_spat);
+  bool any_batch = false;
+  for (int j= 0; j < n_spat; j++) {
+    int n_iuhLand = std::min((int)confluenLand_iuh_1[j]->size(), n_time), n_iuhGround = std::min((int)confluenGround_iuh_1[j]->size(), n_time);
+    confluen_batch[j] = n_iuhLand >= kernel::confluen_FFT_minIUH || n_iuhGround >= kernel::confluen_FFT_minIUH;
+    any_batch = any_batch || confluen_batch[j];
+    if (confluen_batch[j]) continue;
+    n_iuhLand_max = std::max(n_iuhLand_max, n_iuhLand);
+    n_iuhGround_max = std::max(n_iuhGround_max, n_iuhGround);
+  }
+
+  // the spatial units are independent until the confluen, so every unit runs its
+  // whole time series in turn, with the state in a `compose::cell` and the forcing
+  // read along the column
+#pragma omp parallel num_threads(n_thread)
+{
+  std::vector<double> confluenLand_ring(2 * n_iuhLand_max), confluenGround_ring(2 * n_iuhGround_max);
+  std::vector<double> land_runoff(any_batch ? n_time : 0), ground_baseflow(any_batch ? n_time : 0);
+
+#pragma omp for schedule(static)
+  for (int j= 0; j < n_spat; j++) {
+
+    const double *atmos_potentialEvatrans = atmos_potentialEvatrans_mm.data() + (std::size_t)j * n_row_PET, *atmos_precipitation = atmos_precipitation_mm.data() + (std::size_t)j * n_row_P;
+    compose::cell c_;
+    c_.soil_water_mm = soil_water_mm[j]; c_.ground_water_mm = ground_water_mm[j];
+    compose::param p_;
+    p_.soil_capacity_mm = soil_capacity_mm[j]; p_.ground_capacity_mm = ground_capacity_mm[j]; p_.land_impermeableFrac_1 = land_impermeableFrac_1[j]; p_.soil_potentialPercola_mm = soil_potentialPercola_mm[j];
+    p_.param_baseflow_grf_gamma = param_baseflow_grf_gamma[j]; p_.param_evatrans_ubc_gamma = param_evatrans_ubc_gamma[j]; p_.param_infilt_ubc_P0AGEN = param_infilt_ubc_P0AGEN[j];
+    p_.param_percola_arn_k = param_percola_arn_k[j]; p_.param_percola_arn_thresh = param_percola_arn_thresh[j];
+    bool batch_ = confluen_batch[j];
+    kernel::confluen_IUHStream confluenLand(batch_ ? 0 : std::min((int)confluenLand_iuh_1[j]->size(), n_time), confluenLand_iuh_1[j]->data(), confluenLand_ring.data());
+    kernel::confluen_IUHStream confluenGround(batch_ ? 0 : std::min((int)confluenGround_iuh_1[j]->size(), n_time), confluenGround_iuh_1[j]->data(), confluenGround_ring.data());
+    double *out_evatrans = modell_outColumn(out, OUT_evatrans, j, n_time), *out_soilwater = modell_outColumn(out, OUT_soilwater, j, n_time), *out_groundwater = modell_outColumn(out, OUT_groundwater, j, n_time);
+    double *out_runoff = modell_outColumn(out, OUT_runoff, j, n_time), *out_baseflow = modell_outColumn(out, OUT_baseflow, j, n_time), *out_streamflow = modell_outColumn(out, OUT_streamflow, j, n_time);
+
+    for (int i= 0; i < n_time; i++) {
+
+      c_.atmos_potentialEvatrans_mm = atmos_potentialEvatrans[i];
+      c_.atmos_precipitation_mm = atmos_precipitation[i];
+      modell_mini::step(c_, p_);
+
+      if (!batch_) {
+        if (out_streamflow) out_streamflow[i] = confluenLand.step(c_.land_runoff_mm) + confluenGround.step(c_.ground_baseflow_mm);
+      } else {
+        land_runoff[i] = c_.land_runoff_mm;
+        ground_baseflow[i] = c_.ground_baseflow_mm;
+      }
+      modell_store(out_evatrans, i, c_.soil_evatrans_mm);
+      modell_store(out_soilwater, i, c_.soil_water_mm);
+      modell_store(out_groundwater, i, c_.ground_water_mm);
+      modell_store(out_runoff, i, c_.land_runoff_mm);
+      modell_store(out_baseflow, i, c_.ground_baseflow_mm);
+
+    }
+
+    if (batch_ && out_streamflow) {
+      kernel::confluen_IUH2S(n_time, land_runoff.data(), ground_baseflow.data(),
+                             confluenLand_iuh_1[j]->size(), confluenLand_iuh_1[j]->data(),
+                             confluenGround_iuh_1[j]->size(), confluenGround_iuh_1[j]->data(),
+                             out_streamflow);
+    }
+  }
+}
+}
+
+inline void EDCHM_snow(
+    int n_time,
+    int n_spat,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    view<const double> atmos_temperature_Cel,
+    view<const double> ground_capacity_mm,
+    view<const double> ground_water_mm,
+    view<const double> land_impermeableFrac_1,
+    view<const double> snow_ice_mm,
+    view<const double> soil_capacity_mm,
+    view<const double> soil_potentialPercola_mm,
+    view<const double> soil_water_mm,
+    view<const double> confluenLand_responseTime_TS,
+    view<const double> confluenGround_responseTime_TS,
+    view<const double> param_atmos_thr_Ts,
+    view<const double> param_baseflow_grf_gamma,
+    view<const double> param_confluenLand_kel_k,
+    view<const double> param_evatrans_ubc_gamma,
+    view<const double> param_infilt_ubc_P0AGEN,
+    view<const double> param_percola_arn_k,
+    view<const double> param_percola_arn_thresh,
+    view<const double> param_snow_fac_f,
+    view<const double> param_snow_fac_Tmelt,
+    int n_thread,
+    const std::vector<double*>& out
+)
+{
+  modell_checkRun(n_time, n_spat, n_thread);
+  int n_row_PET = modell_checkForcing("atmos_potentialEvatrans_mm", atmos_potentialEvatrans_mm, n_time, n_spat);
+  int n_row_P = modell_checkForcing("atmos_precipitation_mm", atmos_precipitation_mm, n_time, n_spat);
+  int n_row_T = modell_checkForcing("atmos_temperature_Cel", atmos_temperature_Cel, n_time, n_spat);
+  modell_checkParam("ground_capacity_mm", ground_capacity_mm, n_spat);
+  modell_checkParam("ground_water_mm", ground_water_mm, n_spat);
+  modell_checkParam("land_impermeableFrac_1", land_impermeableFrac_1, n_spat);
+  modell_checkParam("snow_ice_mm", snow_ice_mm, n_spat);
+  modell_checkParam("soil_capacity_mm", soil_capacity_mm, n_spat);
+  modell_checkParam("soil_potentialPercola_mm", soil_potentialPercola_mm, n_spat);
+  modell_checkParam("soil_water_mm", soil_water_mm, n_spat);
+  modell_checkParam("confluenLand_responseTime_TS", confluenLand_responseTime_TS, n_spat);
+  modell_checkParam("confluenGround_responseTime_TS", confluenGround_responseTime_TS, n_spat);
+  modell_checkParam("param_atmos_thr_Ts", param_atmos_thr_Ts, n_spat);
+  modell_checkParam("param_baseflow_grf_gamma", param_baseflow_grf_gamma, n_spat);
+  modell_checkParam("param_confluenLand_kel_k", param_confluenLand_kel_k, n_spat);
+  modell_checkParam("param_evatrans_ubc_gamma", param_evatrans_ubc_gamma, n_spat);
+  modell_checkParam("param_infilt_ubc_P0AGEN", param_infilt_ubc_P0AGEN, n_spat);
+  modell_checkParam("param_percola_arn_k", param_percola_arn_k, n_spat);
+  modell_checkParam("param_percola_arn_thresh", param_percola_arn_thresh, n_spat);
+  modell_checkParam("param_snow_fac_f", param_snow_fac_f, n_spat);
+  modell_checkParam("param_snow_fac_Tmelt", param_snow_fac_Tmelt, n_spat);
+  modell_checkOutput(out, EDCHM_snow_output);
+  enum { OUT_evatrans, OUT_soilwater, OUT_groundwater, OUT_runoff, OUT_baseflow, OUT_streamflow, OUT_snowice, OUT_snowmelt };
+
+  // the IUHs come from the IUH cache, so they are ready before the parallel region
+  std::vector<IUH_ptr> confluenLand_iuh_1(n_spat), confluenGround_iuh_1(n_spat);
+  for (int j= 0; j < n_spat; j++) {
+    confluenLand_iuh_1[j] = confluenIUH_cached(IUH_Kelly, confluenLand_responseTime_TS[j], param_confluenLand_kel_k[j]);
+    confluenGround_iuh_1[j] = confluenIUH_cached(IUH_GR4J1, confluenGround_responseTime_TS[j]);
+  }
+
+  // streamed or batch routing per unit (see EDCHM_mini)
+  int n_iuhLand_max = 0, n_iuhGround_max = 0;
+  std::vector<char> confluen_batch(n_spat);
+  bool any_batch = false;
+  for (int j= 0; j < n_spat; j++) {
+    int n_iuhLand = std::min((int)confluenLand_iuh_1[j]->size(), n_time), n_iuhGround = std::min((int)confluenGround_iuh_1[j]->size(), n_time);
+    confluen_batch[j] = n_iuhLand >= kernel::confluen_FFT_minIUH || n_iuhGround >= kernel::confluen_FFT_minIUH;
+    any_batch = any_batch || confluen_batch[j];
+    if (confluen_batch[j]) continue;
+    n_iuhLand_max = std::max(n_iuhLand_max, n_iuhLand);
+    n_iuhGround_max = std::max(n_iuhGround_max, n_iuhGround);
+  }
+
+  // every spatial unit runs its whole time series in turn (see EDCHM_mini)
+#pragma omp parallel num_threads(n_thread)
+{
+  std::vector<double> confluenLand_ring(2 * n_iuhLand_max), confluenGround_ring(2 * n_iuhGround_max);
+  std::vector<double> land_runoff(any_batch ? n_time : 0), ground_baseflow(any_batch ? n_time : 0);
+
+#pragma omp for schedule(static)
+  for (int j= 0; j < n_spat; j++) {
+
+    const double *atmos_potentialEvatrans = atmos_potentialEvatrans_mm.data() + (std::size_t)j * n_row_PET, *atmos_precipitation = atmos_precipitation_mm.data() + (std::size_t)j * n_row_P, *atmos_temperature = atmos_temperature_Cel.data() + (std::size_t)j * n_row_T;
+    compose::cell c_;
+    c_.soil_water_mm = soil_water_mm[j]; c_.ground_water_mm = ground_water_mm[j]; c_.snow_ice_mm = snow_ice_mm[j];
+    compose::param p_;
+    p_.soil_capacity_mm = soil_capacity_mm[j]; p_.ground_capacity_mm = ground_capacity_mm[j]; p_.land_impermeableFrac_1 = land_impermeableFrac_1[j]; p_.soil_potentialPercola_mm = soil_potentialPercola_mm[j];
+    p_.param_atmos_thr_Ts = param_atmos_thr_Ts[j]; p_.param_baseflow_grf_gamma = param_baseflow_grf_gamma[j]; p_.param_evatrans_ubc_gamma = param_evatrans_ubc_gamma[j]; p_.param_infilt_ubc_P0AGEN = param_infilt_ubc_P0AGEN[j];
+    p_.param_percola_arn_k = param_percola_arn_k[j]; p_.param_percola_arn_thresh = param_percola_arn_thresh[j]; p_.param_snow_fac_f = param_snow_fac_f[j]; p_.param_snow_fac_Tmelt = param_snow_fac_Tmelt[j];
+    bool batch_ = confluen_batch[j];
+    kernel::confluen_IUHStream confluenLand(batch_ ? 0 : std::min((int)confluenLand_iuh_1[j]->size(), n_time), confluenLand_iuh_1[j]->data(), confluenLand_ring.data());
+    kernel::confluen_IUHStream confluenGround(batch_ ? 0 : std::min((int)confluenGround_iuh_1[j]->size(), n_time), confluenGround_iuh_1[j]->data(), confluenGround_ring.data());
+    double *out_evatrans = modell_outColumn(out, OUT_evatrans, j, n_time), *out_soilwater = modell_outColumn(out, OUT_soilwater, j, n_time), *out_groundwater = modell_outColumn(out, OUT_groundwater, j, n_time);
+    double *out_runoff = modell_outColumn(out, OUT_runoff, j, n_time), *out_baseflow = modell_outColumn(out, OUT_baseflow, j, n_time), *out_streamflow = modell_outColumn(out, OUT_streamflow, j, n_time);
+    double *out_snowice = modell_outColumn(out, OUT_snowice, j, n_time), *out_snowmelt = modell_outColumn(out, OUT_snowmelt, j, n_time);
+
+    for (int i= 0; i < n_time; i++) {
+
+      c_.atmos_potentialEvatrans_mm = atmos_potentialEvatrans[i];
+      c_.atmos_precipitation_mm = atmos_precipitation[i];
+      c_.atmos_temperature_Cel = atmos_temperature[i];
+      modell_snow::step(c_, p_);
+
+      if (!batch_) {
+        if (out_streamflow) out_streamflow[i] = confluenLand.step(c_.land_runoff_mm) + confluenGround.step(c_.ground_baseflow_mm);
+      } else {
+        land_runoff[i] = c_.land_runoff_mm;
+        ground_baseflow[i] = c_.ground_baseflow_mm;
+      }
+      modell_store(out_evatrans, i, c_.soil_evatrans_mm);
+      modell_store(out_soilwater, i, c_.soil_water_mm);
+      modell_store(out_groundwater, i, c_.ground_water_mm);
+      modell_store(out_runoff, i, c_.land_runoff_mm);
+      modell_store(out_baseflow, i, c_.ground_baseflow_mm);
+      modell_store(out_snowice, i, c_.snow_ice_mm);
+      modell_store(out_snowmelt, i, c_.snow_melt_mm);
+
+    }
+
+    if (batch_ && out_streamflow) {
+      kernel::confluen_IUH2S(n_time, land_runoff.data(), ground_baseflow.data(),
+                             confluenLand_iuh_1[j]->size(), confluenLand_iuh_1[j]->data(),
+                             confluenGround_iuh_1[j]->size(), confluenGround_iuh_1[j]->data(),
+                             out_streamflow);
+    }
+  }
+}
+}
+
+// `fast_pow` runs the `*_GR4Jfast` kernels and IUHs, false the pow() forms of
+// the process functions
+inline void EDCHM_GR4J(
+    int n_time,
+    int n_spat,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    view<const double> S_,
+    view<const double> R_,
+    view<const double> X_1,
+    view<const double> X_2,
+    view<const double> X_3,
+    view<const double> X_4,
+    int n_thread,
+    const std::vector<double*>& out,
+    bool fast_pow = true
+)
+{
+  modell_checkRun(n_time, n_spat, n_thread);
+  int n_row_E = modell_checkForcing("atmos_potentialEvatrans_mm", atmos_potentialEvatrans_mm, n_time, n_spat);
+  int n_row_P = modell_checkForcing("atmos_precipitation_mm", atmos_precipitation_mm, n_time, n_spat);
+  modell_checkParam("S_", S_, n_spat);
+  modell_checkParam("R_", R_, n_spat);
+  modell_checkParam("X_1", X_1, n_spat);
+  modell_checkParam("X_2", X_2, n_spat);
+  modell_checkParam("X_3", X_3, n_spat);
+  modell_checkParam("X_4", X_4, n_spat);
+  modell_checkOutput(out, EDCHM_GR4J_output);
+  enum { OUT_S, OUT_Q9, OUT_Q1, OUT_Perc, OUT_Pr, OUT_AE, OUT_R, OUT_Qr, OUT_Qd, OUT_Q };
+
+  // the UHs come from the IUH cache, so they are ready before the parallel region;
+  // they are stored ragged, UH of unit j starts at off_UH[j] and is
+  // off_UH[j+1] - off_UH[j] long, so every unit convolves only over its own UH
+  IUH_ptr iuh_temp;
+  std::vector<double> UH_2, UH_1;
+  std::vector<int> off_UH_2(n_spat + 1), off_UH_1(n_spat + 1);
+  int n_UH_land = 0, n_UH_ground = 0;
+  for (int j= 0; j < n_spat; j++) {
+    iuh_temp = confluenIUH_cached(fast_pow ? IUH_GR4J2fast : IUH_GR4J2, X_4[j]);
+    UH_2.insert(UH_2.end(), iuh_temp->begin(), iuh_temp->end());
+    off_UH_2[j + 1] = UH_2.size();
+    n_UH_land = std::max(n_UH_land, (int)iuh_temp->size());
+
+    iuh_temp = confluenIUH_cached(fast_pow ? IUH_GR4J1fast : IUH_GR4J1, X_4[j]);
+    UH_1.insert(UH_1.end(), iuh_temp->begin(), iuh_temp->end());
+    off_UH_1[j + 1] = UH_1.size();
+    n_UH_ground = std::max(n_UH_ground, (int)iuh_temp->size());
+  }
+
+  // every spatial unit runs its whole time series in turn, the routing store
+  // of one unit is a ring buffer of 2 * n_UH
+#pragma omp parallel num_threads(n_thread)
+{
+  std::vector<double> ring_Pr_1(2 * n_UH_land), ring_Pr_9(2 * n_UH_ground);
+
+#pragma omp for schedule(static)
+  for (int j= 0; j < n_spat; j++) {
+
+    int n_UH_2j = off_UH_2[j + 1] - off_UH_2[j], n_UH_1j = off_UH_1[j + 1] - off_UH_1[j];
+    std::fill(ring_Pr_1.begin(), ring_Pr_1.begin() + 2 * n_UH_2j, 0.0);
+    std::fill(ring_Pr_9.begin(), ring_Pr_9.begin() + 2 * n_UH_1j, 0.0);
+    int head_1 = 0, head_9 = 0;
+
+    const double *UH_2j = UH_2.data() + off_UH_2[j], *UH_1j = UH_1.data() + off_UH_1[j];
+    const double *atmos_precipitation = atmos_precipitation_mm.data() + (std::size_t)j * n_row_P, *atmos_potentialEvatrans = atmos_potentialEvatrans_mm.data() + (std::size_t)j * n_row_E;
+    double *out_S = modell_outColumn(out, OUT_S, j, n_time), *out_Q9 = modell_outColumn(out, OUT_Q9, j, n_time), *out_Q1 = modell_outColumn(out, OUT_Q1, j, n_time);
+    double *out_Perc = modell_outColumn(out, OUT_Perc, j, n_time), *out_Pr = modell_outColumn(out, OUT_Pr, j, n_time), *out_AE = modell_outColumn(out, OUT_AE, j, n_time);
+    double *out_R = modell_outColumn(out, OUT_R, j, n_time), *out_Qr = modell_outColumn(out, OUT_Qr, j, n_time), *out_Qd = modell_outColumn(out, OUT_Qd, j, n_time), *out_Q = modell_outColumn(out, OUT_Q, j, n_time);
+    double S_j = S_[j], R_j = R_[j], X_1j = X_1[j], X_2j = X_2[j], X_3j = X_3[j];
+
+    for (int i= 0; i < n_time; i++) {
+
+      double P_ = atmos_precipitation[i];
+      double E_ = atmos_potentialEvatrans[i];
+
+      double P_n = P_ > E_ ? P_ - E_ : 0.0;
+      double E_n = P_ > E_ ? 0.0 : E_ - P_;
+      P_n = P_n > 13 * X_1j ? 13 * X_1j : P_n;
+      E_n = E_n > 13 * X_1j ? 13 * X_1j : E_n;
+      double P_s = kernel::infilt_GR4J(P_n, S_j, X_1j);
+      double E_s = kernel::evatransActual_GR4J(E_n, S_j, X_1j);
+
+      S_j += (P_s - E_s);
+
+      double Perc_ = fast_pow ? kernel::percola_GR4Jfast(S_j, X_1j) : kernel::percola_GR4J(S_j, X_1j);
+      S_j +=  - Perc_;
+
+      double P_r = (P_n - P_s + Perc_);
+      P_r = P_r < 0 ? 0 : P_r;
+
+      head_1 = kernel::confluen_ringHead(head_1, n_UH_2j);
+      head_9 = kernel::confluen_ringHead(head_9, n_UH_1j);
+      double Q_1 = kernel::confluen_ringStep(n_UH_2j, ring_Pr_1.data(), head_1, 0.1 * P_r, UH_2j);
+      double Q_9 = kernel::confluen_ringStep(n_UH_1j, ring_Pr_9.data(), head_9, 0.9 * P_r, UH_1j);
+
+      double F_ = fast_pow ? kernel::lateral_GR4Jfast(R_j, X_3j, X_2j) : kernel::lateral_GR4J(R_j, X_3j, X_2j);
+      double Q_d = (Q_1 + F_) > 0.0 ? Q_1 + F_ : 0;
+
+      R_j += (Q_9 + F_);
+      R_j = R_j > 0.0 ? R_j : 0.0;
+      double Q_r = fast_pow ? kernel::baseflow_GR4Jfast(R_j, X_3j) : kernel::baseflow_GR4J(R_j, X_3j);
+      R_j +=  - Q_r;
+
+      modell_store(out_Q, i, Q_r + Q_d);
+      modell_store(out_S, i, S_j);
+      modell_store(out_Q9, i, Q_9);
+      modell_store(out_Q1, i, Q_1);
+      modell_store(out_Perc, i, Perc_);
+      modell_store(out_Pr, i, 0.1 * P_r + 0.9 * P_r);
+      modell_store(out_AE, i, P_ > E_ ? E_ : E_s + P_);
+      modell_store(out_R, i, R_j);
+      modell_store(out_Qr, i, Q_r);
+      modell_store(out_Qd, i, Q_d);
+
+    }
+  }
+}
+}
+
+} // namespace core
+} // namespace EDCHM
+
+#endif // EDCHM_CORE_H
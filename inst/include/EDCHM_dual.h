@@ -0,0 +1,259 @@
+// Defines a header file containing the dual number of the forward-mode sensitivities
+//
+// A `dual<N>` is a value with its derivatives to N inputs (the seeded
+// parameters). The kernels, the composed steps and the routing are templated on
+// the scalar, so a model run with duals gives the stream flow and the
+// derivatives of every step to all N parameters in one pass. The value part
+// takes the same operations as the `double` run and is identical to it.
+// The branches of the kernels (limits, thresholds) compare the values, the
+// derivative is the one of the branch taken (like `ceil()`, zero at the jumps).
+// A derivative is only multiplied into the tangents that are not zero, so an
+// infinite partial (e.g. `pow(0, 0.5)`) does not turn the other ones into NaN.
+// The header is free of Rcpp.
+#ifndef EDCHM_DUAL_H
+#define EDCHM_DUAL_H
+
+#include <cmath>
+#include <limits>
+
+namespace EDCHM {
+
+template <int N>
+struct dual {
+  double v;
+  double d[N];
+
+  dual(double v_ = 0) : v(v_), d() {}
+
+  // the input k of the N
+  static dual seed(double v_, int k)
+  {
+    dual x_(v_);
+    x_.d[k] = 1;
+    return x_;
+  }
+
+  dual& operator+=(const dual& b) { v += b.v; for (int k = 0; k < N; k++) d[k] += b.d[k]; return *this; }
+  dual& operator-=(const dual& b) { v -= b.v; for (int k = 0; k < N; k++) d[k] -= b.d[k]; return *this; }
+  dual& operator*=(const dual& b) { *this = *this * b; return *this; }
+  dual& operator/=(const dual& b) { *this = *this / b; return *this; }
+};
+
+template <int N>
+inline double scalar_value(const dual<N>& a)
+{
+  return a.v;
+}
+
+// a function of `a` with the value `v` and the derivative `dv`
+template <int N>
+inline dual<N> dual_chain(const dual<N>& a, double v, double dv)
+{
+  dual<N> c_(v);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] == 0 ? 0 : dv * a.d[k];
+  return c_;
+}
+
+// arithmetic ----------
+
+template <int N>
+inline dual<N> operator-(const dual<N>& a)
+{
+  dual<N> c_(-a.v);
+  for (int k = 0; k < N; k++) c_.d[k] = -a.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator+(const dual<N>& a, const dual<N>& b)
+{
+  dual<N> c_(a.v + b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] + b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator+(const dual<N>& a, double b)
+{
+  dual<N> c_(a);
+  c_.v = a.v + b;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator+(double a, const dual<N>& b)
+{
+  dual<N> c_(b);
+  c_.v = a + b.v;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator-(const dual<N>& a, const dual<N>& b)
+{
+  dual<N> c_(a.v - b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] - b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator-(const dual<N>& a, double b)
+{
+  dual<N> c_(a);
+  c_.v = a.v - b;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator-(double a, const dual<N>& b)
+{
+  dual<N> c_(a - b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = -b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator*(const dual<N>& a, const dual<N>& b)
+{
+  dual<N> c_(a.v * b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] * b.v + a.v * b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator*(const dual<N>& a, double b)
+{
+  dual<N> c_(a.v * b);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] * b;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator*(double a, const dual<N>& b)
+{
+  dual<N> c_(a * b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = a * b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator/(const dual<N>& a, const dual<N>& b)
+{
+  dual<N> c_(a.v / b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = (a.d[k] - c_.v * b.d[k]) / b.v;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator/(const dual<N>& a, double b)
+{
+  dual<N> c_(a.v / b);
+  for (int k = 0; k < N; k++) c_.d[k] = a.d[k] / b;
+  return c_;
+}
+
+template <int N>
+inline dual<N> operator/(double a, const dual<N>& b)
+{
+  dual<N> c_(a / b.v);
+  for (int k = 0; k < N; k++) c_.d[k] = - c_.v * b.d[k] / b.v;
+  return c_;
+}
+
+// comparison of the values ----------
+
+template <int N> inline bool operator<(const dual<N>& a, const dual<N>& b) { return a.v < b.v; }
+template <int N> inline bool operator<(const dual<N>& a, double b) { return a.v < b; }
+template <int N> inline bool operator<(double a, const dual<N>& b) { return a < b.v; }
+template <int N> inline bool operator>(const dual<N>& a, const dual<N>& b) { return a.v > b.v; }
+template <int N> inline bool operator>(const dual<N>& a, double b) { return a.v > b; }
+template <int N> inline bool operator>(double a, const dual<N>& b) { return a > b.v; }
+template <int N> inline bool operator<=(const dual<N>& a, const dual<N>& b) { return a.v <= b.v; }
+template <int N> inline bool operator<=(const dual<N>& a, double b) { return a.v <= b; }
+template <int N> inline bool operator<=(double a, const dual<N>& b) { return a <= b.v; }
+template <int N> inline bool operator>=(const dual<N>& a, const dual<N>& b) { return a.v >= b.v; }
+template <int N> inline bool operator>=(const dual<N>& a, double b) { return a.v >= b; }
+template <int N> inline bool operator>=(double a, const dual<N>& b) { return a >= b.v; }
+template <int N> inline bool operator==(const dual<N>& a, const dual<N>& b) { return a.v == b.v; }
+template <int N> inline bool operator==(const dual<N>& a, double b) { return a.v == b; }
+template <int N> inline bool operator==(double a, const dual<N>& b) { return a == b.v; }
+template <int N> inline bool operator!=(const dual<N>& a, const dual<N>& b) { return a.v != b.v; }
+template <int N> inline bool operator!=(const dual<N>& a, double b) { return a.v != b; }
+template <int N> inline bool operator!=(double a, const dual<N>& b) { return a != b.v; }
+
+// math ----------
+
+template <int N>
+inline dual<N> pow(const dual<N>& a, double b)
+{
+  return dual_chain(a, std::pow(a.v, b), b * std::pow(a.v, b - 1));
+}
+
+template <int N>
+inline dual<N> pow(double a, const dual<N>& b)
+{
+  double v_ = std::pow(a, b.v);
+  return dual_chain(b, v_, v_ * std::log(a));
+}
+
+template <int N>
+inline dual<N> pow(const dual<N>& a, const dual<N>& b)
+{
+  double v_ = std::pow(a.v, b.v);
+  dual<N> c_ = dual_chain(a, v_, b.v * std::pow(a.v, b.v - 1));
+  dual<N> c_b = dual_chain(b, v_, v_ * std::log(a.v));
+  for (int k = 0; k < N; k++) c_.d[k] += c_b.d[k];
+  return c_;
+}
+
+template <int N>
+inline dual<N> exp(const dual<N>& a)
+{
+  double v_ = std::exp(a.v);
+  return dual_chain(a, v_, v_);
+}
+
+template <int N>
+inline dual<N> log(const dual<N>& a)
+{
+  return dual_chain(a, std::log(a.v), 1 / a.v);
+}
+
+template <int N>
+inline dual<N> sqrt(const dual<N>& a)
+{
+  double v_ = std::sqrt(a.v);
+  return dual_chain(a, v_, 0.5 / v_);
+}
+
+// x^3.5 of the GR4J kernels, the derivative 3.5 x^2.5 instead of the product
+// rule over sqrt(x) (infinite at 0)
+template <int N>
+inline dual<N> pow3_5(const dual<N>& a)
+{
+  double r_ = std::sqrt(a.v);
+  return dual_chain(a, a.v * a.v * a.v * r_, 3.5 * a.v * a.v * r_);
+}
+
+template <int N>
+inline dual<N> tanh(const dual<N>& a)
+{
+  double v_ = std::tanh(a.v);
+  return dual_chain(a, v_, 1 - v_ * v_);
+}
+
+template <int N>
+inline dual<N> fabs(const dual<N>& a)
+{
+  return a.v < 0 ? -a : a;
+}
+
+template <int N>
+inline dual<N> ceil(const dual<N>& a)
+{
+  return dual<N>(std::ceil(a.v));
+}
+
+} // namespace EDCHM
+
+#endif // EDCHM_DUAL_H
@@ -0,0 +1,801 @@
+// Defines a header file for the model engine on plain arrays
+//
+// The engine runs a model of the EDCHM-standard-structure from the names of its
+// process methods, without compiling it: every process becomes a stage, a pointer
+// to the step of the process slot from EDCHM_compose.h, and one step of a spatial
+// unit calls the stages in the order of the standard structure over the same
+// `compose::cell` as the composed models. `EDCHM_engine()` is a thin wrapper
+// around it, the calibration (EDCHM_cali.h) runs it once per candidate.
+// - `core::engine` resolves the stages once, it names the inputs it needs in
+//   `boundary_name()` and `param_name()`
+// - a boundary matrix is column major, n_row x n_spat with n_row >= n_time
+// - a parameter has one value per spatial unit or one value for all units
+// - `out` has one pointer per variable of `engine_output`, nullptr when it is not asked
+// - `outlet`, when it is given, gets the sum of the stream flow of all units
+//   weighted by `weight`, the partial sums of the unit blocks are added in a
+//   fixed order, so the outlet is the same for every number of threads
+// - `check`, when it is given, sees the outlet while the model runs and can
+//   stop the run early, e.g. when a calibration candidate is already worse
+//   than the best; the steps that did run are the same as in a full run
+// - `cache`, when it is given, keeps the series the stages pass on to each
+//   other: the stages are grouped by their dependencies (e.g. the snow stages
+//   only depend on the forcing and the snow parameters), a group whose inputs
+//   and upstream groups did not change replays its series instead of running,
+//   and when no group changed (e.g. a calibration candidate of
+//   `confluenLand_responseTime_TS`) only the convolution is redone; the stream
+//   flow is the same as the one of a full run
+// - a `single` engine runs the stages on the cell of `float` and routes with
+//   `float` IUHs and rings; the routing sums, the stream flow, the outlet and
+//   the cached series stay `double`, so the outlet keeps the volume of the
+//   runoff and baseflow
+// Wrong inputs throw `std::invalid_argument`, which Rcpp turns into an R error.
+// The header is free of Rcpp.
+#ifndef EDCHM_ENGINE_H
+#define EDCHM_ENGINE_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "EDCHM_core.h"
+
+namespace EDCHM {
+namespace core {
+
+// the step of a stage on the cell of the scalar T, `double` or `float` (`single`)
+template <class T>
+using engine_step = void (*)(compose::basic_cell<T>&, const compose::basic_param<T>&);
+
+struct engine_stage {
+  const char* process;
+  const char* method;
+  engine_step<double> step;
+  engine_step<float> step_single;
+  const char* input; // names of the inputs, separated by space
+};
+
+template <class Slot>
+constexpr engine_stage engine_stageOf(const char* process, const char* method, const char* input)
+{
+  return {process, method, Slot::template step<double>, Slot::template step<float>, input};
+}
+
+inline const engine_stage engine_stages[] = {
+  engine_stageOf<compose::atmosSnow<compose::atmosSnow_ThresholdT>>("atmosSnow", "atmosSnow_ThresholdT", "atmos_temperature_Cel param_atmos_thr_Ts"),
+  engine_stageOf<compose::evatransSoil<compose::evatransActual_UBC>>("evatransSoil", "evatransActual_UBC", "atmos_potentialEvatrans_mm soil_water_mm soil_capacity_mm param_evatrans_ubc_gamma"),
+  engine_stageOf<compose::evatransSoil<compose::evatransActual_GR4J>>("evatransSoil", "evatransActual_GR4J", "atmos_potentialEvatrans_mm soil_water_mm soil_capacity_mm"),
+  engine_stageOf<compose::snowMelt<compose::snowMelt_Factor>>("snowMelt", "snowMelt_Factor", "snow_ice_mm atmos_temperature_Cel param_snow_fac_f param_snow_fac_Tmelt"),
+  engine_stageOf<compose::infilt<compose::infilt_UBC>>("infilt", "infilt_UBC", "land_impermeableFrac_1 soil_water_mm soil_capacity_mm param_infilt_ubc_P0AGEN"),
+  engine_stageOf<compose::infilt<compose::infilt_GR4J>>("infilt", "infilt_GR4J", "soil_water_mm soil_capacity_mm"),
+  engine_stageOf<compose::percola<compose::percola_Arno>>("percola", "percola_Arno", "soil_water_mm soil_capacity_mm soil_potentialPercola_mm param_percola_arn_thresh param_percola_arn_k ground_water_mm"),
+  engine_stageOf<compose::percola<compose::percola_GR4J>>("percola", "percola_GR4J", "soil_water_mm soil_capacity_mm ground_water_mm"),
+  engine_stageOf<compose::baseflow<compose::baseflow_GR4J>>("baseflow", "baseflow_GR4J", "ground_water_mm ground_capacity_mm"),
+  engine_stageOf<compose::baseflow<compose::baseflow_GR4Jfix>>("baseflow", "baseflow_GR4Jfix", "ground_water_mm ground_capacity_mm param_baseflow_grf_gamma"),
+  engine_stageOf<compose::lateral<compose::lateral_GR4J>>("lateral", "lateral_GR4J", "ground_water_mm ground_capacity_mm ground_potentialLateral_mm")
+};
+
+// order of the processes in the standard structure (see build_modell())
+inline const char* const engine_order[] = {
+  "atmosSnow", "evatransPotential", "evatransLand", "evatransSoil", "intercep", "snowMelt",
+  "infilt", "percola", "inteflow", "capirise", "baseflow", "lateral"
+};
+
+struct engine_iuh {
+  const char* method;
+  confluenIUH_method iuh;
+  const char* param; // name of the shape parameter after `param_confluenXxx_`, "" without
+};
+
+inline const engine_iuh engine_iuhs[] = {
+  {"confluenIUH_GR4J1", IUH_GR4J1, ""},
+  {"confluenIUH_GR4J2", IUH_GR4J2, ""},
+  {"confluenIUH_Kelly", IUH_Kelly, "kel_k"},
+  {"confluenIUH_Nash", IUH_Nash, "nas_n"},
+  {"confluenIUH_Clark", IUH_Clark, ""}
+};
+
+// The fields of the cell and param of a spatial unit. The engine keeps the
+// index of a field in these tables, so the same model can run on the cell of
+// `double` and of `float`.
+template <class T>
+inline const std::pair<const char*, T compose::basic_cell<T>::*> engine_cell[] = {
+  {"atmos_precipitation_mm", &compose::basic_cell<T>::atmos_precipitation_mm},
+  {"atmos_potentialEvatrans_mm", &compose::basic_cell<T>::atmos_potentialEvatrans_mm},
+  {"atmos_temperature_Cel", &compose::basic_cell<T>::atmos_temperature_Cel},
+  {"snow_ice_mm", &compose::basic_cell<T>::snow_ice_mm},
+  {"soil_water_mm", &compose::basic_cell<T>::soil_water_mm},
+  {"ground_water_mm", &compose::basic_cell<T>::ground_water_mm},
+  {"atmos_snow_mm", &compose::basic_cell<T>::atmos_snow_mm},
+  {"snow_melt_mm", &compose::basic_cell<T>::snow_melt_mm},
+  {"land_water_mm", &compose::basic_cell<T>::land_water_mm},
+  {"soil_evatrans_mm", &compose::basic_cell<T>::soil_evatrans_mm},
+  {"soil_infilt_mm", &compose::basic_cell<T>::soil_infilt_mm},
+  {"land_runoff_mm", &compose::basic_cell<T>::land_runoff_mm},
+  {"soil_percolation_mm", &compose::basic_cell<T>::soil_percolation_mm},
+  {"ground_baseflow_mm", &compose::basic_cell<T>::ground_baseflow_mm},
+  {"ground_lateral_mm", &compose::basic_cell<T>::ground_lateral_mm}
+};
+
+template <class T>
+inline const std::pair<const char*, T compose::basic_param<T>::*> engine_param[] = {
+  {"land_impermeableFrac_1", &compose::basic_param<T>::land_impermeableFrac_1},
+  {"soil_capacity_mm", &compose::basic_param<T>::soil_capacity_mm},
+  {"soil_potentialPercola_mm", &compose::basic_param<T>::soil_potentialPercola_mm},
+  {"ground_capacity_mm", &compose::basic_param<T>::ground_capacity_mm},
+  {"ground_potentialLateral_mm", &compose::basic_param<T>::ground_potentialLateral_mm},
+  {"param_atmos_thr_Ts", &compose::basic_param<T>::param_atmos_thr_Ts},
+  {"param_snow_fac_f", &compose::basic_param<T>::param_snow_fac_f},
+  {"param_snow_fac_Tmelt", &compose::basic_param<T>::param_snow_fac_Tmelt},
+  {"param_evatrans_ubc_gamma", &compose::basic_param<T>::param_evatrans_ubc_gamma},
+  {"param_infilt_ubc_P0AGEN", &compose::basic_param<T>::param_infilt_ubc_P0AGEN},
+  {"param_percola_arn_thresh", &compose::basic_param<T>::param_percola_arn_thresh},
+  {"param_percola_arn_k", &compose::basic_param<T>::param_percola_arn_k},
+  {"param_baseflow_grf_gamma", &compose::basic_param<T>::param_baseflow_grf_gamma}
+};
+
+// where an input goes in the cell of a spatial unit
+inline const char* const engine_boundary[] = {
+  "atmos_precipitation_mm", "atmos_potentialEvatrans_mm", "atmos_temperature_Cel", "atmos_snow_mm"
+};
+
+inline const char* const engine_state[] = {
+  "snow_ice_mm", "soil_water_mm", "ground_water_mm"
+};
+
+// index of a field in `engine_cell` or `engine_param`, -1 when there is none
+template <class Table>
+inline int engine_field(const Table& table, const std::string& name)
+{
+  for (std::size_t f = 0; f < std::size(table); f++) if (name == table[f].first) return f;
+  return -1;
+}
+
+inline bool engine_has(const char* const* begin, const char* const* end, const std::string& name)
+{
+  return std::any_of(begin, end, [&](const char* n) { return name == n; });
+}
+
+// the fields of the cell a process slot of EDCHM_compose.h reads and writes,
+// separated by space, they give the dependencies between the stages
+struct engine_slot {
+  const char* process;
+  const char* read;
+  const char* write;
+};
+
+inline const engine_slot engine_slots[] = {
+  {"atmosSnow", "atmos_precipitation_mm atmos_temperature_Cel", "atmos_snow_mm atmos_precipitation_mm land_water_mm"},
+  {"snowMelt", "snow_ice_mm atmos_temperature_Cel atmos_snow_mm land_water_mm", "snow_melt_mm land_water_mm snow_ice_mm"},
+  {"evatransSoil", "atmos_potentialEvatrans_mm soil_water_mm", "soil_evatrans_mm soil_water_mm"},
+  {"infilt", "land_water_mm soil_water_mm", "soil_infilt_mm soil_water_mm land_runoff_mm"},
+  {"percola", "soil_water_mm ground_water_mm", "soil_percolation_mm ground_water_mm soil_water_mm"},
+  {"baseflow", "ground_water_mm", "ground_water_mm ground_baseflow_mm"},
+  {"lateral", "ground_water_mm", "ground_lateral_mm ground_water_mm"}
+};
+
+// output variables, the index in the list is the index in `out`
+inline const std::vector<std::string> engine_output = {
+  "evatrans_mm", "soilwater_mm", "groundwater_mm", "runoff_mm", "baseflow_mm", "streamflow_mm", "snowice_mm", "snowmelt_mm", "lateral_mm"
+};
+
+// the outlet is summed in at most `engine_nBlock` blocks of spatial units
+const int engine_nBlock = 64;
+
+// a run with `check` is checked every `engine_nChunk` steps
+const int engine_nChunk = 128;
+
+// `check(i_end)` is called when the outlet before step i_end is complete,
+// the run stops when it returns false
+typedef std::function<bool(int)> engine_check;
+
+// one parameter, read as value of spatial unit j (length n_spat) or of all units (length 1)
+struct engine_vector {
+  const double* value;
+  std::size_t n_value;
+  double operator[](int j) const { return n_value == 1 ? value[0] : value[j]; }
+};
+
+inline engine_vector engine_getVector(const std::string& name, view<const double> x, int n_spat)
+{
+  if (x.size() != 1 && x.size() != (std::size_t)n_spat) throw std::invalid_argument("`param$" + name + "` must have length 1 or `n_spat`.");
+  return engine_vector{x.data(), x.size()};
+}
+
+// memory budget of an `engine_cache` by default
+const std::size_t engine_cacheByte = (std::size_t)256 << 20;
+
+// The series the stage groups of an engine pass on (n_time x n_spat, column
+// major), from the complete runs with the stream flow as the only output. The
+// key of a group is made of the bytes of the engine, the size, the boundary (by
+// address, a boundary must not change while the cache is used), the values of
+// the states and parameters the group reads and the keys of its upstream
+// groups; it is found by its hash and confirmed byte by byte. When the budget is
+// full the least recently used entries are dropped, a run that was stopped by
+// `check` is not kept. One cache belongs to one caller (e.g. one calibration
+// chain), it is not shared between threads.
+class engine_cache {
+public:
+  explicit engine_cache(std::size_t n_byte_max = engine_cacheByte) : n_byte_max_(n_byte_max) {}
+
+  // numbers of stage groups that were replayed or had to run
+  long n_hit() const { return n_hit_; }
+  long n_miss() const { return n_miss_; }
+  // bytes of the kept series
+  std::size_t n_byte() const { return n_byte_; }
+
+private:
+  friend class engine;
+
+  struct entry {
+    bool valid = false;
+    std::size_t hash = 0;
+    std::string key;
+    unsigned long used = 0;
+    std::vector<double> series;
+  };
+
+  // the entries found or added after `run_begin()` are not dropped in the run
+  void run_begin() { used_run_ = used_; }
+
+  // the valid entry of `key`, nullptr when there is none
+  const entry* find(const std::string& key)
+  {
+    std::size_t hash_ = std::hash<std::string>()(key);
+    for (entry& e : entry_) {
+      if (e.valid && e.hash == hash_ && e.key == key) {
+        e.used = ++used_;
+        n_hit_++;
+        return &e;
+      }
+    }
+    n_miss_++;
+    return nullptr;
+  }
+
+  // a new entry of `key` with `n_value` values, valid after `keep()`;
+  // nullptr when it does not fit in the budget. The memory of a dropped entry
+  // is used again, a calibration drops and adds an entry of the same size at
+  // almost every run.
+  entry* add(const std::string& key, std::size_t n_value)
+  {
+    std::size_t n_byte_new = n_value * sizeof(double) + key.size();
+    while (n_byte_ + n_byte_new > n_byte_max_) {
+      std::list<entry>::iterator old_ = entry_.end();
+      for (std::list<entry>::iterator e = entry_.begin(); e != entry_.end(); e++) {
+        if (e->used <= used_run_ && (old_ == entry_.end() || e->used < old_->used)) old_ = e;
+      }
+      if (old_ == entry_.end()) return nullptr;
+      drop(&*old_);
+    }
+    entry_.emplace_back();
+    entry& e = entry_.back();
+    e.hash = std::hash<std::string>()(key);
+    e.key = key;
+    e.used = ++used_;
+    if (spare_.size() == n_value) e.series.swap(spare_);
+    else e.series.resize(n_value);
+    n_byte_ += n_byte_new;
+    return &e;
+  }
+
+  void keep(entry* e) { e->valid = true; }
+
+  void drop(const entry* e)
+  {
+    for (std::list<entry>::iterator it = entry_.begin(); it != entry_.end(); it++) {
+      if (&*it != e) continue;
+      n_byte_ -= it->series.size() * sizeof(double) + it->key.size();
+      it->series.swap(spare_);
+      entry_.erase(it);
+      return;
+    }
+  }
+
+  std::list<entry> entry_;
+  std::vector<double> spare_;
+  std::size_t n_byte_max_, n_byte_ = 0;
+  unsigned long used_ = 0, used_run_ = 0;
+  long n_hit_ = 0, n_miss_ = 0;
+};
+
+class engine {
+public:
+  // `process` and `method` are the names and values of `process_method`,
+  // `single` runs the stages and the routing in `float`
+  engine(const std::vector<std::string>& process, const std::vector<std::string>& method, bool single = false)
+    : single_(single)
+  {
+    // stages in the order of the standard structure ----------
+    std::vector<const engine_stage*> stage_;
+    std::vector<std::string> input_name = {"atmos_precipitation_mm"};
+    bool has_atmosSnow = false, has_snowMelt = false;
+    for (std::size_t k = 0; k < process.size(); k++) {
+      const std::string &process_k = process[k], &method_k = method[k];
+      if (method_k == "NULL") continue;
+      if (process_k == "confluenLand" || process_k == "confluenGround") {
+        iuh_method_[process_k == "confluenLand" ? 0 : 1] = method_k;
+        continue;
+      }
+      const engine_stage* stage_k = nullptr;
+      for (const engine_stage& s : engine_stages) {
+        if (process_k == s.process && method_k == s.method) stage_k = &s;
+      }
+      if (!stage_k) throw std::invalid_argument("`" + process_k + " = " + method_k + "` is not supported by `EDCHM_engine()`, please use `build_modell()`.");
+      has_atmosSnow |= process_k == "atmosSnow";
+      has_snowMelt |= process_k == "snowMelt";
+      stage_.push_back(stage_k);
+      std::istringstream input_k(stage_k->input);
+      for (std::string name_; input_k >> name_;) input_name.push_back(name_);
+    }
+    if (has_snowMelt && !has_atmosSnow) input_name.push_back("atmos_snow_mm");
+    std::stable_sort(stage_.begin(), stage_.end(), [](const engine_stage* a, const engine_stage* b) {
+      auto order_ = [](const char* process) {
+        return std::find_if(std::begin(engine_order), std::end(engine_order), [&](const char* o) { return std::string(o) == process; }) - std::begin(engine_order);
+      };
+      return order_(a->process) < order_(b->process);
+    });
+    for (const engine_stage* s : stage_) {
+      step_.push_back(s->step);
+      step_single_.push_back(s->step_single);
+    }
+    std::sort(input_name.begin(), input_name.end());
+    input_name.erase(std::unique(input_name.begin(), input_name.end()), input_name.end());
+
+    // inputs, resolved once by name ----------
+    for (const std::string& name_ : input_name) {
+      if (engine_has(std::begin(engine_boundary), std::end(engine_boundary), name_)) {
+        boundary_name_.push_back(name_);
+        boundary_field_.push_back(engine_field(engine_cell<double>, name_));
+      } else if (engine_has(std::begin(engine_state), std::end(engine_state), name_)) {
+        param_name_.push_back(name_);
+        state_field_.push_back(engine_field(engine_cell<double>, name_));
+      } else if (engine_field(engine_param<double>, name_) >= 0) {
+        param_name_.push_back(name_);
+        param_field_.push_back(engine_field(engine_param<double>, name_));
+      } else {
+        throw std::invalid_argument("unknown input `" + name_ + "`.");
+      }
+    }
+    // the states come first in `param_name()`, then the parameters
+    std::stable_partition(param_name_.begin(), param_name_.end(), [](const std::string& name_) {
+      return engine_has(std::begin(engine_state), std::end(engine_state), name_);
+    });
+
+    // IUH parameters, after the parameters of the stages ----------
+    const char* confluen_name[2] = {"confluenLand", "confluenGround"};
+    for (int s = 0; s < 2; s++) {
+      if (iuh_method_[s].empty()) throw std::invalid_argument(std::string("`") + confluen_name[s] + "` can not be `NULL` in `EDCHM_engine()`.");
+      const engine_iuh* iuh_s = nullptr;
+      for (const engine_iuh& m : engine_iuhs) if (iuh_method_[s] == m.method) iuh_s = &m;
+      if (!iuh_s) throw std::invalid_argument(std::string("`") + confluen_name[s] + " = " + iuh_method_[s] + "` is not supported by `EDCHM_engine()`.");
+      iuh_[s] = iuh_s->iuh;
+      param_name_.push_back(std::string(confluen_name[s]) + "_responseTime_TS");
+      has_shape_[s] = iuh_s->param[0] != '\0';
+      if (has_shape_[s]) param_name_.push_back(std::string("param_") + confluen_name[s] + "_" + iuh_s->param);
+    }
+
+    memo_build(stage_);
+  }
+
+  // names of the boundary matrices, in the order of `boundary` in `run()`
+  const std::vector<std::string>& boundary_name() const { return boundary_name_; }
+  // names of the states, parameters and IUH parameters, in the order of `param` in `run()`
+  const std::vector<std::string>& param_name() const { return param_name_; }
+  bool single() const { return single_; }
+
+  // returns the number of steps run, `n_time` or the step at which `check` stopped the run
+  int run(
+      int n_time,
+      int n_spat,
+      const std::vector<view<const double>>& boundary,
+      const std::vector<view<const double>>& param,
+      int n_thread,
+      const std::vector<double*>& out,
+      double* outlet = nullptr,
+      view<const double> weight = view<const double>(),
+      const engine_check& check = engine_check(),
+      engine_cache* cache = nullptr
+  ) const
+  {
+    if (single_) return run_scalar<float>(n_time, n_spat, boundary, param, n_thread, out, outlet, weight, check, cache);
+    return run_scalar<double>(n_time, n_spat, boundary, param, n_thread, out, outlet, weight, check, cache);
+  }
+
+private:
+  // `run()` on the cell of T: the states, fluxes and routing rings of the units
+  // are T, the stream flow, the outlet and the cached series are `double`
+  template <class T>
+  int run_scalar(
+      int n_time,
+      int n_spat,
+      const std::vector<view<const double>>& boundary,
+      const std::vector<view<const double>>& param,
+      int n_thread,
+      const std::vector<double*>& out,
+      double* outlet,
+      view<const double> weight,
+      const engine_check& check,
+      engine_cache* cache
+  ) const
+  {
+    typedef compose::basic_cell<T> cell_T;
+    typedef compose::basic_param<T> param_T;
+    modell_checkRun(n_time, n_spat, n_thread);
+    if (boundary.size() != boundary_name_.size() || param.size() != param_name_.size()) {
+      throw std::invalid_argument("`boundary` and `param` must have one input for every name of the engine.");
+    }
+    std::vector<int> n_row_boundary;
+    for (std::size_t b = 0; b < boundary.size(); b++) n_row_boundary.push_back(modell_checkForcing(boundary_name_[b].c_str(), boundary[b], n_time, n_spat));
+    std::vector<engine_vector> param_;
+    for (std::size_t k = 0; k < param.size(); k++) param_.push_back(engine_getVector(param_name_[k], param[k], n_spat));
+    modell_checkOutput(out, engine_output);
+    engine_vector weight_ = {nullptr, 0};
+    if (outlet) {
+      if (weight.size() != 1 && weight.size() != (std::size_t)n_spat) throw std::invalid_argument("`weight` must have length 1 or `n_spat`.");
+      weight_ = engine_vector{weight.data(), weight.size()};
+    }
+    if (check && !outlet) throw std::invalid_argument("`check` needs the `outlet`.");
+    enum { OUT_evatrans, OUT_soilwater, OUT_groundwater, OUT_runoff, OUT_baseflow, OUT_streamflow, OUT_snowice, OUT_snowmelt, OUT_lateral };
+
+    // the fields and steps of the cell of T ----------
+    std::vector<T cell_T::*> boundary_member, state_member;
+    std::vector<T param_T::*> param_member;
+    std::vector<std::vector<T cell_T::*>> series_member(memo_series_.size());
+    for (int f : boundary_field_) boundary_member.push_back(engine_cell<T>[f].second);
+    for (int f : state_field_) state_member.push_back(engine_cell<T>[f].second);
+    for (int f : param_field_) param_member.push_back(engine_param<T>[f].second);
+    for (std::size_t k = 0; k < memo_series_.size(); k++) for (int f : memo_series_[k]) series_member[k].push_back(engine_cell<T>[f].second);
+    const std::vector<engine_step<T>>* step_T;
+    if constexpr (std::is_same<T, float>::value) step_T = &step_single_;
+    else step_T = &step_;
+
+    // IUHs from the IUH cache, before the parallel region ----------
+    std::size_t n_state = state_member.size(), n_param = param_member.size();
+    std::vector<IUH_ptr> iuh_unit[2];
+    std::vector<const T*> iuh_data[2];
+    std::map<const std::vector<double>*, std::vector<T>> iuh_single;
+    int n_iuh_max[2] = {0, 0};
+    for (int s = 0, k = n_state + n_param; s < 2; s++) {
+      const engine_vector &responseTime_ = param_[k++], *shape_ = has_shape_[s] ? &param_[k++] : nullptr;
+      for (int j= 0; j < n_spat; j++) {
+        iuh_unit[s].push_back(confluenIUH_cached(iuh_[s], responseTime_[j], shape_ ? (*shape_)[j] : 0.0));
+        n_iuh_max[s] = std::max(n_iuh_max[s], std::min((int)iuh_unit[s][j]->size(), n_time));
+        if constexpr (std::is_same<T, double>::value) {
+          iuh_data[s].push_back(iuh_unit[s][j]->data());
+        } else {
+          // the units of one IUH share its copy
+          std::vector<T>& iuh_T = iuh_single[iuh_unit[s][j].get()];
+          if (iuh_T.empty()) iuh_T.assign(iuh_unit[s][j]->begin(), iuh_unit[s][j]->end());
+          iuh_data[s].push_back(iuh_T.data());
+        }
+      }
+    }
+
+    // the series of the stage groups from the cache, or into it while they run ----------
+    std::size_t n_stage = step_T->size(), n_value = (std::size_t)n_time * n_spat;
+    std::vector<const double*> replay_(n_stage, nullptr);
+    std::vector<double*> fill_(n_stage, nullptr);
+    std::vector<engine_cache::entry*> filled_;
+    const double* route_[2] = {nullptr, nullptr};
+    bool memo_ = cache && std::none_of(out.begin(), out.end(), [&](double* o) { return o && o != out[OUT_streamflow]; });
+    bool route_only = false;
+    if (memo_) {
+      cache->run_begin();
+      std::vector<std::string> key_(memo_nNode_);
+      std::function<const std::string&(int)> node_key = [&](int g) -> const std::string& {
+        if (key_[g].empty()) key_[g] = memo_key(g, n_time, n_spat, boundary, param, node_key);
+        return key_[g];
+      };
+      std::vector<const double*> node_series(memo_nNode_, nullptr);
+      route_only = true;
+      for (int g = 0; g < memo_nNode_; g++) {
+        const engine_cache::entry* found_ = cache->find(node_key(g));
+        if (found_) {
+          node_series[g] = found_->series.data();
+          continue;
+        }
+        route_only = false;
+        engine_cache::entry* added_ = cache->add(node_key(g), memo_nSeries_[g] * n_value);
+        if (!added_) continue;
+        filled_.push_back(added_);
+        for (std::size_t k = 0; k < n_stage; k++) if (memo_node_[k] == g) fill_[k] = added_->series.data() + memo_offset_[k] * n_value;
+      }
+      for (std::size_t k = 0; k < n_stage; k++) if (node_series[memo_node_[k]]) replay_[k] = node_series[memo_node_[k]] + memo_offset_[k] * n_value;
+      for (int r = 0; r < 2; r++) if (memo_route_[r] >= 0) route_[r] = replay_[memo_route_[r]] + memo_routeSeries_[r] * n_value;
+    }
+    auto memo_end = [&](bool complete) {
+      for (engine_cache::entry* e : filled_) {
+        if (complete) cache->keep(e);
+        else cache->drop(e);
+      }
+    };
+
+    // the units run in blocks, a block adds its units to its own part of the outlet
+    int n_block = std::min(n_spat, engine_nBlock);
+    std::vector<double> outlet_block(outlet ? (std::size_t)n_block * n_time : 0, 0.0);
+
+    auto unit_begin = [&](int j, cell_T& c_, param_T& p_) {
+      for (std::size_t s = 0; s < n_state; s++) c_.*(state_member[s]) = param_[s][j];
+      for (std::size_t p = 0; p < n_param; p++) p_.*(param_member[p]) = param_[n_state + p][j];
+    };
+
+    // steps i_0 <= i < i_1 of spatial unit j
+    auto unit_run = [&](int j, int i_0, int i_1, cell_T& c_, const param_T& p_,
+                        kernel::confluen_IUHStream<T>& confluenLand, kernel::confluen_IUHStream<T>& confluenGround, double* outlet_b) {
+      double *out_evatrans = modell_outColumn(out, OUT_evatrans, j, n_time), *out_soilwater = modell_outColumn(out, OUT_soilwater, j, n_time), *out_groundwater = modell_outColumn(out, OUT_groundwater, j, n_time);
+      double *out_runoff = modell_outColumn(out, OUT_runoff, j, n_time), *out_baseflow = modell_outColumn(out, OUT_baseflow, j, n_time), *out_streamflow = modell_outColumn(out, OUT_streamflow, j, n_time);
+      double *out_snowice = modell_outColumn(out, OUT_snowice, j, n_time), *out_snowmelt = modell_outColumn(out, OUT_snowmelt, j, n_time), *out_lateral = modell_outColumn(out, OUT_lateral, j, n_time);
+      double weight_j = outlet_b ? weight_[j] : 0.0;
+
+      if (route_only) {
+        // only the routing of the cached runoff and baseflow
+        const double *runoff_j = route_[0] ? route_[0] + (std::size_t)j * n_time : nullptr, *baseflow_j = route_[1] ? route_[1] + (std::size_t)j * n_time : nullptr;
+        for (int i= i_0; i < i_1; i++) {
+          double streamflow_ = confluenLand.step(runoff_j ? runoff_j[i] : 0.0) + confluenGround.step(baseflow_j ? baseflow_j[i] : 0.0);
+          modell_store(out_streamflow, i, streamflow_);
+          if (outlet_b) outlet_b[i] += weight_j * streamflow_;
+        }
+        return;
+      }
+
+      for (int i= i_0; i < i_1; i++) {
+
+        for (std::size_t k = 0; k < boundary_member.size(); k++) c_.*(boundary_member[k]) = boundary[k][(std::size_t)j * n_row_boundary[k] + i];
+        compose::modell_begin(c_);
+        if (!memo_) {
+          for (engine_step<T> step : *step_T) step(c_, p_);
+        } else {
+          // a stage of an unchanged group only sets the fields it passes on
+          std::size_t at_ = (std::size_t)j * n_time + i;
+          for (std::size_t k = 0; k < n_stage; k++) {
+            const std::vector<T cell_T::*>& series_k = series_member[k];
+            if (replay_[k]) {
+              for (std::size_t f = 0; f < series_k.size(); f++) c_.*(series_k[f]) = replay_[k][f * n_value + at_];
+              continue;
+            }
+            (*step_T)[k](c_, p_);
+            if (fill_[k]) for (std::size_t f = 0; f < series_k.size(); f++) fill_[k][f * n_value + at_] = c_.*(series_k[f]);
+          }
+        }
+
+        if (out_streamflow || outlet_b) {
+          double streamflow_ = confluenLand.step(c_.land_runoff_mm) + confluenGround.step(c_.ground_baseflow_mm);
+          modell_store(out_streamflow, i, streamflow_);
+          if (outlet_b) outlet_b[i] += weight_j * streamflow_;
+        }
+        modell_store(out_evatrans, i, c_.soil_evatrans_mm);
+        modell_store(out_soilwater, i, c_.soil_water_mm);
+        modell_store(out_groundwater, i, c_.ground_water_mm);
+        modell_store(out_runoff, i, c_.land_runoff_mm);
+        modell_store(out_baseflow, i, c_.ground_baseflow_mm);
+        modell_store(out_snowice, i, c_.snow_ice_mm);
+        modell_store(out_snowmelt, i, c_.snow_melt_mm);
+        modell_store(out_lateral, i, c_.ground_lateral_mm);
+
+      }
+    };
+
+    auto outlet_sum = [&](int i_0, int i_1) {
+      std::fill(outlet + i_0, outlet + i_1, 0.0);
+      for (int b = 0; b < n_block; b++) {
+        for (int i= i_0; i < i_1; i++) outlet[i] += outlet_block[(std::size_t)b * n_time + i];
+      }
+    };
+
+    if (!check) {
+      // every spatial unit runs its whole time series in turn
+#pragma omp parallel num_threads(n_thread)
+{
+      std::vector<T> confluenLand_ring(2 * n_iuh_max[0]), confluenGround_ring(2 * n_iuh_max[1]);
+
+#pragma omp for schedule(static)
+      for (int b = 0; b < n_block; b++) {
+        double* outlet_b = outlet ? outlet_block.data() + (std::size_t)b * n_time : nullptr;
+        for (int j = (long)b * n_spat / n_block; j < (long)(b + 1) * n_spat / n_block; j++) {
+          cell_T c_;
+          param_T p_;
+          unit_begin(j, c_, p_);
+          kernel::confluen_IUHStream<T> confluenLand(std::min((int)iuh_unit[0][j]->size(), n_time), iuh_data[0][j], confluenLand_ring.data());
+          kernel::confluen_IUHStream<T> confluenGround(std::min((int)iuh_unit[1][j]->size(), n_time), iuh_data[1][j], confluenGround_ring.data());
+          unit_run(j, 0, n_time, c_, p_, confluenLand, confluenGround, outlet_b);
+        }
+      }
+}
+      if (outlet) outlet_sum(0, n_time);
+      memo_end(true);
+      return n_time;
+    }
+
+    // with `check` all units run `engine_nChunk` steps at a time, so the state
+    // and the routing ring of every unit are kept between the chunks
+    std::vector<cell_T> cell_(n_spat);
+    std::vector<param_T> param_unit(n_spat);
+    std::vector<std::size_t> off_ring[2];
+    std::vector<T> ring_[2];
+    std::vector<kernel::confluen_IUHStream<T>> confluen_[2];
+    for (int s = 0; s < 2; s++) {
+      off_ring[s].assign(n_spat + 1, 0);
+      for (int j= 0; j < n_spat; j++) off_ring[s][j + 1] = off_ring[s][j] + 2 * std::min((int)iuh_unit[s][j]->size(), n_time);
+      ring_[s].resize(off_ring[s][n_spat]);
+      for (int j= 0; j < n_spat; j++) confluen_[s].emplace_back(std::min((int)iuh_unit[s][j]->size(), n_time), iuh_data[s][j], ring_[s].data() + off_ring[s][j]);
+    }
+    for (int j= 0; j < n_spat; j++) unit_begin(j, cell_[j], param_unit[j]);
+
+    for (int i_0 = 0; i_0 < n_time; i_0 += engine_nChunk) {
+      int i_1 = std::min(n_time, i_0 + engine_nChunk);
+#pragma omp parallel for num_threads(n_thread) schedule(static)
+      for (int b = 0; b < n_block; b++) {
+        double* outlet_b = outlet_block.data() + (std::size_t)b * n_time;
+        for (int j = (long)b * n_spat / n_block; j < (long)(b + 1) * n_spat / n_block; j++) {
+          unit_run(j, i_0, i_1, cell_[j], param_unit[j], confluen_[0][j], confluen_[1][j], outlet_b);
+        }
+      }
+      outlet_sum(i_0, i_1);
+      if (!check(i_1)) {
+        memo_end(false);
+        return i_1;
+      }
+    }
+    memo_end(true);
+    return n_time;
+  }
+
+  // Groups the stages for the cache. Stage v depends on stage u when v reads a
+  // field that u wrote last before it, in the same step or for a storage in the
+  // step before; the forcing and `land_water_mm` are set anew at every step.
+  // The stages that depend on each other in both directions form one group
+  // (e.g. all soil and ground water stages), a group keeps the fields that the
+  // other groups read and the last runoff and baseflow for the routing.
+  void memo_build(const std::vector<const engine_stage*>& stage_)
+  {
+    typedef int field; // index in `engine_cell`
+    auto member_ = [](const std::string& name_) {
+      field f = engine_field(engine_cell<double>, name_);
+      if (f < 0) throw std::invalid_argument("unknown field `" + name_ + "`.");
+      return f;
+    };
+    auto has_ = [](const std::vector<field>& list, field f) { return std::find(list.begin(), list.end(), f) != list.end(); };
+    int n_stage = stage_.size();
+    std::vector<std::vector<field>> read_(n_stage), write_(n_stage);
+    for (int k = 0; k < n_stage; k++) {
+      for (const engine_slot& slot_ : engine_slots) if (std::string(slot_.process) == stage_[k]->process) {
+        std::istringstream read_k(slot_.read), write_k(slot_.write);
+        for (std::string name_; read_k >> name_;) read_[k].push_back(member_(name_));
+        for (std::string name_; write_k >> name_;) write_[k].push_back(member_(name_));
+      }
+    }
+    std::vector<field> each_step = boundary_field_;
+    each_step.push_back(member_("land_water_mm"));
+    // the stage whose value of `f` stage v reads, -1 for the forcing or the initial state
+    auto writer_ = [&](int v, field f) {
+      for (int u = v - 1; u >= 0; u--) if (has_(write_[u], f)) return u;
+      if (has_(each_step, f)) return -1;
+      for (int u = n_stage - 1; u >= v; u--) if (has_(write_[u], f)) return u;
+      return -1;
+    };
+    std::vector<std::vector<char>> reach_(n_stage, std::vector<char>(n_stage, 0));
+    std::vector<std::pair<int, field>> edge_read;
+    std::vector<int> edge_to;
+    for (int v = 0; v < n_stage; v++) {
+      for (field f : read_[v]) {
+        int u = writer_(v, f);
+        if (u < 0) continue;
+        reach_[u][v] = 1;
+        edge_read.push_back({u, f});
+        edge_to.push_back(v);
+      }
+    }
+    for (int w = 0; w < n_stage; w++) for (int u = 0; u < n_stage; u++) for (int v = 0; v < n_stage; v++) {
+      if (reach_[u][w] && reach_[w][v]) reach_[u][v] = 1;
+    }
+    memo_node_.assign(n_stage, -1);
+    memo_nNode_ = 0;
+    for (int v = 0; v < n_stage; v++) {
+      if (memo_node_[v] >= 0) continue;
+      for (int w = v; w < n_stage; w++) if (w == v || (reach_[v][w] && reach_[w][v])) memo_node_[w] = memo_nNode_;
+      memo_nNode_++;
+    }
+
+    // inputs and upstream groups
+    memo_input_.assign(memo_nNode_, std::vector<int>());
+    memo_upstream_.assign(memo_nNode_, std::vector<int>());
+    for (int k = 0; k < n_stage; k++) {
+      std::istringstream input_k(stage_[k]->input);
+      for (std::string name_; input_k >> name_;) {
+        int p = std::find(param_name_.begin(), param_name_.end(), name_) - param_name_.begin();
+        std::vector<int>& input_g = memo_input_[memo_node_[k]];
+        if (p < (int)param_name_.size() && std::find(input_g.begin(), input_g.end(), p) == input_g.end()) input_g.push_back(p);
+      }
+    }
+    for (int g = 0; g < memo_nNode_; g++) std::sort(memo_input_[g].begin(), memo_input_[g].end());
+
+    // kept fields
+    memo_series_.assign(n_stage, std::vector<field>());
+    auto keep_ = [&](int u, field f) {
+      if (!has_(memo_series_[u], f)) memo_series_[u].push_back(f);
+    };
+    for (std::size_t e = 0; e < edge_read.size(); e++) {
+      int u = edge_read[e].first, v = edge_to[e], g_u = memo_node_[u], g_v = memo_node_[v];
+      if (g_u == g_v) continue;
+      keep_(u, edge_read[e].second);
+      std::vector<int>& upstream_ = memo_upstream_[g_v];
+      if (std::find(upstream_.begin(), upstream_.end(), g_u) == upstream_.end()) upstream_.push_back(g_u);
+    }
+    field route_field[2] = {member_("land_runoff_mm"), member_("ground_baseflow_mm")};
+    for (int r = 0; r < 2; r++) {
+      memo_route_[r] = writer_(n_stage, route_field[r]);
+      if (memo_route_[r] >= 0) keep_(memo_route_[r], route_field[r]);
+    }
+    memo_offset_.assign(n_stage, 0);
+    memo_nSeries_.assign(memo_nNode_, 0);
+    for (int k = 0; k < n_stage; k++) {
+      memo_offset_[k] = memo_nSeries_[memo_node_[k]];
+      memo_nSeries_[memo_node_[k]] += memo_series_[k].size();
+    }
+    for (int r = 0; r < 2; r++) {
+      if (memo_route_[r] < 0) continue;
+      const std::vector<field>& series_r = memo_series_[memo_route_[r]];
+      memo_routeSeries_[r] = std::find(series_r.begin(), series_r.end(), route_field[r]) - series_r.begin();
+    }
+  }
+
+  // the bytes of everything the series of group g depend on
+  std::string memo_key(int g, int n_time, int n_spat, const std::vector<view<const double>>& boundary,
+                       const std::vector<view<const double>>& param, const std::function<const std::string&(int)>& node_key) const
+  {
+    std::string key_;
+    auto add_ = [&](const void* x, std::size_t n_byte) { key_.append(static_cast<const char*>(x), n_byte); };
+    const engine* this_ = this;
+    add_(&this_, sizeof(this_));
+    add_(&g, sizeof(g));
+    add_(&n_time, sizeof(n_time));
+    add_(&n_spat, sizeof(n_spat));
+    for (const view<const double>& b : boundary) {
+      const double* data_ = b.data();
+      std::size_t size_ = b.size();
+      add_(&data_, sizeof(data_));
+      add_(&size_, sizeof(size_));
+    }
+    for (int p : memo_input_[g]) {
+      std::size_t size_ = param[p].size();
+      add_(&size_, sizeof(size_));
+      add_(param[p].data(), size_ * sizeof(double));
+    }
+    for (int g_up : memo_upstream_[g]) {
+      const std::string& key_up = node_key(g_up);
+      std::size_t size_ = key_up.size();
+      add_(&size_, sizeof(size_));
+      key_ += key_up;
+    }
+    return key_;
+  }
+
+  bool single_;
+  std::vector<engine_step<double>> step_;
+  std::vector<engine_step<float>> step_single_;
+  std::vector<std::string> boundary_name_, param_name_;
+  // indices in `engine_cell` and `engine_param`
+  std::vector<int> boundary_field_, state_field_, param_field_;
+  std::string iuh_method_[2];
+  confluenIUH_method iuh_[2];
+  bool has_shape_[2] = {false, false};
+  // stage groups of the cache, see `memo_build()`
+  int memo_nNode_ = 0, memo_route_[2] = {-1, -1};
+  std::size_t memo_routeSeries_[2] = {0, 0};
+  std::vector<int> memo_node_;
+  std::vector<std::size_t> memo_offset_, memo_nSeries_;
+  std::vector<std::vector<int>> memo_input_, memo_upstream_;
+  std::vector<std::vector<int>> memo_series_;
+};
+
+} // namespace core
+} // namespace EDCHM
+
+#endif // EDCHM_ENGINE_H
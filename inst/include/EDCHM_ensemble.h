@@ -0,0 +1,383 @@
+// Defines a header file for the ensemble runs of the models
+//
+// An ensemble runs K parameter sets (members) of one lumped model against the
+// same forcing, as calibration, Monte-Carlo or GLUE need it, in one call and
+// without an allocation per member or step. The members run in blocks of
+// `ensemble_lane`, a block holds every state and parameter as one array over
+// its members (structure of arrays), and a step runs each process over all
+// lanes of the block:
+// - the `pow()` and `tanh()` of a process go to EDCHM_vecmath.h as one array
+//   for the whole block, which the fast mode computes in AVX2 / AVX-512 lanes
+// - the arithmetic around them, the fixed-power GR4J kernels and the routing of
+//   the UHs (stored as lanes, padded with 0 to the longest UH of the block) are
+//   `omp simd` loops over the lanes; the loops with `sqrt()` or a division in a
+//   branch stay scalar unless the compiler may drop `errno` (-fno-math-errno)
+// In the strict mode every member gives bitwise the same series as a run of the
+// model alone, in the fast mode the series of the vector math (`EDCHM_mathMode()`).
+// 1000 members x 3650 days on one thread of an AVX-512 CPU (g++ -O2), against
+// the former loop of one member after the other: GR4J 0.29 s -> 0.21 s (strict
+// and fast), mini 0.89 s -> 0.51 s (strict) and 0.28 s (fast).
+// The blocks are independent and run in parallel.
+// The header is free of Rcpp.
+#ifndef EDCHM_ENSEMBLE_H
+#define EDCHM_ENSEMBLE_H
+
+#include "EDCHM_core.h"
+#include "EDCHM_objective.h"
+#include "EDCHM_vecmath.h"
+
+namespace EDCHM {
+namespace core {
+
+const int ensemble_lane = 64;
+
+// parameters of the members, `param[m]` holds n_member values of the m-th name
+inline const std::vector<std::string> EDCHM_GR4J_ensembleParam = {
+  "S_", "R_", "X_1", "X_2", "X_3", "X_4"
+};
+inline const std::vector<std::string> EDCHM_mini_ensembleParam = {
+  "ground_capacity_mm", "ground_water_mm", "land_impermeableFrac_1", "soil_capacity_mm",
+  "soil_potentialPercola_mm", "soil_water_mm", "confluenLand_responseTime_TS", "confluenGround_responseTime_TS",
+  "param_baseflow_grf_gamma", "param_confluenLand_kel_k", "param_evatrans_ubc_gamma", "param_infilt_ubc_P0AGEN",
+  "param_percola_arn_k", "param_percola_arn_thresh"
+};
+
+// checks ----------
+
+inline void ensemble_check(
+    int n_time,
+    int n_member,
+    int n_thread,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<view<const double>>& param,
+    const std::vector<std::string>& param_name,
+    view<const double> observe,
+    const objective::gof_sum* out_gof
+)
+{
+  if (n_time < 0 || n_member < 0) throw std::invalid_argument("`n_time` and the number of members can not be negative.");
+  if (n_thread < 1) throw std::invalid_argument("`n_thread` must be at least 1.");
+  modell_checkForcing("atmos_potentialEvatrans_mm", atmos_potentialEvatrans_mm, n_time, 1);
+  modell_checkForcing("atmos_precipitation_mm", atmos_precipitation_mm, n_time, 1);
+  if (param.size() != param_name.size()) throw std::invalid_argument("`param` must have one vector for every parameter.");
+  for (size_t k = 0; k < param.size(); k++) modell_checkParam(param_name[k].c_str(), param[k], n_member);
+  if (out_gof && observe.size() < (std::size_t)n_time) throw std::invalid_argument("`observe` must have at least `n_time` values.");
+}
+
+// routing of the lanes ----------
+
+// UHs of the members m0, ..., m0 + n_lane - 1 as lanes, uh[k * ensemble_lane + l]
+// is step k of lane l; the part beyond n_time never reaches the output and is left out
+inline int ensemble_uhLane(
+    const std::vector<IUH_ptr>& iuh_,
+    int m0,
+    int n_lane,
+    int n_time,
+    std::vector<double>& uh_
+)
+{
+  int n_uh = 0;
+  for (int l = 0; l < n_lane; l++) n_uh = std::max(n_uh, std::min((int)iuh_[m0 + l]->size(), n_time));
+  uh_.assign((std::size_t)n_uh * ensemble_lane, 0.0);
+  for (int l = 0; l < n_lane; l++) {
+    int n_uh_l = std::min((int)iuh_[m0 + l]->size(), n_time);
+    for (int k = 0; k < n_uh_l; k++) uh_[(std::size_t)k * ensemble_lane + l] = (*iuh_[m0 + l])[k];
+  }
+  return n_uh;
+}
+
+// The ring buffer of `kernel::confluen_ringStep()` for all lanes of a block,
+// every step of the ring holds one value per lane. The sum of every lane runs
+// over the steps in the same order as the ring of one member, the padded
+// steps only add 0.
+struct ensemble_ring {
+  int n_uh = 0, head = 0;
+  const double* uh_ = nullptr;
+  std::vector<double> ring_;
+
+  void reset(int n_uh_, const double* uh_lane)
+  {
+    n_uh = n_uh_;
+    uh_ = uh_lane;
+    head = 0;
+    ring_.assign((std::size_t)2 * n_uh * ensemble_lane, 0.0);
+  }
+
+  void step(int n_lane, const double* confluen_inputWater_mm, double* confluen_outputWater_mm)
+  {
+    for (int l = 0; l < n_lane; l++) confluen_outputWater_mm[l] = 0.0;
+    if (n_uh == 0) return;
+    head = kernel::confluen_ringHead(head, n_uh);
+    double *ring_0 = ring_.data() + (std::size_t)head * ensemble_lane, *ring_1 = ring_0 + (std::size_t)n_uh * ensemble_lane;
+    for (int l = 0; l < n_lane; l++) {
+      ring_0[l] = confluen_inputWater_mm[l];
+      ring_1[l] = confluen_inputWater_mm[l];
+    }
+    for (int k = 0; k < n_uh; k++) {
+      const double *window = ring_0 + (std::size_t)k * ensemble_lane, *uh_k = uh_ + (std::size_t)k * ensemble_lane;
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        confluen_outputWater_mm[l] += window[l] * uh_k[l];
+      }
+    }
+  }
+};
+
+// models ----------
+
+// `out_Q` (n_time x n_member, column major) and `out_gof` (n_member, against
+// `observe`) can be nullptr when they are not asked; the steps are added to the
+// accumulators of `out_gof` as they come in (empty, or made with the epsilon of
+// the log-NSE)
+inline void EDCHM_GR4J_ensemble(
+    int n_time,
+    int n_member,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<view<const double>>& param,
+    int n_thread,
+    double* out_Q,
+    view<const double> observe,
+    objective::gof_sum* out_gof
+)
+{
+  ensemble_check(n_time, n_member, n_thread, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, EDCHM_GR4J_ensembleParam, observe, out_gof);
+  enum { P_S, P_R, P_X_1, P_X_2, P_X_3, P_X_4 };
+
+  // the UHs come from the IUH cache, so they are ready before the parallel region
+  std::vector<IUH_ptr> UH_2(n_member), UH_1(n_member);
+  for (int m = 0; m < n_member; m++) {
+    UH_2[m] = confluenIUH_cached(IUH_GR4J2fast, param[P_X_4][m]);
+    UH_1[m] = confluenIUH_cached(IUH_GR4J1fast, param[P_X_4][m]);
+  }
+  int n_block = (n_member + ensemble_lane - 1) / ensemble_lane;
+  const double *atmos_precipitation = atmos_precipitation_mm.data(), *atmos_potentialEvatrans = atmos_potentialEvatrans_mm.data();
+
+#pragma omp parallel num_threads(n_thread)
+{
+  std::vector<double> UH_2_lane, UH_1_lane;
+  ensemble_ring ring_Pr_1, ring_Pr_9;
+  double S_[ensemble_lane], R_[ensemble_lane], X_1[ensemble_lane], X_2[ensemble_lane], X_3[ensemble_lane];
+  double P_n[ensemble_lane], E_n[ensemble_lane], x_[2 * ensemble_lane], tanh_[2 * ensemble_lane];
+  double Pr_1[ensemble_lane], Pr_9[ensemble_lane], Q_1[ensemble_lane], Q_9[ensemble_lane], Q_[ensemble_lane];
+  objective::gof_sum gof_[ensemble_lane];
+
+#pragma omp for schedule(static)
+  for (int b = 0; b < n_block; b++) {
+
+    int m0 = b * ensemble_lane, n_lane = std::min(ensemble_lane, n_member - m0);
+    for (int l = 0; l < n_lane; l++) {
+      S_[l] = param[P_S][m0 + l]; R_[l] = param[P_R][m0 + l];
+      X_1[l] = param[P_X_1][m0 + l]; X_2[l] = param[P_X_2][m0 + l]; X_3[l] = param[P_X_3][m0 + l];
+      if (out_gof) gof_[l] = out_gof[m0 + l];
+    }
+    int n_UH_2 = ensemble_uhLane(UH_2, m0, n_lane, n_time, UH_2_lane), n_UH_1 = ensemble_uhLane(UH_1, m0, n_lane, n_time, UH_1_lane);
+    ring_Pr_1.reset(n_UH_2, UH_2_lane.data());
+    ring_Pr_9.reset(n_UH_1, UH_1_lane.data());
+
+    for (int i= 0; i < n_time; i++) {
+
+      double P_ = atmos_precipitation[i];
+      double E_ = atmos_potentialEvatrans[i];
+      double P_n_i = P_ > E_ ? P_ - E_ : 0.0;
+      double E_n_i = P_ > E_ ? 0.0 : E_ - P_;
+
+      // production store, the tanh of `kernel::infilt_GR4J()` (first n_lane) and
+      // `kernel::evatransActual_GR4J()` (second n_lane) in one vector call
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double P_n_l = P_n_i, E_n_l = E_n_i;
+        P_n[l] = P_n_l > 13 * X_1[l] ? 13 * X_1[l] : P_n_l;
+        E_n[l] = E_n_l > 13 * X_1[l] ? 13 * X_1[l] : E_n_l;
+        x_[l] = P_n[l] / X_1[l];
+        x_[n_lane + l] = E_n[l] / X_1[l];
+      }
+      vecmath::vec_tanh(2 * n_lane, x_, tanh_);
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double soil_diff = X_1[l] - S_[l];
+        double limit_ = soil_diff > P_n[l] ? P_n[l] : soil_diff;
+        double s_x1 = S_[l] / X_1[l];
+        double P_s = X_1[l] * (1 - (s_x1) * (s_x1)) * tanh_[l] / (1 + s_x1 * tanh_[l]);
+        P_s = P_s > limit_ ? limit_ : P_s;
+
+        double E_s = S_[l] * (2 - S_[l] / X_1[l]) * tanh_[n_lane + l] / (1 + (1 - S_[l] / X_1[l]) * tanh_[n_lane + l]);
+        E_s = E_s > S_[l] ? S_[l] : E_s;
+
+        S_[l] += (P_s - E_s);
+
+        double Perc_ = kernel::percola_GR4Jfast(S_[l], X_1[l]);
+        S_[l] +=  - Perc_;
+
+        double P_r = (P_n[l] - P_s + Perc_);
+        P_r = P_r < 0 ? 0 : P_r;
+        Pr_1[l] = 0.1 * P_r;
+        Pr_9[l] = 0.9 * P_r;
+      }
+
+      ring_Pr_1.step(n_lane, Pr_1, Q_1);
+      ring_Pr_9.step(n_lane, Pr_9, Q_9);
+
+      // routing store
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double F_ = kernel::lateral_GR4Jfast(R_[l], X_3[l], X_2[l]);
+        double Q_d = (Q_1[l] + F_) > 0.0 ? Q_1[l] + F_ : 0;
+
+        R_[l] += (Q_9[l] + F_);
+        R_[l] = R_[l] > 0.0 ? R_[l] : 0.0;
+        double Q_r = kernel::baseflow_GR4Jfast(R_[l], X_3[l]);
+        R_[l] +=  - Q_r;
+        Q_[l] = Q_r + Q_d;
+      }
+
+      if (out_Q) for (int l = 0; l < n_lane; l++) out_Q[(std::size_t)(m0 + l) * n_time + i] = Q_[l];
+      if (out_gof) for (int l = 0; l < n_lane; l++) gof_[l].add(Q_[l], observe[i]);
+
+    }
+    if (out_gof) for (int l = 0; l < n_lane; l++) out_gof[m0 + l] = gof_[l];
+  }
+}
+}
+
+inline void EDCHM_mini_ensemble(
+    int n_time,
+    int n_member,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<view<const double>>& param,
+    int n_thread,
+    double* out_streamflow,
+    view<const double> observe,
+    objective::gof_sum* out_gof
+)
+{
+  ensemble_check(n_time, n_member, n_thread, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, EDCHM_mini_ensembleParam, observe, out_gof);
+  enum { P_ground_capacity, P_ground_water, P_land_impermeableFrac, P_soil_capacity,
+         P_soil_potentialPercola, P_soil_water, P_confluenLand_responseTime, P_confluenGround_responseTime,
+         P_baseflow_grf_gamma, P_confluenLand_kel_k, P_evatrans_ubc_gamma, P_infilt_ubc_P0AGEN,
+         P_percola_arn_k, P_percola_arn_thresh };
+
+  // the IUHs come from the IUH cache, so they are ready before the parallel region
+  std::vector<IUH_ptr> confluenLand_iuh_1(n_member), confluenGround_iuh_1(n_member);
+  for (int m = 0; m < n_member; m++) {
+    confluenLand_iuh_1[m] = confluenIUH_cached(IUH_Kelly, param[P_confluenLand_responseTime][m], param[P_confluenLand_kel_k][m]);
+    confluenGround_iuh_1[m] = confluenIUH_cached(IUH_GR4J1, param[P_confluenGround_responseTime][m]);
+  }
+  int n_block = (n_member + ensemble_lane - 1) / ensemble_lane;
+  const double *atmos_precipitation = atmos_precipitation_mm.data(), *atmos_potentialEvatrans = atmos_potentialEvatrans_mm.data();
+
+#pragma omp parallel num_threads(n_thread)
+{
+  std::vector<double> confluenLand_lane, confluenGround_lane;
+  ensemble_ring confluenLand, confluenGround;
+  // the states, constants and parameters of the lanes, named as in `compose::cell` and `compose::param`
+  double soil_water_mm[ensemble_lane], ground_water_mm[ensemble_lane];
+  double soil_capacity_mm[ensemble_lane], ground_capacity_mm[ensemble_lane], land_impermeableFrac_1[ensemble_lane], soil_potentialPercola_mm[ensemble_lane];
+  double param_baseflow_grf_gamma[ensemble_lane], param_evatrans_ubc_gamma[ensemble_lane], param_infilt_ubc_P0AGEN[ensemble_lane];
+  double param_percola_arn_k[ensemble_lane], param_percola_arn_thresh[ensemble_lane];
+  double x_[ensemble_lane], y_[ensemble_lane], pow_[ensemble_lane], baseflow_temp[ensemble_lane];
+  double runoff_[ensemble_lane], baseflow_[ensemble_lane], streamLand_[ensemble_lane], streamGround_[ensemble_lane];
+  objective::gof_sum gof_[ensemble_lane];
+
+#pragma omp for schedule(static)
+  for (int b = 0; b < n_block; b++) {
+
+    int m0 = b * ensemble_lane, n_lane = std::min(ensemble_lane, n_member - m0);
+    for (int l = 0; l < n_lane; l++) {
+      int m = m0 + l;
+      soil_water_mm[l] = param[P_soil_water][m]; ground_water_mm[l] = param[P_ground_water][m];
+      soil_capacity_mm[l] = param[P_soil_capacity][m]; ground_capacity_mm[l] = param[P_ground_capacity][m];
+      land_impermeableFrac_1[l] = param[P_land_impermeableFrac][m]; soil_potentialPercola_mm[l] = param[P_soil_potentialPercola][m];
+      param_baseflow_grf_gamma[l] = param[P_baseflow_grf_gamma][m]; param_evatrans_ubc_gamma[l] = param[P_evatrans_ubc_gamma][m];
+      param_infilt_ubc_P0AGEN[l] = param[P_infilt_ubc_P0AGEN][m];
+      param_percola_arn_k[l] = param[P_percola_arn_k][m]; param_percola_arn_thresh[l] = param[P_percola_arn_thresh][m];
+      if (out_gof) gof_[l] = out_gof[m0 + l];
+    }
+    int n_iuhLand = ensemble_uhLane(confluenLand_iuh_1, m0, n_lane, n_time, confluenLand_lane);
+    int n_iuhGround = ensemble_uhLane(confluenGround_iuh_1, m0, n_lane, n_time, confluenGround_lane);
+    confluenLand.reset(n_iuhLand, confluenLand_lane.data());
+    confluenGround.reset(n_iuhGround, confluenGround_lane.data());
+
+    for (int i= 0; i < n_time; i++) {
+
+      // the slots of `modell_mini` (EDCHM_compose.h) over all lanes, with the
+      // arithmetic of the kernels and their pow of the block in one vector call
+      double atmos_potentialEvatrans_mm_i = atmos_potentialEvatrans[i], atmos_precipitation_mm_i = atmos_precipitation[i];
+
+      // kernel::evatransActual_UBC()
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        y_[l] = - (soil_capacity_mm[l] - soil_water_mm[l]) / (param_evatrans_ubc_gamma[l] * soil_capacity_mm[l]);
+      }
+      vecmath::vec_pow10(n_lane, y_, pow_);
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double AET = atmos_potentialEvatrans_mm_i * pow_[l];
+        AET = AET > soil_water_mm[l] ? soil_water_mm[l] : AET;
+        soil_water_mm[l] += - AET;
+      }
+
+      // kernel::infilt_UBC()
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        y_[l] = - (soil_capacity_mm[l] - soil_water_mm[l]) / (soil_capacity_mm[l] * param_infilt_ubc_P0AGEN[l]);
+      }
+      vecmath::vec_pow10(n_lane, y_, pow_);
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double soil_diff_mm = soil_capacity_mm[l] - soil_water_mm[l];
+        double limit_mm = soil_diff_mm > atmos_precipitation_mm_i ? atmos_precipitation_mm_i : soil_diff_mm;
+        double infilt_water_mm = atmos_precipitation_mm_i * (1 - land_impermeableFrac_1[l] * pow_[l]);
+        infilt_water_mm = infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+        soil_water_mm[l] += infilt_water_mm;
+        runoff_[l] = atmos_precipitation_mm_i - infilt_water_mm;
+      }
+
+      // kernel::percola_Arno(), its pow(x, 2) is a product, and the overflow of the ground
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double percola_ = kernel::percola_Arno(soil_water_mm[l], soil_capacity_mm[l], soil_potentialPercola_mm[l], param_percola_arn_thresh[l], param_percola_arn_k[l]);
+        ground_water_mm[l] += percola_;
+        soil_water_mm[l] += - percola_;
+        baseflow_temp[l] = ground_water_mm[l] < ground_capacity_mm[l] ? 0 : ground_water_mm[l] - ground_capacity_mm[l];
+        ground_water_mm[l] = ground_water_mm[l] < ground_capacity_mm[l] ? ground_water_mm[l] : ground_capacity_mm[l];
+        x_[l] = ground_water_mm[l] / ground_capacity_mm[l];
+      }
+
+      // kernel::baseflow_GR4Jfix(), two pow one after the other
+      vecmath::vec_pow(n_lane, x_, param_baseflow_grf_gamma, pow_);
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        x_[l] = 1 + pow_[l];
+        y_[l] = -1.0 / param_baseflow_grf_gamma[l];
+      }
+      vecmath::vec_pow(n_lane, x_, y_, pow_);
+#pragma omp simd
+      for (int l = 0; l < n_lane; l++) {
+        double baseflow_mm = (1 - pow_[l]) * ground_water_mm[l];
+        baseflow_mm = baseflow_mm > ground_water_mm[l] ? ground_water_mm[l] : baseflow_mm;
+        ground_water_mm[l] += - baseflow_mm;
+        baseflow_[l] = baseflow_mm + baseflow_temp[l];
+      }
+
+      confluenLand.step(n_lane, runoff_, streamLand_);
+      confluenGround.step(n_lane, baseflow_, streamGround_);
+
+      for (int l = 0; l < n_lane; l++) {
+        double streamflow_ = streamLand_[l] + streamGround_[l];
+        if (out_streamflow) out_streamflow[(std::size_t)(m0 + l) * n_time + i] = streamflow_;
+        if (out_gof) gof_[l].add(streamflow_, observe[i]);
+      }
+
+    }
+    if (out_gof) for (int l = 0; l < n_lane; l++) out_gof[m0 + l] = gof_[l];
+  }
+}
+}
+
+} // namespace core
+} // namespace EDCHM
+
+#endif // EDCHM_ENSEMBLE_H
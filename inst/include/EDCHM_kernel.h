@@ -0,0 +1,944 @@
+// Defines a header file containing the scalar (one spatial unit) process kernels
+//
+// Every process method has a kernel with the same name and arguments, which
+// reproduces the arithmetic of the Rcpp module operation by operation, so a
+// fused per-cell loop gives the same results as the vector model, without any
+// temporary NumericVector. The span form over many units is in EDCHM_span.h.
+// The kernels are templated on the scalar: `double` for the models, or the dual
+// number of EDCHM_dual.h, which carries the derivatives to the parameters
+// through the same arithmetic. The math functions are called unqualified, so
+// `double` takes the <cmath> ones and a dual finds its own by ADL.
+// The `*_GR4Jfast` kernels are the GR4J ones with the fixed exponents written as
+// multiplies and square roots instead of the general pow(); they are within
+// 3 ulp of the pow() forms and are the fast path of the GR4J models.
+// The header is free of Rcpp and only needs <cmath>.
+#ifndef EDCHM_KERNEL_H
+#define EDCHM_KERNEL_H
+
+#include <cmath>
+
+namespace EDCHM {
+namespace kernel {
+
+using std::ceil;
+using std::exp;
+using std::pow;
+using std::sqrt;
+using std::tanh;
+
+// x^3.5 as x x x sqrt(x); the dual number has its own, whose derivative stays
+// finite at x = 0
+template <class T>
+inline T pow3_5(
+    T x
+)
+{
+  return x * x * x * sqrt(x);
+}
+
+// atmos ----------
+
+template <class T>
+inline T atmosSnow_ThresholdT(
+    T atmos_precipitation_mm,
+    T atmos_temperature_Cel,
+    T param_atmos_thr_Ts
+)
+{
+  return atmos_temperature_Cel > param_atmos_thr_Ts ? 0 : atmos_precipitation_mm;
+}
+
+template <class T>
+inline T atmosSnow_UBC(
+    T atmos_precipitation_mm,
+    T atmos_temperature_Cel,
+    T param_atmos_ubc_A0FORM
+)
+{
+  T atmos_snow_mm = (1 - atmos_temperature_Cel / param_atmos_ubc_A0FORM) * atmos_precipitation_mm;
+  atmos_snow_mm = atmos_temperature_Cel <= 0 ? atmos_precipitation_mm : atmos_snow_mm;
+  return atmos_temperature_Cel > param_atmos_ubc_A0FORM ? 0 : atmos_snow_mm;
+}
+
+// snow ----------
+
+template <class T>
+inline T snowMelt_Kustas(
+    T snow_ice_mm,
+    T atmos_temperature_Cel,
+    T atmos_netRadiat_MJ,
+    T param_snow_kus_fE,
+    T param_snow_kus_fT
+)
+{
+  T snow_melt_mm = (atmos_temperature_Cel < 0 ? 0 : atmos_temperature_Cel) * param_snow_kus_fT * 24 + param_snow_kus_fE * atmos_netRadiat_MJ;
+  return snow_melt_mm > snow_ice_mm ? snow_ice_mm : snow_melt_mm;
+}
+
+template <class T>
+inline T snowMelt_Factor(
+    T snow_ice_mm,
+    T atmos_temperature_Cel,
+    T param_snow_fac_f,
+    T param_snow_fac_Tmelt
+)
+{
+  T diff_T = atmos_temperature_Cel - param_snow_fac_Tmelt;
+  diff_T = diff_T > 0 ? diff_T : 0;
+
+  T snow_melt_mm = param_snow_fac_f * 24 * diff_T;
+  return snow_melt_mm > snow_ice_mm ? snow_ice_mm : snow_melt_mm;
+}
+
+// intercep ----------
+
+template <class T>
+inline T intercep_Full(
+    T atmos_precipitation_mm,
+    T land_interceptWater_mm,
+    T land_interceptCapacity_mm
+)
+{
+  T water_diff_mm = land_interceptCapacity_mm - land_interceptWater_mm;
+  return water_diff_mm > atmos_precipitation_mm ? atmos_precipitation_mm : water_diff_mm;
+}
+
+// evatrans ----------
+
+template <class T>
+inline T evatransPotential_TurcWendling(
+    T atmos_temperature_Cel,
+    T atmos_solarRadiat_MJ,
+    T param_evatrans_tur_k
+)
+{
+  return (atmos_solarRadiat_MJ * 100 + 3.875 * 24 * param_evatrans_tur_k) * (atmos_temperature_Cel + 22) / 150 / (atmos_temperature_Cel + 123);
+}
+
+template <class T>
+inline T evatransPotential_Linacre(
+    T atmos_temperature_Cel,
+    T atmos_relativeHumidity_1,
+    T land_latitude_Degree,
+    T land_elevation_m,
+    T land_albedo_1
+)
+{
+  return ((0.75 - land_albedo_1) * 100 * (atmos_temperature_Cel + 0.006 * land_elevation_m) / (100 - land_latitude_Degree) + 3 * 100 * (1 - atmos_relativeHumidity_1)) / (80 - atmos_temperature_Cel);
+}
+
+template <class T>
+inline T evatransPotential_FAO56(
+    T atmos_temperature_Cel,
+    T atmos_vaporPress_hPa,
+    T atmos_saturatVaporPress_hPa,
+    T atmos_netRadiat_MJ,
+    T atmos_windSpeed2m_m_s,
+    T land_elevation_m
+)
+{
+  T R_n = atmos_netRadiat_MJ;
+  T u_2 = atmos_windSpeed2m_m_s;
+  T e_a = atmos_vaporPress_hPa;
+  T e_s = atmos_saturatVaporPress_hPa;
+  T Delta_ = 4098 * (0.6108 * exp(17.27 * atmos_temperature_Cel / (atmos_temperature_Cel + 237.3))) / ((atmos_temperature_Cel + 237.3) * (atmos_temperature_Cel + 237.3)); // Eq.13
+  T P_ = 101.3 * pow(((293 - 0.0065 * land_elevation_m) / 293), 5.26); // Eq.7
+  T gamma_ = 0.665e-3 * P_; // Eq.8
+  return (0.408 * Delta_ * (R_n - 0.) + gamma_ * 90 * u_2 * (e_s - e_a) / (atmos_temperature_Cel + 273)) / (Delta_ + gamma_ * (1 + 0.34 * u_2));
+}
+
+template <class T>
+inline T evatransActual_SupplyRatio(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_sur_k
+)
+{
+  T k_ = water_mm / capacity_mm * param_evatrans_sur_k;
+  T AET = atmos_potentialEvatrans_mm * k_;
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_SupplyPow(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_sup_k,
+    T param_evatrans_sup_gamma
+)
+{
+  T k_ = param_evatrans_sup_k * pow((water_mm / capacity_mm), param_evatrans_sup_gamma);
+  T AET = atmos_potentialEvatrans_mm * k_;
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_VIC(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_vic_gamma
+)
+{
+  T k_ = 1 - pow((1- water_mm / capacity_mm), param_evatrans_vic_gamma);
+  T AET = atmos_potentialEvatrans_mm * k_;
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_UBC(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_ubc_gamma
+)
+{
+  T diff_mm = capacity_mm - water_mm;
+  T k_ = pow(10.0, - diff_mm / (param_evatrans_ubc_gamma * capacity_mm));
+  T AET = atmos_potentialEvatrans_mm * k_;
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_GR4J(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm
+)
+{
+  T AET = water_mm * (2 - water_mm / capacity_mm) * tanh(atmos_potentialEvatrans_mm / capacity_mm) / (1 + (1 - water_mm / capacity_mm) * tanh(atmos_potentialEvatrans_mm / capacity_mm));
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_LiangLand(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_lia_gamma
+)
+{
+  T k_ = pow((water_mm / capacity_mm), param_evatrans_lia_gamma);
+  T AET = atmos_potentialEvatrans_mm * k_;
+  T f_ = water_mm / AET;
+  f_ = f_ > 1 ? 1 : f_;
+  AET = f_ * AET;
+  return AET > water_mm ? water_mm : AET;
+}
+
+template <class T>
+inline T evatransActual_LiangSoil(
+    T atmos_potentialEvatrans_mm,
+    T water_mm,
+    T capacity_mm,
+    T param_evatrans_lia_B
+)
+{
+  T i_m = capacity_mm * (param_evatrans_lia_B + 1);
+  T B_p_1 = (param_evatrans_lia_B + 1);
+  T B_1 = 1 / B_p_1;
+  T i_0 = i_m * (1 - pow(1 - water_mm / capacity_mm, B_1));
+  T A_s = 1 - pow((1 - i_0 / i_m), param_evatrans_lia_B);
+  T A_s_1 = (1 - A_s);
+  T k_ = A_s + i_0 / i_m * A_s_1 * (1 +
+    param_evatrans_lia_B / (1+param_evatrans_lia_B) * pow(A_s_1, 1 / param_evatrans_lia_B) +
+    param_evatrans_lia_B / (2+param_evatrans_lia_B) * pow(A_s_1, 2 / param_evatrans_lia_B) +
+    param_evatrans_lia_B / (3+param_evatrans_lia_B) * pow(A_s_1, 3 / param_evatrans_lia_B));
+  T AET = atmos_potentialEvatrans_mm * k_;
+  return AET > water_mm ? water_mm : AET;
+}
+
+// infilt ----------
+
+template <class T>
+inline T infilt_UBC(
+    T land_water_mm,
+    T land_impermeableFrac_1,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_ubc_P0AGEN
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T k_ = 1 - land_impermeableFrac_1 * pow(10.0, - soil_diff_mm / (soil_capacity_mm * param_infilt_ubc_P0AGEN));
+  T infilt_water_mm = land_water_mm * k_;
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_GR4J(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T tanh_pn_x1 = tanh(land_water_mm / soil_capacity_mm);
+  T s_x1 = soil_water_mm / soil_capacity_mm;
+  T infilt_water_mm = soil_capacity_mm * (1 - (s_x1) * (s_x1)) * tanh_pn_x1 / (1 + s_x1 * tanh_pn_x1); //// Eq.3
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_SupplyRatio(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_sur_k
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T infilt_water_mm = param_infilt_sur_k * land_water_mm;
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_AcceptRatio(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_acr_k
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T infilt_water_mm = soil_diff_mm * param_infilt_acr_k;
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_SupplyPow(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_sup_k,
+    T param_infilt_sup_gamma
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T infilt_water_mm = param_infilt_sup_k * pow(ceil(land_water_mm), param_infilt_sup_gamma);
+  infilt_water_mm = infilt_water_mm > land_water_mm ? land_water_mm : infilt_water_mm;
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_AcceptPow(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_acp_k,
+    T param_infilt_acp_gamma
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+
+  T k_ = param_infilt_acp_k * pow((soil_diff_mm / soil_capacity_mm), param_infilt_acp_gamma);
+  T infilt_water_mm = k_ * soil_diff_mm;
+
+  return infilt_water_mm > land_water_mm ? land_water_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_HBV(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_hbv_beta
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T k_ = (1 - pow(soil_water_mm / soil_capacity_mm, param_infilt_hbv_beta));
+  T infilt_water_mm = land_water_mm * k_;
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_XAJ(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_xaj_B
+)
+{
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+
+  T MM_ = soil_capacity_mm * (param_infilt_xaj_B + 1);
+  T B_p_1 = (param_infilt_xaj_B + 1);
+  T B_1 = 1 / param_infilt_xaj_B;
+  T AU_ = MM_ * (1 - pow(1 - soil_water_mm * B_p_1 / MM_, B_1));
+  T AU_L_MM = (MM_ - AU_ - land_water_mm) / MM_;
+  AU_L_MM = AU_L_MM < 0 ? 0 : AU_L_MM;
+  T MM_AU = (MM_ - AU_) / MM_;
+  T infilt_water_mm = - MM_ * (pow(AU_L_MM, B_p_1) - pow(MM_AU, B_p_1)) / B_p_1;
+
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+template <class T>
+inline T infilt_VIC(
+    T land_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_infilt_vic_B
+)
+{
+  T i_m = soil_capacity_mm * (param_infilt_vic_B + 1);
+  T B_p_1 = (param_infilt_vic_B + 1);
+  T B_1 = 1 / B_p_1;
+  T i_0 = i_m * (1 - pow(1 - soil_water_mm / soil_capacity_mm, B_1));
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  T infilt_water_mm = (i_0 + land_water_mm) > i_m ? soil_diff_mm :
+    soil_diff_mm - soil_capacity_mm * pow((1 - (i_0 + land_water_mm) / i_m), B_p_1);
+  T limit_mm = soil_diff_mm > land_water_mm ? land_water_mm : soil_diff_mm;
+  return infilt_water_mm > limit_mm ? limit_mm : infilt_water_mm;
+}
+
+// percola ----------
+
+template <class T>
+inline T percola_Arno(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialPercola_mm,
+    T param_percola_arn_thresh,
+    T param_percola_arn_k
+)
+{
+  T Ws_Wc = soil_capacity_mm * param_percola_arn_thresh;
+  T percola_;
+  if (soil_potentialPercola_mm > Ws_Wc) {
+    percola_ = soil_water_mm;
+  } else if (soil_water_mm < Ws_Wc) {
+    percola_ = param_percola_arn_k * soil_potentialPercola_mm / (soil_capacity_mm) * soil_water_mm;
+  } else {
+    percola_ = param_percola_arn_k * soil_potentialPercola_mm / (soil_capacity_mm) * soil_water_mm + soil_potentialPercola_mm * (1 - param_percola_arn_k) * pow((soil_water_mm - Ws_Wc) / (soil_capacity_mm - Ws_Wc), 2);
+  }
+  percola_ = percola_ > soil_potentialPercola_mm ? soil_potentialPercola_mm : percola_;
+  return percola_ > soil_water_mm ? soil_water_mm : percola_;
+}
+
+template <class T>
+inline T percola_GR4J(
+    T soil_water_mm,
+    T soil_capacity_mm
+)
+{
+  return soil_water_mm * (1 - pow((1 + pow(4.0/9.0 * soil_water_mm / soil_capacity_mm, 4)), -0.25));
+}
+
+// (1 + x^4)^-0.25 = 1 / sqrt(sqrt(1 + x^2 x^2))
+template <class T>
+inline T percola_GR4Jfast(
+    T soil_water_mm,
+    T soil_capacity_mm
+)
+{
+  T x_ = 4.0/9.0 * soil_water_mm / soil_capacity_mm;
+  T x2_ = x_ * x_;
+  return soil_water_mm * (1 - 1 / sqrt(sqrt(1 + x2_ * x2_)));
+}
+
+template <class T>
+inline T percola_GR4Jfix(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_percola_grf_k
+)
+{
+  return soil_water_mm * (1 - pow((1 + pow(param_percola_grf_k * soil_water_mm / soil_capacity_mm, 4)), -0.25));
+}
+
+template <class T>
+inline T percola_MaxPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialPercola_mm,
+    T param_percola_map_gamma
+)
+{
+  T percola_ = soil_potentialPercola_mm * pow(soil_water_mm / soil_capacity_mm, param_percola_map_gamma);
+  return percola_ > soil_water_mm ? soil_water_mm : percola_;
+}
+
+template <class T>
+inline T percola_ThreshPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialPercola_mm,
+    T param_percola_thp_thresh,
+    T param_percola_thp_gamma
+)
+{
+  T percola_temp = (soil_water_mm / soil_capacity_mm - param_percola_thp_thresh);
+  percola_temp = percola_temp < 0 ? 0 : percola_temp;
+  T percola_ = soil_potentialPercola_mm * pow(percola_temp / (1 - param_percola_thp_thresh), param_percola_thp_gamma);
+  percola_ = percola_ > soil_potentialPercola_mm ? soil_potentialPercola_mm : percola_;
+  return percola_ > soil_water_mm ? soil_water_mm : percola_;
+}
+
+template <class T>
+inline T percola_BevenWood(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_fieldCapacityPerc_1,
+    T soil_potentialPercola_mm
+)
+{
+  T soil_percolaAvilibale_mm = soil_water_mm - soil_capacity_mm * (1-soil_fieldCapacityPerc_1);
+  soil_percolaAvilibale_mm = soil_percolaAvilibale_mm < 0 ? 0 : soil_percolaAvilibale_mm;
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < soil_water_mm ? soil_water_mm : soil_diff_mm;
+  T k_ = soil_water_mm / soil_diff_mm;
+  T soil_percola_mm = k_ * soil_potentialPercola_mm;
+  soil_percola_mm = soil_water_mm > soil_percolaAvilibale_mm ? soil_percola_mm : 0.0;
+  return soil_percola_mm > soil_percolaAvilibale_mm ? soil_percolaAvilibale_mm : soil_percola_mm;
+}
+
+template <class T>
+inline T percola_SupplyPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_percola_sup_k,
+    T param_percola_sup_gamma
+)
+{
+  T k_ = param_percola_sup_k * pow((soil_water_mm / soil_capacity_mm), param_percola_sup_gamma);
+  T soil_percola_mm = k_ * soil_water_mm;
+  return soil_percola_mm > soil_water_mm ? soil_water_mm : soil_percola_mm;
+}
+
+template <class T>
+inline T percola_SupplyRatio(
+    T soil_water_mm,
+    T param_percola_sur_k
+)
+{
+  return param_percola_sur_k * soil_water_mm;
+}
+
+// inteflow ----------
+
+template <class T>
+inline T inteflow_GR4Jfix(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_inteflow_grf_k,
+    T param_inteflow_grf_gamma
+)
+{
+  return soil_water_mm * (1 - pow((1 + pow(param_inteflow_grf_k * soil_water_mm / soil_capacity_mm, param_inteflow_grf_gamma)), -1.0 / param_inteflow_grf_gamma));
+}
+
+template <class T>
+inline T inteflow_MaxPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialInteflow_mm,
+    T param_inteflow_map_gamma
+)
+{
+  T inteflow_ = soil_potentialInteflow_mm * pow(soil_water_mm / soil_capacity_mm, param_inteflow_map_gamma);
+  return inteflow_ > soil_water_mm ? soil_water_mm : inteflow_;
+}
+
+template <class T>
+inline T inteflow_ThreshPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialInteflow_mm,
+    T param_inteflow_thp_thresh,
+    T param_inteflow_thp_gamma
+)
+{
+  T inteflow_temp = (soil_water_mm / soil_capacity_mm - param_inteflow_thp_thresh);
+  inteflow_temp = inteflow_temp < 0 ? 0 : inteflow_temp;
+  T inteflow_ = soil_potentialInteflow_mm * pow(inteflow_temp / (1 - param_inteflow_thp_thresh), param_inteflow_thp_gamma);
+  inteflow_ = inteflow_ > soil_potentialInteflow_mm ? soil_potentialInteflow_mm : inteflow_;
+  return inteflow_ > soil_water_mm ? soil_water_mm : inteflow_;
+}
+
+template <class T>
+inline T inteflow_Arno(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialInteflow_mm,
+    T param_inteflow_arn_thresh,
+    T param_inteflow_arn_k
+)
+{
+  T Ws_Wc = soil_capacity_mm * param_inteflow_arn_thresh;
+  T inteflow_;
+  if (soil_potentialInteflow_mm > Ws_Wc) {
+    inteflow_ = soil_water_mm;
+  } else if (soil_water_mm < Ws_Wc) {
+    inteflow_ = param_inteflow_arn_k * soil_potentialInteflow_mm / (soil_capacity_mm) * soil_water_mm;
+  } else {
+    inteflow_ = param_inteflow_arn_k * soil_potentialInteflow_mm / (soil_capacity_mm) * soil_water_mm + soil_potentialInteflow_mm * (1 - param_inteflow_arn_k) * pow((soil_water_mm - Ws_Wc) / (soil_capacity_mm - Ws_Wc), 2);
+  }
+  inteflow_ = inteflow_ > soil_potentialInteflow_mm ? soil_potentialInteflow_mm : inteflow_;
+  return inteflow_ > soil_water_mm ? soil_water_mm : inteflow_;
+}
+
+template <class T>
+inline T inteflow_BevenWood(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_fieldCapacityPerc_1,
+    T soil_potentialInteflow_mm
+)
+{
+  T soil_inteflowAvilibale_mm = soil_water_mm - soil_capacity_mm * (1-soil_fieldCapacityPerc_1);
+  soil_inteflowAvilibale_mm = soil_inteflowAvilibale_mm < 0 ? 0 : soil_inteflowAvilibale_mm;
+  T soil_diff_mm = soil_capacity_mm - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < soil_water_mm ? soil_water_mm : soil_diff_mm;
+  T k_ = soil_water_mm / soil_diff_mm;
+  T soil_inteflow_mm = k_ * soil_potentialInteflow_mm;
+  soil_inteflow_mm = soil_water_mm > soil_inteflowAvilibale_mm ? soil_inteflow_mm : 0.0;
+  return soil_inteflow_mm > soil_inteflowAvilibale_mm ? soil_inteflowAvilibale_mm : soil_inteflow_mm;
+}
+
+template <class T>
+inline T inteflow_SupplyPow0(
+    T soil_water_mm,
+    T param_inteflow_sp0_k,
+    T param_inteflow_sp0_gamma
+)
+{
+  T inteflow_ = param_inteflow_sp0_k * pow(ceil(soil_water_mm), param_inteflow_sp0_gamma);
+  return inteflow_ > soil_water_mm ? soil_water_mm : inteflow_;
+}
+
+template <class T>
+inline T inteflow_SupplyPow(
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T param_inteflow_sup_k,
+    T param_inteflow_sup_gamma
+)
+{
+  T k_ = param_inteflow_sup_k * pow((soil_water_mm / soil_capacity_mm), param_inteflow_sup_gamma);
+  T soil_inteflow_mm = k_ * soil_water_mm;
+  return soil_inteflow_mm > soil_water_mm ? soil_water_mm : soil_inteflow_mm;
+}
+
+template <class T>
+inline T inteflow_SupplyRatio(
+    T soil_water_mm,
+    T param_inteflow_sur_k
+)
+{
+  return param_inteflow_sur_k * soil_water_mm;
+}
+
+// capirise ----------
+
+template <class T>
+inline T capirise_HBV(
+    T ground_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_potentialCapirise_mm
+)
+{
+  T soil_diff_mm = soil_capacity_mm  - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < 0 ? 0 : soil_diff_mm;
+  T capirise_mm = soil_potentialCapirise_mm * (soil_diff_mm / soil_capacity_mm);
+  T limit_mm = soil_diff_mm > ground_water_mm ? ground_water_mm : soil_diff_mm;
+  return capirise_mm > limit_mm ? limit_mm : capirise_mm;
+}
+
+template <class T>
+inline T capirise_HBVfix(
+    T ground_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_fieldCapacityPerc_1,
+    T soil_potentialCapirise_mm
+)
+{
+  T soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < 0 ? 0 : soil_diff_mm;
+  T capirise_mm = soil_potentialCapirise_mm * (soil_diff_mm / soil_capacity_mm);
+  T limit_mm = soil_diff_mm > ground_water_mm ? ground_water_mm : soil_diff_mm;
+  return capirise_mm > limit_mm ? limit_mm : capirise_mm;
+}
+
+template <class T>
+inline T capirise_AcceptRatio(
+    T ground_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_fieldCapacityPerc_1,
+    T param_capirise_acr_k
+)
+{
+  T soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < 0 ? 0 : soil_diff_mm;
+  T capirise_mm = soil_diff_mm * param_capirise_acr_k;
+  T limit_mm = soil_diff_mm > ground_water_mm ? ground_water_mm : soil_diff_mm;
+  return capirise_mm > limit_mm ? limit_mm : capirise_mm;
+}
+
+template <class T>
+inline T capirise_AcceptPow(
+    T ground_water_mm,
+    T soil_water_mm,
+    T soil_capacity_mm,
+    T soil_fieldCapacityPerc_1,
+    T param_capirise_acp_k,
+    T param_capirise_acp_gamma
+)
+{
+  T soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
+  soil_diff_mm = soil_diff_mm < 0 ? 0 : soil_diff_mm;
+  T k_ = param_capirise_acp_k * pow((soil_diff_mm / (soil_capacity_mm * (1 - soil_fieldCapacityPerc_1))), param_capirise_acp_gamma);
+  T capirise_mm = k_ * soil_diff_mm;
+  capirise_mm = capirise_mm < 0 ? 0 : capirise_mm;
+  T limit_mm = soil_diff_mm > ground_water_mm ? ground_water_mm : soil_diff_mm;
+  return capirise_mm > limit_mm ? limit_mm : capirise_mm;
+}
+
+// baseflow ----------
+
+template <class T>
+inline T baseflow_GR4J(
+    T ground_water_mm,
+    T ground_capacity_mm
+)
+{
+  T k_ = 1 - pow((1 + pow(ground_water_mm / ground_capacity_mm, 4)), -0.25);
+  T baseflow_ = k_ * ground_water_mm;
+
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+// (1 + x^4)^-0.25 = 1 / sqrt(sqrt(1 + x^2 x^2))
+template <class T>
+inline T baseflow_GR4Jfast(
+    T ground_water_mm,
+    T ground_capacity_mm
+)
+{
+  T x_ = ground_water_mm / ground_capacity_mm;
+  T x2_ = x_ * x_;
+  T k_ = 1 - 1 / sqrt(sqrt(1 + x2_ * x2_));
+  T baseflow_ = k_ * ground_water_mm;
+
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+template <class T>
+inline T baseflow_GR4Jfix(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T param_baseflow_grf_gamma
+)
+{
+  T k_ = 1 - pow((1 + pow(ground_water_mm / ground_capacity_mm, param_baseflow_grf_gamma)), -1.0 / param_baseflow_grf_gamma);
+  T baseflow_ = k_ * ground_water_mm;
+
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+template <class T>
+inline T baseflow_SupplyRatio(
+    T ground_water_mm,
+    T param_baseflow_sur_k
+)
+{
+  return param_baseflow_sur_k * ground_water_mm;
+}
+
+template <class T>
+inline T baseflow_SupplyPow(
+    T ground_water_mm,
+    T param_baseflow_sup_k,
+    T param_baseflow_sup_gamma
+)
+{
+  T baseflow_ = param_baseflow_sup_k * pow(ceil(ground_water_mm), param_baseflow_sup_gamma);
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+template <class T>
+inline T baseflow_MaxPow(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialBaseflow_mm,
+    T param_baseflow_map_gamma
+)
+{
+  T baseflow_ = ground_potentialBaseflow_mm * pow(ground_water_mm / ground_capacity_mm, param_baseflow_map_gamma);
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+template <class T>
+inline T baseflow_ThreshPow(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialBaseflow_mm,
+    T param_baseflow_thp_thresh,
+    T param_baseflow_thp_gamma
+)
+{
+  T baseflow_temp = (ground_water_mm / ground_capacity_mm - param_baseflow_thp_thresh);
+  baseflow_temp = baseflow_temp < 0 ? 0 : baseflow_temp;
+  T baseflow_ = ground_potentialBaseflow_mm * pow(baseflow_temp / (1 - param_baseflow_thp_thresh), param_baseflow_thp_gamma);
+  baseflow_ = baseflow_ > ground_potentialBaseflow_mm ? ground_potentialBaseflow_mm : baseflow_;
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+template <class T>
+inline T baseflow_Arno(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialBaseflow_mm,
+    T param_baseflow_arn_thresh,
+    T param_baseflow_arn_k
+)
+{
+  T Ws_Wc = ground_capacity_mm * param_baseflow_arn_thresh;
+  T baseflow_;
+  if (ground_potentialBaseflow_mm > Ws_Wc) {
+    baseflow_ = ground_water_mm;
+  } else if (ground_water_mm < Ws_Wc) {
+    baseflow_ = param_baseflow_arn_k * ground_potentialBaseflow_mm / (ground_capacity_mm) * ground_water_mm;
+  } else {
+    baseflow_ = param_baseflow_arn_k * ground_potentialBaseflow_mm / (ground_capacity_mm) * ground_water_mm + ground_potentialBaseflow_mm * (1 - param_baseflow_arn_k) * pow((ground_water_mm - Ws_Wc) / (ground_capacity_mm - Ws_Wc), 2);
+  }
+  baseflow_ = baseflow_ > ground_potentialBaseflow_mm ? ground_potentialBaseflow_mm : baseflow_;
+  return baseflow_ > ground_water_mm ? ground_water_mm : baseflow_;
+}
+
+// lateral ----------
+
+template <class T>
+inline T lateral_GR4J(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialLateral_mm
+)
+{
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  T ground_lateral_mm = ground_potentialLateral_mm * pow((ground_water_mm / ground_capacity_mm), 3.5);
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_GR4Jfast(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialLateral_mm
+)
+{
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  T ground_lateral_mm = ground_potentialLateral_mm * pow3_5(ground_water_mm / ground_capacity_mm);
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_SupplyPow(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T param_lateral_sup_k,
+    T param_lateral_sup_gamma
+)
+{
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  T k_ = param_lateral_sup_k * pow((ground_water_mm / ground_capacity_mm), param_lateral_sup_gamma);
+  T ground_lateral_mm = k_ * ground_water_mm;
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_SupplyRatio(
+    T ground_water_mm,
+    T param_lateral_sur_k
+)
+{
+  T ground_lateral_mm = param_lateral_sur_k * ground_water_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_GR4Jfix(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialLateral_mm,
+    T param_lateral_grf_gamma
+)
+{
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  T ground_lateral_mm = ground_potentialLateral_mm * pow((ground_water_mm / ground_capacity_mm), param_lateral_grf_gamma);
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_ThreshPow(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialLateral_mm,
+    T param_lateral_thp_thresh,
+    T param_lateral_thp_gamma
+)
+{
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  T lateral_temp = (ground_water_mm / ground_capacity_mm - param_lateral_thp_thresh);
+  lateral_temp = lateral_temp < 0 ? 0 : lateral_temp;
+  T ground_lateral_mm = ground_potentialLateral_mm * pow(lateral_temp / (1 - param_lateral_thp_thresh), param_lateral_thp_gamma);
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+template <class T>
+inline T lateral_Arno(
+    T ground_water_mm,
+    T ground_capacity_mm,
+    T ground_potentialLateral_mm,
+    T param_lateral_arn_thresh,
+    T param_lateral_arn_k
+)
+{
+  T Ws_Wc = ground_capacity_mm * param_lateral_arn_thresh;
+  T ground_lateral_mm;
+  if (ground_potentialLateral_mm > Ws_Wc) {
+    ground_lateral_mm = ground_water_mm;
+  } else if (ground_water_mm < Ws_Wc) {
+    ground_lateral_mm = param_lateral_arn_k * ground_potentialLateral_mm / (ground_capacity_mm) * ground_water_mm;
+  } else {
+    ground_lateral_mm = param_lateral_arn_k * ground_potentialLateral_mm / (ground_capacity_mm) * ground_water_mm + ground_potentialLateral_mm * (1 - param_lateral_arn_k) * pow((ground_water_mm - Ws_Wc) / (ground_capacity_mm - Ws_Wc), 2);
+  }
+  ground_lateral_mm = (ground_lateral_mm < ground_potentialLateral_mm) && (ground_potentialLateral_mm < 0.) ? ground_potentialLateral_mm : ground_lateral_mm;
+  ground_lateral_mm = (ground_lateral_mm > ground_potentialLateral_mm) && (ground_potentialLateral_mm > 0.) ? ground_potentialLateral_mm : ground_lateral_mm;
+  T ground_diff_mm = (ground_capacity_mm - ground_water_mm);
+  ground_lateral_mm = ground_lateral_mm > ground_diff_mm ? ground_diff_mm : ground_lateral_mm;
+  return ground_lateral_mm > - ground_water_mm ? ground_lateral_mm : - ground_water_mm;
+}
+
+} // namespace kernel
+} // namespace EDCHM
+
+#endif // EDCHM_KERNEL_H
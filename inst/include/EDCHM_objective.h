@@ -0,0 +1,164 @@
+// Defines a header file containing the objective functions of the calibration
+//
+// An objective is accumulated step by step while the model runs, so a
+// calibration or ensemble run does not need to keep the simulated series:
+// `gof_sum::add()` is fed with one simulated and observed value per step and the
+// NSE, KGE, RMSE, PBIAS and log-NSE are read from it at the end.
+// The mean, variance and covariance are updated online (Welford), which keeps
+// them as accurate as the two-pass formulas of `hydroGOF`. Steps with NaN (NA)
+// observation are left out, as `hydroGOF` does.
+// The sums of the simulation are templated on the scalar, with the dual number
+// of EDCHM_dual.h the objective carries its derivatives to the parameters.
+// The header is free of Rcpp.
+#ifndef EDCHM_OBJECTIVE_H
+#define EDCHM_OBJECTIVE_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace EDCHM {
+namespace objective {
+
+using std::log;
+using std::sqrt;
+
+// sums of one simulated series against the observation
+template <class T>
+struct basic_gof_sum {
+  double n = 0;
+  T mean_sim = 0;
+  double mean_obs = 0;
+  T M2_sim = 0;
+  double M2_obs = 0;
+  T C_simobs = 0, SSE = 0;
+  // the log-NSE is only summed when the accumulator is made with `log_epsilon`,
+  // sim and obs are shifted by it before the log
+  bool with_log = false;
+  double log_epsilon = 0, mean_logObs = 0, M2_logObs = 0;
+  T SSE_log = 0;
+
+  basic_gof_sum() {}
+  explicit basic_gof_sum(double log_epsilon_) : with_log(true), log_epsilon(log_epsilon_) {}
+
+  void add(T sim, double obs)
+  {
+    if (std::isnan(obs)) return;
+    n += 1;
+    T d_sim = sim - mean_sim;
+    double d_obs = obs - mean_obs;
+    mean_sim += d_sim / n;
+    mean_obs += d_obs / n;
+    M2_sim += d_sim * (sim - mean_sim);
+    M2_obs += d_obs * (obs - mean_obs);
+    C_simobs += d_sim * (obs - mean_obs);
+    SSE += (sim - obs) * (sim - obs);
+    if (with_log) {
+      T log_sim = log(sim + log_epsilon);
+      double log_obs = std::log(obs + log_epsilon);
+      double d_logObs = log_obs - mean_logObs;
+      mean_logObs += d_logObs / n;
+      M2_logObs += d_logObs * (log_obs - mean_logObs);
+      SSE_log += (log_sim - log_obs) * (log_sim - log_obs);
+    }
+  }
+
+  // Nash-Sutcliffe efficiency
+  T NSE() const
+  {
+    if (n < 1) return std::numeric_limits<double>::quiet_NaN();
+    return 1 - SSE / M2_obs;
+  }
+
+  // Kling-Gupta efficiency (2009), r the correlation, alpha the ratio of the
+  // standard deviations and beta the ratio of the means
+  T KGE() const
+  {
+    if (n < 1) return std::numeric_limits<double>::quiet_NaN();
+    T r_ = C_simobs / sqrt(M2_sim * M2_obs);
+    T alpha_ = sqrt(M2_sim / M2_obs);
+    T beta_ = mean_sim / mean_obs;
+    return 1 - sqrt((r_ - 1) * (r_ - 1) + (alpha_ - 1) * (alpha_ - 1) + (beta_ - 1) * (beta_ - 1));
+  }
+
+  // root mean square error
+  T RMSE() const
+  {
+    if (n < 1) return std::numeric_limits<double>::quiet_NaN();
+    return sqrt(SSE / n);
+  }
+
+  // percent bias, 100 * sum(sim - obs) / sum(obs)
+  T PBIAS() const
+  {
+    if (n < 1) return std::numeric_limits<double>::quiet_NaN();
+    return 100 * (mean_sim - mean_obs) / mean_obs;
+  }
+
+  // NSE of log(flow + log_epsilon), weights the low flows
+  T logNSE() const
+  {
+    if (n < 1 || !with_log) return std::numeric_limits<double>::quiet_NaN();
+    return 1 - SSE_log / M2_logObs;
+  }
+};
+
+typedef basic_gof_sum<double> gof_sum;
+
+// names of the objectives, the index in the list is the `gof_value()` index
+inline const std::vector<std::string> gof_name = {"NSE", "KGE", "RMSE", "PBIAS", "logNSE"};
+
+// index of the objective, -1 when there is none of the name
+inline int gof_index(const std::string& name)
+{
+  for (std::size_t k = 0; k < gof_name.size(); k++) if (gof_name[k] == name) return k;
+  return -1;
+}
+
+template <class T>
+inline T gof_value(const basic_gof_sum<T>& gof_, int k)
+{
+  switch (k) {
+  case 0: return gof_.NSE();
+  case 1: return gof_.KGE();
+  case 2: return gof_.RMSE();
+  case 3: return gof_.PBIAS();
+  default: return gof_.logNSE();
+  }
+}
+
+// The fitness of a calibration is minimised: `1 - value` for the efficiencies
+// (optimum 1), the RMSE itself and the absolute PBIAS. `gof_unfitness()` turns a
+// fitness back into the objective (for the PBIAS its absolute value).
+inline double gof_fitness(double value, int k)
+{
+  switch (k) {
+  case 2: return value;
+  case 3: return std::fabs(value);
+  default: return 1 - value;
+  }
+}
+
+inline double gof_unfitness(double fitness, int k)
+{
+  return k == 2 || k == 3 ? fitness : 1 - fitness;
+}
+
+// epsilon of the log-NSE, 1 % of the mean observation (Pushpalatha et al. 2012,
+// the default of `hydroGOF`), so a flow of zero has a finite log
+inline double gof_logEpsilon(const double* observe, int n_time)
+{
+  double n_ = 0, sum_ = 0;
+  for (int i = 0; i < n_time; i++) {
+    if (std::isnan(observe[i])) continue;
+    n_ += 1;
+    sum_ += observe[i];
+  }
+  return n_ > 0 ? sum_ / n_ / 100 : 0.0;
+}
+
+} // namespace objective
+} // namespace EDCHM
+
+#endif // EDCHM_OBJECTIVE_H
@@ -0,0 +1,255 @@
+// Defines a header file for the parameter sensitivities of the lumped models
+//
+// `EDCHM_GR4J_sensitivity()` and `EDCHM_mini_sensitivity()` run one parameter
+// set of the lumped model with the dual numbers of EDCHM_dual.h: the K seeded
+// parameters carry their derivatives through the same kernels, steps and
+// routing as the `double` model, so one pass gives the stream flow, its
+// derivative to every seeded parameter at every step, and with an observation
+// the objective (EDCHM_objective.h) and its gradient. The stream flow is the
+// same as the one of `EDCHM_GR4J()` / `EDCHM_mini()` with `n_spat = 1`.
+// The derivatives are the ones of the branch every step takes, a threshold
+// (e.g. the soil at capacity) or the length of an IUH (rounded up from the
+// response time) has no derivative.
+// The parameters are in the order of `EDCHM_*_ensembleParam`, the width of the
+// duals (4, 8 or 16) is chosen from K, so at most 16 parameters are seeded.
+// The header is free of Rcpp.
+#ifndef EDCHM_SENSITIVITY_H
+#define EDCHM_SENSITIVITY_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EDCHM_dual.h"
+#include "EDCHM_ensemble.h"
+
+namespace EDCHM {
+namespace core {
+
+// GR4J of one unit on the scalar T, `step_(i, Q)` takes the stream flow of every step
+template <class T, class Step>
+inline void sensitivity_GR4J(
+    int n_time,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const T* param,
+    Step step_
+)
+{
+  enum { P_S, P_R, P_X_1, P_X_2, P_X_3, P_X_4 };
+  std::vector<T> UH_2 = kernel::confluenIUH_GR4J2(param[P_X_4], true), UH_1 = kernel::confluenIUH_GR4J1(param[P_X_4], true);
+  int n_UH_2 = UH_2.size(), n_UH_1 = UH_1.size();
+  std::vector<T> ring_Pr_1(2 * n_UH_2), ring_Pr_9(2 * n_UH_1);
+  int head_1 = 0, head_9 = 0;
+  T S_ = param[P_S], R_ = param[P_R], X_1 = param[P_X_1], X_2 = param[P_X_2], X_3 = param[P_X_3];
+
+  for (int i= 0; i < n_time; i++) {
+
+    double P_ = atmos_precipitation_mm[i];
+    double E_ = atmos_potentialEvatrans_mm[i];
+
+    T P_n = P_ > E_ ? P_ - E_ : 0.0;
+    T E_n = P_ > E_ ? 0.0 : E_ - P_;
+    P_n = P_n > 13 * X_1 ? 13 * X_1 : P_n;
+    E_n = E_n > 13 * X_1 ? 13 * X_1 : E_n;
+    T P_s = kernel::infilt_GR4J(P_n, S_, X_1);
+    T E_s = kernel::evatransActual_GR4J(E_n, S_, X_1);
+
+    S_ += (P_s - E_s);
+
+    T Perc_ = kernel::percola_GR4Jfast(S_, X_1);
+    S_ +=  - Perc_;
+
+    T P_r = (P_n - P_s + Perc_);
+    P_r = P_r < 0 ? 0 : P_r;
+
+    T Q_1 = 0.0, Q_9 = 0.0;
+    if (n_UH_2 > 0) {
+      head_1 = kernel::confluen_ringHead(head_1, n_UH_2);
+      Q_1 = kernel::confluen_ringStep(n_UH_2, ring_Pr_1.data(), head_1, 0.1 * P_r, UH_2.data());
+    }
+    if (n_UH_1 > 0) {
+      head_9 = kernel::confluen_ringHead(head_9, n_UH_1);
+      Q_9 = kernel::confluen_ringStep(n_UH_1, ring_Pr_9.data(), head_9, 0.9 * P_r, UH_1.data());
+    }
+
+    T F_ = kernel::lateral_GR4Jfast(R_, X_3, X_2);
+    T Q_d = (Q_1 + F_) > 0.0 ? Q_1 + F_ : 0;
+
+    R_ += (Q_9 + F_);
+    R_ = R_ > 0.0 ? R_ : 0.0;
+    T Q_r = kernel::baseflow_GR4Jfast(R_, X_3);
+    R_ +=  - Q_r;
+
+    step_(i, Q_r + Q_d);
+  }
+}
+
+// mini of one unit on the scalar T, the same steps and routing as `EDCHM_mini()`
+template <class T, class Step>
+inline void sensitivity_mini(
+    int n_time,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const T* param,
+    Step step_
+)
+{
+  enum { P_ground_capacity, P_ground_water, P_land_impermeableFrac, P_soil_capacity,
+         P_soil_potentialPercola, P_soil_water, P_confluenLand_responseTime, P_confluenGround_responseTime,
+         P_baseflow_grf_gamma, P_confluenLand_kel_k, P_evatrans_ubc_gamma, P_infilt_ubc_P0AGEN,
+         P_percola_arn_k, P_percola_arn_thresh };
+  compose::basic_cell<T> c_;
+  c_.soil_water_mm = param[P_soil_water]; c_.ground_water_mm = param[P_ground_water];
+  compose::basic_param<T> p_;
+  p_.soil_capacity_mm = param[P_soil_capacity]; p_.ground_capacity_mm = param[P_ground_capacity]; p_.land_impermeableFrac_1 = param[P_land_impermeableFrac]; p_.soil_potentialPercola_mm = param[P_soil_potentialPercola];
+  p_.param_baseflow_grf_gamma = param[P_baseflow_grf_gamma]; p_.param_evatrans_ubc_gamma = param[P_evatrans_ubc_gamma]; p_.param_infilt_ubc_P0AGEN = param[P_infilt_ubc_P0AGEN];
+  p_.param_percola_arn_k = param[P_percola_arn_k]; p_.param_percola_arn_thresh = param[P_percola_arn_thresh];
+
+  std::vector<T> iuhLand = kernel::confluenIUH_Kelly(param[P_confluenLand_responseTime], param[P_confluenLand_kel_k]);
+  std::vector<T> iuhGround = kernel::confluenIUH_GR4J1(param[P_confluenGround_responseTime]);
+  int n_iuhLand = std::min((int)iuhLand.size(), n_time), n_iuhGround = std::min((int)iuhGround.size(), n_time);
+  std::vector<T> confluenLand_ring(2 * n_iuhLand), confluenGround_ring(2 * n_iuhGround);
+  int headLand = 0, headGround = 0;
+
+  for (int i= 0; i < n_time; i++) {
+
+    c_.atmos_potentialEvatrans_mm = atmos_potentialEvatrans_mm[i];
+    c_.atmos_precipitation_mm = atmos_precipitation_mm[i];
+    modell_mini::step(c_, p_);
+
+    T Q_land = 0.0, Q_ground = 0.0;
+    if (n_iuhLand > 0) {
+      headLand = kernel::confluen_ringHead(headLand, n_iuhLand);
+      Q_land = kernel::confluen_ringStep(n_iuhLand, confluenLand_ring.data(), headLand, c_.land_runoff_mm, iuhLand.data());
+    }
+    if (n_iuhGround > 0) {
+      headGround = kernel::confluen_ringHead(headGround, n_iuhGround);
+      Q_ground = kernel::confluen_ringStep(n_iuhGround, confluenGround_ring.data(), headGround, c_.ground_baseflow_mm, iuhGround.data());
+    }
+    step_(i, Q_land + Q_ground);
+  }
+}
+
+// The model run on `dual<N>` with the parameters `seed` seeded: the stream flow
+// (n_time), its derivatives (n_time x K, column major) and, with `objective_k`
+// >= 0, the objective and its gradient (K) against `observe`.
+template <int N, class Modell>
+inline void sensitivity_seeded(
+    Modell modell_,
+    int n_time,
+    const std::vector<double>& param,
+    const std::vector<int>& seed,
+    view<const double> observe,
+    const objective::gof_sum& gof_0,
+    int objective_k,
+    double* out_streamflow,
+    double* out_sensitivity,
+    double* out_objective,
+    double* out_gradient
+)
+{
+  int n_seed = seed.size();
+  std::vector<dual<N>> param_(param.begin(), param.end());
+  for (int k = 0; k < n_seed; k++) param_[seed[k]] = dual<N>::seed(param[seed[k]], k);
+  objective::basic_gof_sum<dual<N>> gof_;
+  if (gof_0.with_log) gof_ = objective::basic_gof_sum<dual<N>>(gof_0.log_epsilon);
+
+  modell_(param_.data(), [&](int i, const dual<N>& Q_) {
+    out_streamflow[i] = Q_.v;
+    for (int k = 0; k < n_seed; k++) out_sensitivity[(std::size_t)k * n_time + i] = Q_.d[k];
+    if (objective_k >= 0) gof_.add(Q_, observe[i]);
+  });
+
+  if (objective_k < 0) return;
+  dual<N> value_ = objective::gof_value(gof_, objective_k);
+  *out_objective = value_.v;
+  for (int k = 0; k < n_seed; k++) out_gradient[k] = value_.d[k];
+}
+
+template <class Modell>
+inline void sensitivity_call(
+    Modell modell_,
+    const std::vector<std::string>& param_name,
+    int n_time,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<double>& param,
+    const std::vector<int>& seed,
+    view<const double> observe,
+    const objective::gof_sum& gof_0,
+    int objective_k,
+    double* out_streamflow,
+    double* out_sensitivity,
+    double* out_objective,
+    double* out_gradient
+)
+{
+  if (n_time < 1) throw std::invalid_argument("`n_time` must be at least 1.");
+  if ((int)atmos_potentialEvatrans_mm.size() < n_time) throw std::invalid_argument("`atmos_potentialEvatrans_mm` must have at least `n_time` values.");
+  if ((int)atmos_precipitation_mm.size() < n_time) throw std::invalid_argument("`atmos_precipitation_mm` must have at least `n_time` values.");
+  if (param.size() != param_name.size()) throw std::invalid_argument("`param` must have one value for every parameter of the model.");
+  if (seed.size() > 16) throw std::invalid_argument("at most 16 parameters can be in `sensitivity_param`.");
+  for (std::size_t k = 0; k < seed.size(); k++) {
+    if (seed[k] < 0 || seed[k] >= (int)param_name.size()) throw std::invalid_argument("the parameter of the sensitivity is not one of the model.");
+    if (std::count(seed.begin(), seed.end(), seed[k]) > 1) throw std::invalid_argument("every parameter can only be in `sensitivity_param` once.");
+  }
+  if (objective_k >= 0 && (int)observe.size() < n_time) throw std::invalid_argument("`observe` must have at least `n_time` values.");
+
+  if (seed.size() <= 4) sensitivity_seeded<4>(modell_, n_time, param, seed, observe, gof_0, objective_k, out_streamflow, out_sensitivity, out_objective, out_gradient);
+  else if (seed.size() <= 8) sensitivity_seeded<8>(modell_, n_time, param, seed, observe, gof_0, objective_k, out_streamflow, out_sensitivity, out_objective, out_gradient);
+  else sensitivity_seeded<16>(modell_, n_time, param, seed, observe, gof_0, objective_k, out_streamflow, out_sensitivity, out_objective, out_gradient);
+}
+
+// `param` in the order of `EDCHM_GR4J_ensembleParam`, `seed` the indices of
+// the K parameters of the derivatives, `objective_k` the `gof_value()` index or
+// -1, `out_sensitivity` n_time x K, `out_gradient` K
+inline void EDCHM_GR4J_sensitivity(
+    int n_time,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<double>& param,
+    const std::vector<int>& seed,
+    view<const double> observe,
+    const objective::gof_sum& gof_0,
+    int objective_k,
+    double* out_streamflow,
+    double* out_sensitivity,
+    double* out_objective,
+    double* out_gradient
+)
+{
+  auto modell_ = [&](const auto* param_, auto step_) {
+    sensitivity_GR4J(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param_, step_);
+  };
+  sensitivity_call(modell_, EDCHM_GR4J_ensembleParam, n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, seed,
+                   observe, gof_0, objective_k, out_streamflow, out_sensitivity, out_objective, out_gradient);
+}
+
+// `param` in the order of `EDCHM_mini_ensembleParam`, the rest as `EDCHM_GR4J_sensitivity()`
+inline void EDCHM_mini_sensitivity(
+    int n_time,
+    view<const double> atmos_potentialEvatrans_mm,
+    view<const double> atmos_precipitation_mm,
+    const std::vector<double>& param,
+    const std::vector<int>& seed,
+    view<const double> observe,
+    const objective::gof_sum& gof_0,
+    int objective_k,
+    double* out_streamflow,
+    double* out_sensitivity,
+    double* out_objective,
+    double* out_gradient
+)
+{
+  auto modell_ = [&](const auto* param_, auto step_) {
+    sensitivity_mini(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param_, step_);
+  };
+  sensitivity_call(modell_, EDCHM_mini_ensembleParam, n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, seed,
+                   observe, gof_0, objective_k, out_streamflow, out_sensitivity, out_objective, out_gradient);
+}
+
+} // namespace core
+} // namespace EDCHM
+
+#endif // EDCHM_SENSITIVITY_H
@@ -0,0 +1,906 @@
+// Defines a header file containing the span form of the process kernels
+//
+// Every process method of EDCHM_kernel.h also runs over `n_spat` spatial units
+// stored in raw `double` arrays, the output is the last argument. The models
+// from `build_modell()` call these in their time loop instead of the Rcpp
+// modules, so the process math is compiled into the model and no step goes
+// through `R_GetCCallable()`, `RNGScope` or a SEXP.
+// The methods whose `pow()`, `exp()` or `tanh()` is on the common path run
+// through `span_math()`: in the strict mode of EDCHM_vecmath.h the plain loop
+// of the `double` kernel, in the fast mode the kernel with `vecmath::scalar`,
+// whose math calls of 64 units at a time go to the vector math. The kernel runs
+// once more per call, so the methods whose call is mostly skipped or cheap in
+// <cmath> (`*_Arno`, `*_ThreshPow`, `capirise_AcceptPow`,
+// `evatransActual_GR4J`, ...) keep the plain loop.
+// The header is free of Rcpp.
+#ifndef EDCHM_SPAN_H
+#define EDCHM_SPAN_H
+
+#include "EDCHM_kernel.h"
+#include "EDCHM_vecmath.h"
+
+namespace EDCHM {
+namespace span {
+
+// the input of the `double` kernel
+struct span_plain {
+  double operator()(double v_) const { return v_; }
+};
+
+// out[j] = f(j, in) for the `n_spat` units, `f` passes its inputs through `in`
+// (`span_plain` or a `vecmath::lane`) to the kernel
+template <class F>
+inline void span_math(int n_spat, double* out, F f)
+{
+  if (!vecmath::vec_on()) {
+    span_plain in_;
+    for (int j = 0; j < n_spat; j++) out[j] = f(j, in_);
+    return;
+  }
+  const int n_block = 64, n_kind = vecmath::MATH_tanh + 1;
+  vecmath::lane lane_[n_block];
+  int todo_[n_block], n_call[n_kind], call_[n_kind][n_block];
+  double x_[n_kind][n_block], y_[n_kind][n_block], r_[n_block];
+  vecmath::lane*& current_ = vecmath::lane_current();
+  for (int j_0 = 0; j_0 < n_spat; j_0 += n_block) {
+    int n_todo = n_spat - j_0 < n_block ? n_spat - j_0 : n_block;
+    for (int k = 0; k < n_todo; k++) {
+      lane_[k].round = 0;
+      todo_[k] = k;
+    }
+    while (n_todo > 0) {
+      // run the kernels, the units without a new call are done, the others
+      // put their call to the ones of its kind
+      int n_next = 0;
+      for (int kind = 0; kind < n_kind; kind++) n_call[kind] = 0;
+      for (int t = 0; t < n_todo; t++) {
+        int k = todo_[t];
+        vecmath::lane& l_ = lane_[k];
+        l_.n_call = 0;
+        l_.pending = false;
+        current_ = &l_;
+        double v_ = vecmath::scalar_value(f(j_0 + k, l_));
+        if (!l_.pending) {
+          out[j_0 + k] = v_;
+          continue;
+        }
+        todo_[n_next++] = k;
+        int kind_ = l_.kind[l_.round], c_ = n_call[kind_]++;
+        x_[kind_][c_] = l_.x[l_.round];
+        y_[kind_][c_] = l_.y[l_.round];
+        call_[kind_][c_] = k;
+      }
+      n_todo = n_next;
+      // one vector call per kind
+      for (int kind = 0; kind < n_kind; kind++) {
+        if (n_call[kind] == 0) continue;
+        vecmath::vec_run(kind, n_call[kind], x_[kind], y_[kind], r_);
+        for (int c = 0; c < n_call[kind]; c++) {
+          vecmath::lane& l_ = lane_[call_[kind][c]];
+          l_.result[l_.round++] = r_[c];
+        }
+      }
+    }
+  }
+  current_ = nullptr;
+}
+
+// atmos ----------
+
+inline void atmosSnow_ThresholdT(
+    int n_spat,
+    const double* atmos_precipitation_mm,
+    const double* atmos_temperature_Cel,
+    const double* param_atmos_thr_Ts,
+    double* atmos_snow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    atmos_snow_mm[j] = kernel::atmosSnow_ThresholdT(atmos_precipitation_mm[j], atmos_temperature_Cel[j], param_atmos_thr_Ts[j]);
+  }
+}
+
+inline void atmosSnow_UBC(
+    int n_spat,
+    const double* atmos_precipitation_mm,
+    const double* atmos_temperature_Cel,
+    const double* param_atmos_ubc_A0FORM,
+    double* atmos_snow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    atmos_snow_mm[j] = kernel::atmosSnow_UBC(atmos_precipitation_mm[j], atmos_temperature_Cel[j], param_atmos_ubc_A0FORM[j]);
+  }
+}
+
+// snow ----------
+
+inline void snowMelt_Kustas(
+    int n_spat,
+    const double* snow_ice_mm,
+    const double* atmos_temperature_Cel,
+    const double* atmos_netRadiat_MJ,
+    const double* param_snow_kus_fE,
+    const double* param_snow_kus_fT,
+    double* snow_melt_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    snow_melt_mm[j] = kernel::snowMelt_Kustas(snow_ice_mm[j], atmos_temperature_Cel[j], atmos_netRadiat_MJ[j], param_snow_kus_fE[j], param_snow_kus_fT[j]);
+  }
+}
+
+inline void snowMelt_Factor(
+    int n_spat,
+    const double* snow_ice_mm,
+    const double* atmos_temperature_Cel,
+    const double* param_snow_fac_f,
+    const double* param_snow_fac_Tmelt,
+    double* snow_melt_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    snow_melt_mm[j] = kernel::snowMelt_Factor(snow_ice_mm[j], atmos_temperature_Cel[j], param_snow_fac_f[j], param_snow_fac_Tmelt[j]);
+  }
+}
+
+// intercep ----------
+
+inline void intercep_Full(
+    int n_spat,
+    const double* atmos_precipitation_mm,
+    const double* land_interceptWater_mm,
+    const double* land_interceptCapacity_mm,
+    double* land_intercept_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    land_intercept_mm[j] = kernel::intercep_Full(atmos_precipitation_mm[j], land_interceptWater_mm[j], land_interceptCapacity_mm[j]);
+  }
+}
+
+// evatrans ----------
+
+inline void evatransPotential_TurcWendling(
+    int n_spat,
+    const double* atmos_temperature_Cel,
+    const double* atmos_solarRadiat_MJ,
+    const double* param_evatrans_tur_k,
+    double* atmos_potentialEvatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    atmos_potentialEvatrans_mm[j] = kernel::evatransPotential_TurcWendling(atmos_temperature_Cel[j], atmos_solarRadiat_MJ[j], param_evatrans_tur_k[j]);
+  }
+}
+
+inline void evatransPotential_Linacre(
+    int n_spat,
+    const double* atmos_temperature_Cel,
+    const double* atmos_relativeHumidity_1,
+    const double* land_latitude_Degree,
+    const double* land_elevation_m,
+    const double* land_albedo_1,
+    double* atmos_potentialEvatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    atmos_potentialEvatrans_mm[j] = kernel::evatransPotential_Linacre(atmos_temperature_Cel[j], atmos_relativeHumidity_1[j], land_latitude_Degree[j], land_elevation_m[j], land_albedo_1[j]);
+  }
+}
+
+inline void evatransPotential_FAO56(
+    int n_spat,
+    const double* atmos_temperature_Cel,
+    const double* atmos_vaporPress_hPa,
+    const double* atmos_saturatVaporPress_hPa,
+    const double* atmos_netRadiat_MJ,
+    const double* atmos_windSpeed2m_m_s,
+    const double* land_elevation_m,
+    double* atmos_potentialEvatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    atmos_potentialEvatrans_mm[j] = kernel::evatransPotential_FAO56(atmos_temperature_Cel[j], atmos_vaporPress_hPa[j], atmos_saturatVaporPress_hPa[j], atmos_netRadiat_MJ[j], atmos_windSpeed2m_m_s[j], land_elevation_m[j]);
+  }
+}
+
+inline void evatransActual_SupplyRatio(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_sur_k,
+    double* evatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    evatrans_mm[j] = kernel::evatransActual_SupplyRatio(atmos_potentialEvatrans_mm[j], water_mm[j], capacity_mm[j], param_evatrans_sur_k[j]);
+  }
+}
+
+inline void evatransActual_SupplyPow(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_sup_k,
+    const double* param_evatrans_sup_gamma,
+    double* evatrans_mm
+)
+{
+  span_math(n_spat, evatrans_mm, [&](int j, auto& in) {
+    return kernel::evatransActual_SupplyPow(in(atmos_potentialEvatrans_mm[j]), in(water_mm[j]), in(capacity_mm[j]), in(param_evatrans_sup_k[j]), in(param_evatrans_sup_gamma[j]));
+  });
+}
+
+inline void evatransActual_VIC(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_vic_gamma,
+    double* evatrans_mm
+)
+{
+  span_math(n_spat, evatrans_mm, [&](int j, auto& in) {
+    return kernel::evatransActual_VIC(in(atmos_potentialEvatrans_mm[j]), in(water_mm[j]), in(capacity_mm[j]), in(param_evatrans_vic_gamma[j]));
+  });
+}
+
+inline void evatransActual_UBC(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_ubc_gamma,
+    double* evatrans_mm
+)
+{
+  span_math(n_spat, evatrans_mm, [&](int j, auto& in) {
+    return kernel::evatransActual_UBC(in(atmos_potentialEvatrans_mm[j]), in(water_mm[j]), in(capacity_mm[j]), in(param_evatrans_ubc_gamma[j]));
+  });
+}
+
+inline void evatransActual_GR4J(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    double* evatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    evatrans_mm[j] = kernel::evatransActual_GR4J(atmos_potentialEvatrans_mm[j], water_mm[j], capacity_mm[j]);
+  }
+}
+
+inline void evatransActual_LiangLand(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_lia_gamma,
+    double* evatrans_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    evatrans_mm[j] = kernel::evatransActual_LiangLand(atmos_potentialEvatrans_mm[j], water_mm[j], capacity_mm[j], param_evatrans_lia_gamma[j]);
+  }
+}
+
+inline void evatransActual_LiangSoil(
+    int n_spat,
+    const double* atmos_potentialEvatrans_mm,
+    const double* water_mm,
+    const double* capacity_mm,
+    const double* param_evatrans_lia_B,
+    double* evatrans_mm
+)
+{
+  span_math(n_spat, evatrans_mm, [&](int j, auto& in) {
+    return kernel::evatransActual_LiangSoil(in(atmos_potentialEvatrans_mm[j]), in(water_mm[j]), in(capacity_mm[j]), in(param_evatrans_lia_B[j]));
+  });
+}
+
+// infilt ----------
+
+inline void infilt_UBC(
+    int n_spat,
+    const double* land_water_mm,
+    const double* land_impermeableFrac_1,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_ubc_P0AGEN,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_UBC(in(land_water_mm[j]), in(land_impermeableFrac_1[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_ubc_P0AGEN[j]));
+  });
+}
+
+inline void infilt_GR4J(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_GR4J(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]));
+  });
+}
+
+inline void infilt_SupplyRatio(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_sur_k,
+    double* soil_infilt_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_infilt_mm[j] = kernel::infilt_SupplyRatio(land_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], param_infilt_sur_k[j]);
+  }
+}
+
+inline void infilt_AcceptRatio(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_acr_k,
+    double* soil_infilt_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_infilt_mm[j] = kernel::infilt_AcceptRatio(land_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], param_infilt_acr_k[j]);
+  }
+}
+
+inline void infilt_SupplyPow(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_sup_k,
+    const double* param_infilt_sup_gamma,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_SupplyPow(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_sup_k[j]), in(param_infilt_sup_gamma[j]));
+  });
+}
+
+inline void infilt_AcceptPow(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_acp_k,
+    const double* param_infilt_acp_gamma,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_AcceptPow(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_acp_k[j]), in(param_infilt_acp_gamma[j]));
+  });
+}
+
+inline void infilt_HBV(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_hbv_beta,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_HBV(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_hbv_beta[j]));
+  });
+}
+
+inline void infilt_XAJ(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_xaj_B,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_XAJ(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_xaj_B[j]));
+  });
+}
+
+inline void infilt_VIC(
+    int n_spat,
+    const double* land_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_infilt_vic_B,
+    double* soil_infilt_mm
+)
+{
+  span_math(n_spat, soil_infilt_mm, [&](int j, auto& in) {
+    return kernel::infilt_VIC(in(land_water_mm[j]), in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_infilt_vic_B[j]));
+  });
+}
+
+// percola ----------
+
+inline void percola_Arno(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialPercola_mm,
+    const double* param_percola_arn_thresh,
+    const double* param_percola_arn_k,
+    double* soil_percolation_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_percolation_mm[j] = kernel::percola_Arno(soil_water_mm[j], soil_capacity_mm[j], soil_potentialPercola_mm[j], param_percola_arn_thresh[j], param_percola_arn_k[j]);
+  }
+}
+
+inline void percola_GR4J(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    double* soil_percolation_mm
+)
+{
+  span_math(n_spat, soil_percolation_mm, [&](int j, auto& in) {
+    return kernel::percola_GR4J(in(soil_water_mm[j]), in(soil_capacity_mm[j]));
+  });
+}
+
+inline void percola_GR4Jfix(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_percola_grf_k,
+    double* soil_percolation_mm
+)
+{
+  span_math(n_spat, soil_percolation_mm, [&](int j, auto& in) {
+    return kernel::percola_GR4Jfix(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_percola_grf_k[j]));
+  });
+}
+
+inline void percola_MaxPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialPercola_mm,
+    const double* param_percola_map_gamma,
+    double* soil_percolation_mm
+)
+{
+  span_math(n_spat, soil_percolation_mm, [&](int j, auto& in) {
+    return kernel::percola_MaxPow(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(soil_potentialPercola_mm[j]), in(param_percola_map_gamma[j]));
+  });
+}
+
+inline void percola_ThreshPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialPercola_mm,
+    const double* param_percola_thp_thresh,
+    const double* param_percola_thp_gamma,
+    double* soil_percolation_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_percolation_mm[j] = kernel::percola_ThreshPow(soil_water_mm[j], soil_capacity_mm[j], soil_potentialPercola_mm[j], param_percola_thp_thresh[j], param_percola_thp_gamma[j]);
+  }
+}
+
+inline void percola_BevenWood(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_fieldCapacityPerc_1,
+    const double* soil_potentialPercola_mm,
+    double* soil_percolation_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_percolation_mm[j] = kernel::percola_BevenWood(soil_water_mm[j], soil_capacity_mm[j], soil_fieldCapacityPerc_1[j], soil_potentialPercola_mm[j]);
+  }
+}
+
+inline void percola_SupplyPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_percola_sup_k,
+    const double* param_percola_sup_gamma,
+    double* soil_percolation_mm
+)
+{
+  span_math(n_spat, soil_percolation_mm, [&](int j, auto& in) {
+    return kernel::percola_SupplyPow(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_percola_sup_k[j]), in(param_percola_sup_gamma[j]));
+  });
+}
+
+inline void percola_SupplyRatio(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* param_percola_sur_k,
+    double* soil_percolation_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_percolation_mm[j] = kernel::percola_SupplyRatio(soil_water_mm[j], param_percola_sur_k[j]);
+  }
+}
+
+// inteflow ----------
+
+inline void inteflow_GR4Jfix(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_inteflow_grf_k,
+    const double* param_inteflow_grf_gamma,
+    double* soil_interflow_mm
+)
+{
+  span_math(n_spat, soil_interflow_mm, [&](int j, auto& in) {
+    return kernel::inteflow_GR4Jfix(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_inteflow_grf_k[j]), in(param_inteflow_grf_gamma[j]));
+  });
+}
+
+inline void inteflow_MaxPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialInteflow_mm,
+    const double* param_inteflow_map_gamma,
+    double* soil_interflow_mm
+)
+{
+  span_math(n_spat, soil_interflow_mm, [&](int j, auto& in) {
+    return kernel::inteflow_MaxPow(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(soil_potentialInteflow_mm[j]), in(param_inteflow_map_gamma[j]));
+  });
+}
+
+inline void inteflow_ThreshPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialInteflow_mm,
+    const double* param_inteflow_thp_thresh,
+    const double* param_inteflow_thp_gamma,
+    double* soil_interflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_interflow_mm[j] = kernel::inteflow_ThreshPow(soil_water_mm[j], soil_capacity_mm[j], soil_potentialInteflow_mm[j], param_inteflow_thp_thresh[j], param_inteflow_thp_gamma[j]);
+  }
+}
+
+inline void inteflow_Arno(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialInteflow_mm,
+    const double* param_inteflow_arn_thresh,
+    const double* param_inteflow_arn_k,
+    double* soil_interflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_interflow_mm[j] = kernel::inteflow_Arno(soil_water_mm[j], soil_capacity_mm[j], soil_potentialInteflow_mm[j], param_inteflow_arn_thresh[j], param_inteflow_arn_k[j]);
+  }
+}
+
+inline void inteflow_BevenWood(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_fieldCapacityPerc_1,
+    const double* soil_potentialInteflow_mm,
+    double* soil_interflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_interflow_mm[j] = kernel::inteflow_BevenWood(soil_water_mm[j], soil_capacity_mm[j], soil_fieldCapacityPerc_1[j], soil_potentialInteflow_mm[j]);
+  }
+}
+
+inline void inteflow_SupplyPow0(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* param_inteflow_sp0_k,
+    const double* param_inteflow_sp0_gamma,
+    double* soil_interflow_mm
+)
+{
+  span_math(n_spat, soil_interflow_mm, [&](int j, auto& in) {
+    return kernel::inteflow_SupplyPow0(in(soil_water_mm[j]), in(param_inteflow_sp0_k[j]), in(param_inteflow_sp0_gamma[j]));
+  });
+}
+
+inline void inteflow_SupplyPow(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* param_inteflow_sup_k,
+    const double* param_inteflow_sup_gamma,
+    double* soil_interflow_mm
+)
+{
+  span_math(n_spat, soil_interflow_mm, [&](int j, auto& in) {
+    return kernel::inteflow_SupplyPow(in(soil_water_mm[j]), in(soil_capacity_mm[j]), in(param_inteflow_sup_k[j]), in(param_inteflow_sup_gamma[j]));
+  });
+}
+
+inline void inteflow_SupplyRatio(
+    int n_spat,
+    const double* soil_water_mm,
+    const double* param_inteflow_sur_k,
+    double* soil_interflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    soil_interflow_mm[j] = kernel::inteflow_SupplyRatio(soil_water_mm[j], param_inteflow_sur_k[j]);
+  }
+}
+
+// capirise ----------
+
+inline void capirise_HBV(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_potentialCapirise_mm,
+    double* ground_capilarise_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_capilarise_mm[j] = kernel::capirise_HBV(ground_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], soil_potentialCapirise_mm[j]);
+  }
+}
+
+inline void capirise_HBVfix(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_fieldCapacityPerc_1,
+    const double* soil_potentialCapirise_mm,
+    double* ground_capilarise_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_capilarise_mm[j] = kernel::capirise_HBVfix(ground_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], soil_fieldCapacityPerc_1[j], soil_potentialCapirise_mm[j]);
+  }
+}
+
+inline void capirise_AcceptRatio(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_fieldCapacityPerc_1,
+    const double* param_capirise_acr_k,
+    double* ground_capilarise_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_capilarise_mm[j] = kernel::capirise_AcceptRatio(ground_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], soil_fieldCapacityPerc_1[j], param_capirise_acr_k[j]);
+  }
+}
+
+inline void capirise_AcceptPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* soil_water_mm,
+    const double* soil_capacity_mm,
+    const double* soil_fieldCapacityPerc_1,
+    const double* param_capirise_acp_k,
+    const double* param_capirise_acp_gamma,
+    double* ground_capilarise_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_capilarise_mm[j] = kernel::capirise_AcceptPow(ground_water_mm[j], soil_water_mm[j], soil_capacity_mm[j], soil_fieldCapacityPerc_1[j], param_capirise_acp_k[j], param_capirise_acp_gamma[j]);
+  }
+}
+
+// baseflow ----------
+
+inline void baseflow_GR4J(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    double* ground_baseflow_mm
+)
+{
+  span_math(n_spat, ground_baseflow_mm, [&](int j, auto& in) {
+    return kernel::baseflow_GR4J(in(ground_water_mm[j]), in(ground_capacity_mm[j]));
+  });
+}
+
+inline void baseflow_GR4Jfix(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* param_baseflow_grf_gamma,
+    double* ground_baseflow_mm
+)
+{
+  span_math(n_spat, ground_baseflow_mm, [&](int j, auto& in) {
+    return kernel::baseflow_GR4Jfix(in(ground_water_mm[j]), in(ground_capacity_mm[j]), in(param_baseflow_grf_gamma[j]));
+  });
+}
+
+inline void baseflow_SupplyRatio(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* param_baseflow_sur_k,
+    double* ground_baseflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_baseflow_mm[j] = kernel::baseflow_SupplyRatio(ground_water_mm[j], param_baseflow_sur_k[j]);
+  }
+}
+
+inline void baseflow_SupplyPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* param_baseflow_sup_k,
+    const double* param_baseflow_sup_gamma,
+    double* ground_baseflow_mm
+)
+{
+  span_math(n_spat, ground_baseflow_mm, [&](int j, auto& in) {
+    return kernel::baseflow_SupplyPow(in(ground_water_mm[j]), in(param_baseflow_sup_k[j]), in(param_baseflow_sup_gamma[j]));
+  });
+}
+
+inline void baseflow_MaxPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialBaseflow_mm,
+    const double* param_baseflow_map_gamma,
+    double* ground_baseflow_mm
+)
+{
+  span_math(n_spat, ground_baseflow_mm, [&](int j, auto& in) {
+    return kernel::baseflow_MaxPow(in(ground_water_mm[j]), in(ground_capacity_mm[j]), in(ground_potentialBaseflow_mm[j]), in(param_baseflow_map_gamma[j]));
+  });
+}
+
+inline void baseflow_ThreshPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialBaseflow_mm,
+    const double* param_baseflow_thp_thresh,
+    const double* param_baseflow_thp_gamma,
+    double* ground_baseflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_baseflow_mm[j] = kernel::baseflow_ThreshPow(ground_water_mm[j], ground_capacity_mm[j], ground_potentialBaseflow_mm[j], param_baseflow_thp_thresh[j], param_baseflow_thp_gamma[j]);
+  }
+}
+
+inline void baseflow_Arno(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialBaseflow_mm,
+    const double* param_baseflow_arn_thresh,
+    const double* param_baseflow_arn_k,
+    double* ground_baseflow_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_baseflow_mm[j] = kernel::baseflow_Arno(ground_water_mm[j], ground_capacity_mm[j], ground_potentialBaseflow_mm[j], param_baseflow_arn_thresh[j], param_baseflow_arn_k[j]);
+  }
+}
+
+// lateral ----------
+
+inline void lateral_GR4J(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialLateral_mm,
+    double* ground_lateral_mm
+)
+{
+  span_math(n_spat, ground_lateral_mm, [&](int j, auto& in) {
+    return kernel::lateral_GR4J(in(ground_water_mm[j]), in(ground_capacity_mm[j]), in(ground_potentialLateral_mm[j]));
+  });
+}
+
+inline void lateral_SupplyPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* param_lateral_sup_k,
+    const double* param_lateral_sup_gamma,
+    double* ground_lateral_mm
+)
+{
+  span_math(n_spat, ground_lateral_mm, [&](int j, auto& in) {
+    return kernel::lateral_SupplyPow(in(ground_water_mm[j]), in(ground_capacity_mm[j]), in(param_lateral_sup_k[j]), in(param_lateral_sup_gamma[j]));
+  });
+}
+
+inline void lateral_SupplyRatio(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* param_lateral_sur_k,
+    double* ground_lateral_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_lateral_mm[j] = kernel::lateral_SupplyRatio(ground_water_mm[j], param_lateral_sur_k[j]);
+  }
+}
+
+inline void lateral_GR4Jfix(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialLateral_mm,
+    const double* param_lateral_grf_gamma,
+    double* ground_lateral_mm
+)
+{
+  span_math(n_spat, ground_lateral_mm, [&](int j, auto& in) {
+    return kernel::lateral_GR4Jfix(in(ground_water_mm[j]), in(ground_capacity_mm[j]), in(ground_potentialLateral_mm[j]), in(param_lateral_grf_gamma[j]));
+  });
+}
+
+inline void lateral_ThreshPow(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialLateral_mm,
+    const double* param_lateral_thp_thresh,
+    const double* param_lateral_thp_gamma,
+    double* ground_lateral_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_lateral_mm[j] = kernel::lateral_ThreshPow(ground_water_mm[j], ground_capacity_mm[j], ground_potentialLateral_mm[j], param_lateral_thp_thresh[j], param_lateral_thp_gamma[j]);
+  }
+}
+
+inline void lateral_Arno(
+    int n_spat,
+    const double* ground_water_mm,
+    const double* ground_capacity_mm,
+    const double* ground_potentialLateral_mm,
+    const double* param_lateral_arn_thresh,
+    const double* param_lateral_arn_k,
+    double* ground_lateral_mm
+)
+{
+  for (int j = 0; j < n_spat; j++) {
+    ground_lateral_mm[j] = kernel::lateral_Arno(ground_water_mm[j], ground_capacity_mm[j], ground_potentialLateral_mm[j], param_lateral_arn_thresh[j], param_lateral_arn_k[j]);
+  }
+}
+
+} // namespace span
+} // namespace EDCHM
+
+#endif // EDCHM_SPAN_H
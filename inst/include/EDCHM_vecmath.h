@@ -0,0 +1,346 @@
+// Defines a header file containing the vector math of the process functions
+//
+// `vec_exp()`, `vec_log()`, `vec_pow()`, `vec_pow10()` and `vec_tanh()` work on
+// arrays of n values. In the strict mode (the default) every value is the one
+// of <cmath> bit for bit, so the process functions, the models of
+// `build_modell()` and the drivers of EDCHM_core.h give the same results.
+// In the fast mode the values are computed 8 (AVX-512) or 4 (AVX2 with FMA) at
+// a time, as wide as the CPU allows (`simd_level()`, detected at run time); a
+// CPU without AVX2 and the values outside the domains below take <cmath>.
+// The largest errors of the fast mode against `long double`, in units in the
+// last place (ulp), from 10^7 random arguments per function and domain (<cmath>
+// of glibc in brackets):
+// - `exp`:   x in [-708, 709]                             0.53 ulp (0.51)
+// - `log`:   x normal and positive                        0.50 ulp (0.52)
+// - `pow`:   x normal and positive, |y ln(x)| <= 708      0.53 ulp (0.51)
+// - `pow10`: |y ln(10)| <= 708                            0.53 ulp (0.51)
+// - `tanh`:  |x| <= 22                                    0.51 ulp (2.2)
+// The exponential is a reduction by ln(2) / 32, a table of 2^(j/32) and a Taylor
+// polynomial; the logarithm a table of ln(i/32) and the atanh series, carried
+// as a double-double, so the error of `pow` does not grow with y. The lanes of
+// AVX2 and AVX-512 give the same bits, and a value does not depend on its place
+// in the array.
+// The mode is process-wide (`set_mode()`), R sets it with `EDCHM_mathMode()`.
+// `scalar` (below) lets a templated kernel hand its math to these functions, see
+// `span_math()` in EDCHM_span.h.
+// The header is free of Rcpp.
+#ifndef EDCHM_VECMATH_H
+#define EDCHM_VECMATH_H
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+// The SIMD code needs the vector extensions of GCC and Clang on x86-64. It is
+// left out on Windows, where the GCC of Rtools does not align the stack for the
+// spills of the 32 and 64 byte registers.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && !defined(_WIN32)
+#define EDCHM_VECMATH_SIMD 1
+#endif
+
+namespace EDCHM {
+namespace vecmath {
+
+enum math_mode { strict = 0, fast = 1 };
+
+inline std::atomic<int>& mode_current()
+{
+  static std::atomic<int> mode_(strict);
+  return mode_;
+}
+
+inline int mode() { return mode_current().load(std::memory_order_relaxed); }
+
+inline void set_mode(int mode_) { mode_current().store(mode_, std::memory_order_relaxed); }
+
+// 2 AVX-512, 1 AVX2 with FMA, 0 only <cmath>
+inline int simd_level()
+{
+  static const int level_ = [] {
+#ifdef EDCHM_VECMATH_SIMD
+    __builtin_cpu_init();
+    bool avx2_ = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (avx2_ && __builtin_cpu_supports("avx512f")) return 2;
+    if (avx2_) return 1;
+#endif
+    return 0;
+  }();
+  return level_;
+}
+
+enum math_kind { MATH_exp, MATH_log, MATH_pow, MATH_pow10, MATH_tanh };
+
+// the value of <cmath>
+inline double math_cmath(int kind, double x, double y)
+{
+  switch (kind) {
+  case MATH_exp: return std::exp(x);
+  case MATH_log: return std::log(x);
+  case MATH_pow: return std::pow(x, y);
+  case MATH_pow10: return std::pow(10.0, y);
+  default: return std::tanh(x);
+  }
+}
+
+#ifdef EDCHM_VECMATH_SIMD
+
+#define EDCHM_VECMATH_INLINE inline __attribute__((always_inline))
+
+typedef double v4d __attribute__((vector_size(32)));
+typedef unsigned long long v4u __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+typedef unsigned long long v8u __attribute__((vector_size(64)));
+
+const double lane_shift = 0x1.8p52;         // k + shift holds the integer k in its low bits
+const double lane_ln2Hi = 0x1.62e42feep-1;  // k ln2_hi is exact for |k| < 2^20
+const double lane_ln2Lo = 0x1.a39ef35793c76p-33;
+const double lane_log2e32 = 0x1.71547652b82fep5;  // 32 / ln(2)
+
+// 2^(j/32) as double-double, j = 0 ... 31
+const double lane_exp2Table[32][2] = {
+  {0x1.0000000000000p+0, 0x0.0p+0},
+  {0x1.059b0d3158574p+0, 0x1.d73e2a475b465p-55},
+  {0x1.0b5586cf9890fp+0, 0x1.8a62e4adc610bp-54},
+  {0x1.11301d0125b51p+0, -0x1.6c51039449b3ap-54},
+  {0x1.172b83c7d517bp+0, -0x1.19041b9d78a76p-55},
+  {0x1.1d4873168b9aap+0, 0x1.e016e00a2643cp-54},
+  {0x1.2387a6e756238p+0, 0x1.9b07eb6c70573p-54},
+  {0x1.29e9df51fdee1p+0, 0x1.612e8afad1255p-55},
+  {0x1.306fe0a31b715p+0, 0x1.6f46ad23182e4p-55},
+  {0x1.371a7373aa9cbp+0, -0x1.63aeabf42eae2p-54},
+  {0x1.3dea64c123422p+0, 0x1.ada0911f09ebcp-55},
+  {0x1.44e086061892dp+0, 0x1.89b7a04ef80d0p-59},
+  {0x1.4bfdad5362a27p+0, 0x1.d4397afec42e2p-56},
+  {0x1.5342b569d4f82p+0, -0x1.07abe1db13cadp-55},
+  {0x1.5ab07dd485429p+0, 0x1.6324c054647adp-54},
+  {0x1.6247eb03a5585p+0, -0x1.383c17e40b497p-54},
+  {0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54},
+  {0x1.71f75e8ec5f74p+0, -0x1.16e4786887a99p-55},
+  {0x1.7a11473eb0187p+0, -0x1.41577ee04992fp-55},
+  {0x1.82589994cce13p+0, -0x1.d4c1dd41532d8p-54},
+  {0x1.8ace5422aa0dbp+0, 0x1.6e9f156864b27p-54},
+  {0x1.93737b0cdc5e5p+0, -0x1.75fc781b57ebcp-57},
+  {0x1.9c49182a3f090p+0, 0x1.c7c46b071f2bep-56},
+  {0x1.a5503b23e255dp+0, -0x1.d2f6edb8d41e1p-54},
+  {0x1.ae89f995ad3adp+0, 0x1.7a1cd345dcc81p-54},
+  {0x1.b7f76f2fb5e47p+0, -0x1.5584f7e54ac3bp-56},
+  {0x1.c199bdd85529cp+0, 0x1.11065895048ddp-55},
+  {0x1.cb720dcef9069p+0, 0x1.503cbd1e949dbp-56},
+  {0x1.d5818dcfba487p+0, 0x1.2ed02d75b3707p-55},
+  {0x1.dfc97337b9b5fp+0, -0x1.1a5cd4f184b5cp-54},
+  {0x1.ea4afa2a490dap+0, -0x1.e9c23179c2893p-54},
+  {0x1.f50765b6e4540p+0, 0x1.9d3e12dd8a18bp-54}
+};
+
+// ln(i/32) as double-double, i = 23 ... 45
+const double lane_logTable[23][2] = {
+  {-0x1.522ae0738a3d8p-2, 0x1.8f7e9b38a6979p-57},
+  {-0x1.269621134db92p-2, -0x1.e0efadd9db02bp-56},
+  {-0x1.f991c6cb3b379p-3, -0x1.f665066f980a2p-57},
+  {-0x1.a93ed3c8ad9e3p-3, -0x1.bcafa9de97203p-57},
+  {-0x1.5bf406b543db2p-3, 0x1.1f5b44c0df7e7p-61},
+  {-0x1.1178e8227e47cp-3, 0x1.0e63a5f01c691p-58},
+  {-0x1.9335e5d594989p-4, 0x1.478a85704ccb7p-58},
+  {-0x1.08598b59e3a07p-4, 0x1.dd7009902bf32p-58},
+  {-0x1.0415d89e74444p-5, -0x1.c05cf1d753622p-59},
+  {0x0.0p+0, 0x0.0p+0},
+  {0x1.f829b0e783300p-6, 0x1.33e3f04f1ef23p-60},
+  {0x1.f0a30c01162a6p-5, 0x1.85f325c5bbacdp-59},
+  {0x1.6f0d28ae56b4cp-4, -0x1.906d99184b992p-58},
+  {0x1.e27076e2af2e6p-4, -0x1.61578001e0162p-60},
+  {0x1.29552f81ff523p-3, 0x1.301771c407dbfp-57},
+  {0x1.5ff3070a793d4p-3, -0x1.bc60efafc6f6ep-58},
+  {0x1.9525a9cf456b4p-3, 0x1.d904c1d4e2e26p-57},
+  {0x1.c8ff7c79a9a22p-3, -0x1.4f689f8434012p-57},
+  {0x1.fb9186d5e3e2bp-3, -0x1.caaae64f21acbp-57},
+  {0x1.1675cababa60ep-2, 0x1.ce63eab883717p-61},
+  {0x1.2e8e2bae11d31p-2, -0x1.8f4cdb95ebdf9p-56},
+  {0x1.4618bc21c5ec2p-2, 0x1.f42decdeccf1dp-56},
+  {0x1.5d1bdbf5809cap-2, 0x1.4236383dc7fe1p-56}
+};
+
+// The lane functions of each instruction set are compiled for it as a whole
+// (every function of EDCHM_vecmath_lanes.h gets the target), so no vector of
+// the set crosses a function without it.
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+namespace avx2 {
+typedef v4d V;
+typedef v4u U;
+#include "EDCHM_vecmath_lanes.h"
+} // namespace avx2
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+namespace avx512 {
+typedef v8d V;
+typedef v8u U;
+#include "EDCHM_vecmath_lanes.h"
+} // namespace avx512
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // EDCHM_VECMATH_SIMD
+
+// the fast mode is on and the CPU has the lanes for it
+inline bool vec_on()
+{
+  return mode() == fast && simd_level() > 0;
+}
+
+// n values of `kind` in the current mode, `x` or `y` is nullptr when the kind has no such argument
+inline void vec_run(int kind, int n, const double* x, const double* y, double* out)
+{
+#ifdef EDCHM_VECMATH_SIMD
+  if (vec_on()) {
+    if (simd_level() == 2) return avx512::lanes_run(kind, n, x, y, out);
+    return avx2::lanes_run(kind, n, x, y, out);
+  }
+#endif
+  for (int i = 0; i < n; i++) out[i] = math_cmath(kind, x ? x[i] : 0.0, y ? y[i] : 0.0);
+}
+
+inline void vec_exp(int n, const double* x, double* out) { vec_run(MATH_exp, n, x, nullptr, out); }
+inline void vec_log(int n, const double* x, double* out) { vec_run(MATH_log, n, x, nullptr, out); }
+inline void vec_pow(int n, const double* x, const double* y, double* out) { vec_run(MATH_pow, n, x, y, out); }
+inline void vec_pow10(int n, const double* y, double* out) { vec_run(MATH_pow10, n, nullptr, y, out); }
+inline void vec_tanh(int n, const double* x, double* out) { vec_run(MATH_tanh, n, x, nullptr, out); }
+
+// scalar of the kernels ----------
+
+// A `lane` is one spatial unit of a span (`span_math()` in EDCHM_span.h) whose
+// kernel is run with `scalar`s, several times. Each run replays the math calls
+// of the runs before from `result` and records the next one (`kind`, `x`, `y`),
+// which the span computes with the calls of the other units in one `vec_run()`;
+// the calls after it get a placeholder, as the run is repeated anyway. A unit is
+// done when a run records nothing, so its value has every call from the vector
+// math and all the rest from the same arithmetic as the `double` kernel.
+// A unit has at most `lane_max` recorded calls, the later ones take <cmath>.
+// The lane of the running kernel is `lane_current()` (one per thread), so a
+// `scalar` is only its value and costs the same as a `double`.
+const int lane_max = 8;
+
+struct scalar {
+  double v;
+
+  scalar(double v_ = 0) : v(v_) {}
+
+  scalar& operator+=(const scalar& b) { v += b.v; return *this; }
+  scalar& operator-=(const scalar& b) { v -= b.v; return *this; }
+  scalar& operator*=(const scalar& b) { v *= b.v; return *this; }
+  scalar& operator/=(const scalar& b) { v /= b.v; return *this; }
+};
+
+inline double scalar_value(const scalar& a)
+{
+  return a.v;
+}
+
+struct lane {
+  int round = 0;         // the calls before `round` are replayed
+  int n_call = 0;        // the calls of the current run
+  bool pending = false;  // the current run recorded its call `round`
+  int kind[lane_max];
+  double x[lane_max], y[lane_max], result[lane_max];
+
+  // an input of the kernel
+  scalar operator()(double v_) const { return scalar(v_); }
+
+  // the value of the next call of the current run
+  double call(int kind_, double x_, double y_)
+  {
+    int c_ = n_call++;
+    if (c_ >= lane_max) return math_cmath(kind_, x_, y_);
+    if (c_ < round) return result[c_];
+    if (c_ > round) return 1.0;
+    // a call with the arguments of one before (like the tanh of
+    // `evatransActual_GR4J()` twice, which <cmath> gives once) is its value
+    for (int i = 0; i < round; i++) {
+      if (kind[i] == kind_ && x[i] == x_ && y[i] == y_) {
+        result[c_] = result[i];
+        round++;
+        return result[c_];
+      }
+    }
+    kind[c_] = kind_;
+    x[c_] = x_;
+    y[c_] = y_;
+    pending = true;
+    return 1.0;
+  }
+};
+
+inline lane*& lane_current()
+{
+  static thread_local lane* lane_ = nullptr;
+  return lane_;
+}
+
+// a math call (exp, pow or tanh) of the running kernel, <cmath> without a lane
+inline scalar scalar_call(int kind, const scalar& a, const scalar& b)
+{
+  lane* l_ = lane_current();
+  return scalar(l_ ? l_->call(kind, a.v, b.v) : math_cmath(kind, a.v, b.v));
+}
+
+inline scalar operator-(const scalar& a) { return scalar(-a.v); }
+inline scalar operator+(const scalar& a, const scalar& b) { return scalar(a.v + b.v); }
+inline scalar operator+(const scalar& a, double b) { return scalar(a.v + b); }
+inline scalar operator+(double a, const scalar& b) { return scalar(a + b.v); }
+inline scalar operator-(const scalar& a, const scalar& b) { return scalar(a.v - b.v); }
+inline scalar operator-(const scalar& a, double b) { return scalar(a.v - b); }
+inline scalar operator-(double a, const scalar& b) { return scalar(a - b.v); }
+inline scalar operator*(const scalar& a, const scalar& b) { return scalar(a.v * b.v); }
+inline scalar operator*(const scalar& a, double b) { return scalar(a.v * b); }
+inline scalar operator*(double a, const scalar& b) { return scalar(a * b.v); }
+inline scalar operator/(const scalar& a, const scalar& b) { return scalar(a.v / b.v); }
+inline scalar operator/(const scalar& a, double b) { return scalar(a.v / b); }
+inline scalar operator/(double a, const scalar& b) { return scalar(a / b.v); }
+
+inline bool operator<(const scalar& a, const scalar& b) { return a.v < b.v; }
+inline bool operator<(const scalar& a, double b) { return a.v < b; }
+inline bool operator<(double a, const scalar& b) { return a < b.v; }
+inline bool operator>(const scalar& a, const scalar& b) { return a.v > b.v; }
+inline bool operator>(const scalar& a, double b) { return a.v > b; }
+inline bool operator>(double a, const scalar& b) { return a > b.v; }
+inline bool operator<=(const scalar& a, const scalar& b) { return a.v <= b.v; }
+inline bool operator<=(const scalar& a, double b) { return a.v <= b; }
+inline bool operator<=(double a, const scalar& b) { return a <= b.v; }
+inline bool operator>=(const scalar& a, const scalar& b) { return a.v >= b.v; }
+inline bool operator>=(const scalar& a, double b) { return a.v >= b; }
+inline bool operator>=(double a, const scalar& b) { return a >= b.v; }
+inline bool operator==(const scalar& a, const scalar& b) { return a.v == b.v; }
+inline bool operator==(const scalar& a, double b) { return a.v == b; }
+inline bool operator==(double a, const scalar& b) { return a == b.v; }
+inline bool operator!=(const scalar& a, const scalar& b) { return a.v != b.v; }
+inline bool operator!=(const scalar& a, double b) { return a.v != b; }
+inline bool operator!=(double a, const scalar& b) { return a != b.v; }
+
+inline scalar pow(const scalar& a, const scalar& b) { return scalar_call(MATH_pow, a, b); }
+inline scalar pow(const scalar& a, double b) { return scalar_call(MATH_pow, a, scalar(b)); }
+inline scalar pow(double a, const scalar& b) { return pow(scalar(a), b); }
+inline scalar exp(const scalar& a) { return scalar_call(MATH_exp, a, scalar()); }
+inline scalar tanh(const scalar& a) { return scalar_call(MATH_tanh, a, scalar()); }
+inline scalar ceil(const scalar& a) { return scalar(std::ceil(a.v)); }
+
+} // namespace vecmath
+} // namespace EDCHM
+
+#endif // EDCHM_VECMATH_H
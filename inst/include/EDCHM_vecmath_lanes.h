@@ -0,0 +1,220 @@
+// Defines a header file containing the lane functions of EDCHM_vecmath.h
+//
+// The file is included by EDCHM_vecmath.h once per instruction set, inside the
+// namespace of the set (`avx2`, `avx512`) with `V` (double lanes) and `U` (their
+// bits) defined and the functions compiled for the set. So it has no include
+// guard and is not included anywhere else.
+// The functions use only the operators of the vector extensions; the rounding
+// errors are taken with sums and splits that stay exact whether or not the
+// compiler fuses a product into an FMA.
+
+EDCHM_VECMATH_INLINE V lane_splat(double x)
+{
+  V v_ = {};
+  return v_ + x;
+}
+
+EDCHM_VECMATH_INLINE V lane_select(const U& mask, const V& a, const V& b)
+{
+  return (V)(((U)a & mask) | ((U)b & ~mask));
+}
+
+// one column of a table, row `idx` per lane
+EDCHM_VECMATH_INLINE V lane_gather(const double (*table)[2], const U& idx, int col)
+{
+  V v_;
+  for (unsigned k = 0; k < sizeof(V) / sizeof(double); k++) v_[k] = table[idx[k]][col];
+  return v_;
+}
+
+// a + b - s for s = a + b (Knuth)
+EDCHM_VECMATH_INLINE V lane_sumErr(const V& a, const V& b, const V& s)
+{
+  V b_ = s - a;
+  return (a - (s - b_)) + (b - b_);
+}
+
+// a b - p for p = a b (Dekker, the high halves keep 26 bits)
+EDCHM_VECMATH_INLINE V lane_prodErr(const V& a, const V& b, const V& p)
+{
+  const U high_ = (U)lane_splat(0.0) | 0xfffffffff8000000ULL;
+  V a_hi = (V)((U)a & high_), b_hi = (V)((U)b & high_);
+  V a_lo = a - a_hi, b_lo = b - b_hi;
+  return (((a_hi * b_hi - p) + a_hi * b_lo) + a_lo * b_hi) + a_lo * b_lo;
+}
+
+// hi + lo = k ln(2) / 32 + r with |r| <= ln(2) / 64, e^r - 1 = q, the row j = k mod 32
+// of `lane_exp2Table` and 2^floor(k / 32) as `scale`
+EDCHM_VECMATH_INLINE void lane_reduce(const V& hi, const V& lo, V& q, U& j, V& scale)
+{
+  V kd_ = hi * lane_log2e32 + lane_shift;
+  U k_ = (U)kd_;
+  kd_ = kd_ - lane_shift;
+  V r_ = hi - kd_ * (lane_ln2Hi / 32.0);
+  r_ = r_ + (lo - kd_ * (lane_ln2Lo / 32.0));
+  // Taylor to r^7
+  V p_ = lane_splat(1.0 / 5040.0);
+  p_ = p_ * r_ + 1.0 / 720.0;
+  p_ = p_ * r_ + 1.0 / 120.0;
+  p_ = p_ * r_ + 1.0 / 24.0;
+  p_ = p_ * r_ + 1.0 / 6.0;
+  p_ = p_ * r_ + 0.5;
+  q = r_ + r_ * r_ * p_;
+  j = k_ & 31;
+  scale = (V)(((k_ >> 5) << 52) + (U)lane_splat(1.0));
+}
+
+// e^(hi + lo) for hi in [-708, 709]
+EDCHM_VECMATH_INLINE V lane_exp(const V& hi, const V& lo)
+{
+  V q_, scale_;
+  U j_;
+  lane_reduce(hi, lo, q_, j_, scale_);
+  V t_hi = lane_gather(lane_exp2Table, j_, 0), t_lo = lane_gather(lane_exp2Table, j_, 1);
+  return (t_hi + (t_hi * q_ + t_lo)) * scale_;
+}
+
+// ln(x) = hi + lo for a normal positive x: x = 2^e m with m in [sqrt(1/2), sqrt(2)),
+// c = i / 32 next to m, ln(m) = ln(c) + 2 atanh(s) with s = (m - c) / (m + c)
+EDCHM_VECMATH_INLINE void lane_log(const V& x, V& hi, V& lo)
+{
+  U bits_ = (U)x;
+  V m_ = (V)((bits_ & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+  U big_ = (U)(m_ > 0x1.6a09e667f3bcdp0);
+  m_ = lane_select(big_, m_ * 0.5, m_);
+  // the exponent as double, 1 more for the halved m (big_ is all ones)
+  V e_ = (V)(((bits_ >> 52) - big_) + (U)lane_splat(lane_shift)) - (lane_shift + 1023.0);
+  V i_ = m_ * 32.0 + lane_shift;
+  U row_ = ((U)i_ & 63) - 23;
+  V c_ = (i_ - lane_shift) * (1.0 / 32.0);
+  V d_ = m_ - c_;
+  V t_ = m_ + c_;
+  V t_lo = lane_sumErr(m_, c_, t_);
+  V s_ = d_ / t_;
+  V p_ = s_ * t_;
+  V s_lo = (((d_ - p_) - lane_prodErr(s_, t_, p_)) - s_ * t_lo) / t_;
+  // |s| < 1/120, the atanh series to s^13
+  V z_ = s_ * s_;
+  V q_ = lane_splat(2.0 / 13.0);
+  q_ = q_ * z_ + 2.0 / 11.0;
+  q_ = q_ * z_ + 2.0 / 9.0;
+  q_ = q_ * z_ + 2.0 / 7.0;
+  q_ = q_ * z_ + 2.0 / 5.0;
+  q_ = q_ * z_ + 2.0 / 3.0;
+  // e ln(2) + ln(c) + 2 s, the sums of the high parts without error
+  V a_ = e_ * lane_ln2Hi;
+  V b_ = lane_gather(lane_logTable, row_, 0);
+  V sum1_ = a_ + b_;
+  V err1_ = lane_sumErr(a_, b_, sum1_);
+  V sum2_ = sum1_ + (s_ + s_);
+  V err2_ = lane_sumErr(sum1_, s_ + s_, sum2_);
+  V low_ = (err1_ + err2_) + (((e_ * lane_ln2Lo + lane_gather(lane_logTable, row_, 1)) + (s_lo + s_lo)) + s_ * z_ * q_);
+  hi = sum2_ + low_;
+  lo = low_ - (hi - sum2_);
+}
+
+// tanh(x) = sign(x) em / (em + 2) with em = e^(2 |x|) - 1, for |x| <= 22; em and
+// the quotient are carried as double-double, else the errors of em, em + 2 and
+// the division add up to 3.5 ulp
+EDCHM_VECMATH_INLINE V lane_tanh(const V& x)
+{
+  const U sign_ = (U)lane_splat(-0.0);
+  V a_ = (V)((U)x & ~sign_);
+  V t_ = a_ + a_;
+  V kd_ = t_ * lane_log2e32 + lane_shift;
+  U k_ = (U)kd_;
+  kd_ = kd_ - lane_shift;
+  V r1_ = t_ - kd_ * (lane_ln2Hi / 32.0);
+  V c_ = -(kd_ * (lane_ln2Lo / 32.0));
+  V r_ = r1_ + c_;
+  V r_lo = lane_sumErr(r1_, c_, r_);
+  V p_ = lane_splat(1.0 / 5040.0);
+  p_ = p_ * r_ + 1.0 / 720.0;
+  p_ = p_ * r_ + 1.0 / 120.0;
+  p_ = p_ * r_ + 1.0 / 24.0;
+  p_ = p_ * r_ + 1.0 / 6.0;
+  p_ = p_ * r_ + 0.5;
+  V w_ = r_ * r_ * p_;
+  // e^r - 1 = q + q_lo
+  V q_ = r_ + w_;
+  V q_lo = lane_sumErr(r_, w_, q_) + r_lo * (1.0 + r_);
+  U j_ = k_ & 31;
+  V scale_ = (V)(((k_ >> 5) << 52) + (U)lane_splat(1.0));
+  V tab_hi = lane_gather(lane_exp2Table, j_, 0), tab_lo = lane_gather(lane_exp2Table, j_, 1);
+  // e^(2 |x|) = scale (tab_hi + u + u_lo)
+  V u_ = tab_hi * q_;
+  V u_lo = lane_prodErr(tab_hi, q_, u_) + (tab_hi * q_lo + tab_lo * (1.0 + q_));
+  V big_ = scale_ * tab_hi;
+  V e_ = big_ - 1.0;
+  V e_lo = lane_sumErr(big_, lane_splat(-1.0), e_);
+  V b_ = scale_ * u_;
+  V em_ = e_ + b_;
+  V em_lo = lane_sumErr(e_, b_, em_) + (e_lo + scale_ * u_lo);
+  V d_ = em_ + 2.0;
+  V d_lo = lane_sumErr(em_, lane_splat(2.0), d_) + em_lo;
+  V y_ = em_ / d_;
+  V py_ = y_ * d_;
+  V res_ = y_ + ((((em_ - py_) - lane_prodErr(y_, d_, py_)) + em_lo) - y_ * d_lo) / d_;
+  return (V)((U)res_ | ((U)x & sign_));
+}
+
+// n values of `kind`, the lanes outside the domain take <cmath>
+inline void lanes_run(int kind, int n, const double* x, const double* y, double* out)
+{
+  const int W = sizeof(V) / sizeof(double);
+  const double* in_ = kind == MATH_pow10 ? y : x;
+  for (int i = 0; i < n; i += W) {
+    int w_ = n - i < W ? n - i : W;
+    V x_ = lane_splat(1.0), y_ = lane_splat(1.0), r_;
+    if (w_ == W) {
+      std::memcpy(&x_, in_ + i, sizeof(V));
+      if (kind == MATH_pow) std::memcpy(&y_, y + i, sizeof(V));
+    } else {
+      for (int k = 0; k < w_; k++) x_[k] = in_[i + k];
+      if (kind == MATH_pow) for (int k = 0; k < w_; k++) y_[k] = y[i + k];
+    }
+    U ok_;
+    switch (kind) {
+    case MATH_exp:
+      ok_ = (U)(x_ >= -708.0) & (U)(x_ <= 709.0);
+      r_ = lane_exp(x_, lane_splat(0.0));
+      break;
+    case MATH_log: {
+      ok_ = (U)(x_ >= 0x1p-1022) & (U)(x_ <= 0x1.fffffffffffffp1023);
+      V lo_;
+      lane_log(x_, r_, lo_);
+      break;
+    }
+    case MATH_pow: {
+      V hi_, lo_;
+      lane_log(x_, hi_, lo_);
+      V p_ = y_ * hi_;
+      V p_lo = lane_prodErr(y_, hi_, p_) + y_ * lo_;
+      ok_ = (U)(x_ >= 0x1p-1022) & (U)(x_ <= 0x1.fffffffffffffp1023) & (U)(p_ >= -708.0) & (U)(p_ <= 709.0);
+      r_ = lane_exp(p_, p_lo);
+      // pow(+0, y) = +0 for y > 0 (e.g. an empty store)
+      U zero_ = (U)((U)x_ == 0) & (U)(y_ > 0.0);
+      r_ = lane_select(zero_, lane_splat(0.0), r_);
+      ok_ |= zero_;
+      break;
+    }
+    case MATH_pow10: {
+      // ln(10) as double-double
+      const double ln10Hi = 0x1.26bb1bbb55516p1, ln10Lo = -0x1.f48ad494ea3e9p-53;
+      V p_ = x_ * ln10Hi;
+      V p_lo = lane_prodErr(x_, lane_splat(ln10Hi), p_) + x_ * ln10Lo;
+      ok_ = (U)(p_ >= -708.0) & (U)(p_ <= 709.0);
+      r_ = lane_exp(p_, p_lo);
+      break;
+    }
+    default:
+      ok_ = (U)(x_ >= -22.0) & (U)(x_ <= 22.0);
+      r_ = lane_tanh(x_);
+    }
+    if (w_ == W) std::memcpy(out + i, &r_, sizeof(V));
+    else for (int k = 0; k < w_; k++) out[i + k] = r_[k];
+    for (int k = 0; k < w_; k++) {
+      if (!ok_[k]) out[i + k] = math_cmath(kind, x ? x[i + k] : 0.0, y ? y[i + k] : 0.0);
+    }
+  }
+}
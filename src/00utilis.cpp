@@ -2,17 +2,36 @@
 
 NumericVector vecpow(NumericVector base, NumericVector exp) {
   NumericVector out(base.size());
-  std::transform(base.begin(), base.end(),
-                 exp.begin(), out.begin(), ::pow);
+  EDCHM::vecmath::vec_pow(base.size(), base.begin(), exp.begin(), out.begin());
   return out;
 }
 
 
 NumericVector vecpow10(NumericVector exp) {
-  
-  NumericVector base10 (exp.size(), 10.0);
-  
-  return vecpow(base10, exp);
+  NumericVector out(exp.size());
+  EDCHM::vecmath::vec_pow10(exp.size(), exp.begin(), out.begin());
+  return out;
+}
+
+//' math mode of the process functions
+//' @name EDCHM_mathMode
+//' @description
+//' `EDCHM_mathMode()` sets how the process functions, the models of [build_modell()] and the [ensemble] functions compute `pow()`, `exp()` and `tanh()`, for the whole R session.
+//' - `"strict"` (default): the math library of C, bit for bit the same results as [EDCHM_mini()], [EDCHM_snow()] or [EDCHM_GR4J()]
+//' - `"fast"`: 4 or 8 values at a time with AVX2 or AVX-512, when the CPU has them (not on Windows);
+//' every value is within 0.53 units in the last place of the exact one (about the same as the math library),
+//' the results differ from the strict ones in the last digits
+//' @param mode `"strict"` or `"fast"`, the empty default only returns the mode
+//' @return the mode before the call
+//' @export
+// [[Rcpp::export]]
+std::string EDCHM_mathMode(std::string mode = "")
+{
+  std::string old_ = EDCHM::vecmath::mode() == EDCHM::vecmath::fast ? "fast" : "strict";
+  if (mode == "strict") EDCHM::vecmath::set_mode(EDCHM::vecmath::strict);
+  else if (mode == "fast") EDCHM::vecmath::set_mode(EDCHM::vecmath::fast);
+  else if (!mode.empty()) stop("`mode` must be \"strict\" or \"fast\".");
+  return old_;
 }
 
 double sum_product(NumericVector lhs,
@@ -30,3 +49,56 @@ void resetVector(Rcpp::NumericVector& x) {
   std::fill(x.begin(), x.end(), 0.0);
 }
 
+
+modellOutput::modellOutput(
+    CharacterVector out_variable,
+    const std::vector<std::string>& vari_name,
+    int n_time,
+    int n_spat
+) : out_variable_(out_variable), data_(vari_name.size(), nullptr), n_time_(n_time), n_spat_(n_spat)
+{
+  if (out_variable.size() < 1) stop("`out_variable` must name at least one variable.");
+  for (int v = 0; v < out_variable.size(); v++) {
+    std::string name_v = as<std::string>(out_variable[v]);
+    int k = std::find(vari_name.begin(), vari_name.end(), name_v) - vari_name.begin();
+    if (k == (int)vari_name.size()) stop("`%s` is not an output of this model.", name_v);
+    if (data_[k]) stop("`%s` is asked more than once in `out_variable`.", name_v);
+    out_.push_back(NumericMatrix(n_time, n_spat));
+    data_[k] = out_.back().begin();
+  }
+}
+
+RObject modellOutput::result() const
+{
+  if (out_.size() == 1) return out_[0];
+  List out_list(out_.size());
+  for (size_t v = 0; v < out_.size(); v++) out_list[v] = out_[v];
+  out_list.attr("names") = out_variable_;
+  return out_list;
+}
+
+void modellOutput::propagateNA(
+    const std::vector<NumericMatrix>& boundary,
+    const std::vector<NumericVector>& param
+) const
+{
+  for (int j = 0; j < n_spat_; j++) {
+    int i_na = n_time_;
+    for (const NumericVector& x : param) {
+      if (ISNAN(x[j])) i_na = 0;
+    }
+    for (const NumericMatrix& x : boundary) {
+      const double* x_j = x.begin() + (size_t)j * x.nrow();
+      for (int i = 0; i < i_na; i++) {
+        if (ISNAN(x_j[i])) {
+          i_na = i;
+          break;
+        }
+      }
+    }
+    if (i_na == n_time_) continue;
+    for (double* out_k : data_) {
+      if (out_k) std::fill(out_k + (size_t)j * n_time_ + i_na, out_k + (size_t)(j + 1) * n_time_, NA_REAL);
+    }
+  }
+}
@@ -2,10 +2,68 @@
 #define __UTILITIES__
 
 #include <Rcpp.h>
+#include <string>
+#include <vector>
+#include "../inst/include/EDCHM_confluen.h"
+#include "../inst/include/EDCHM_core.h"
+#include "../inst/include/EDCHM_vecmath.h"
 using namespace Rcpp;
 
 NumericVector vecpow(NumericVector base, NumericVector exp);
 NumericVector vecpow10(NumericVector exp);
 double sum_product(NumericVector lhs, NumericVector rhs);
 void resetVector(Rcpp::NumericVector& x);
+
+// process-wide IUH cache (EDCHM_confluen.h), the IUH stays valid as long as the pointer is held
+using EDCHM::confluenIUH_method;
+using EDCHM::IUH_GR4J1; using EDCHM::IUH_GR4J2; using EDCHM::IUH_Kelly; using EDCHM::IUH_Nash; using EDCHM::IUH_Clark;
+using EDCHM::IUH_ptr;
+using EDCHM::confluenIUH_cached;
+
+// selected output of the models (00utilis.cpp): only the variables asked in
+// `out_variable` are allocated (n_time x n_spat), `data(k, j)` is the column of
+// spatial unit j of the k-th variable in `vari_name`, or nullptr when it is not asked
+class modellOutput {
+public:
+  modellOutput(
+      CharacterVector out_variable,
+      const std::vector<std::string>& vari_name,
+      int n_time,
+      int n_spat
+  );
+  double* data(int k, int j) const { return data_[k] ? data_[k] + (size_t)j * n_time_ : nullptr; }
+  // the output of all variables for the drivers of EDCHM_core.h
+  const std::vector<double*>& data() const { return data_; }
+  // one variable as matrix, more as a named list in the asked order
+  RObject result() const;
+  // NA as in the vector code of the models: an NA (or NaN) in the forcing of a
+  // spatial unit makes all its outputs NA from that time step on, an NA
+  // parameter or initial value the whole unit
+  void propagateNA(
+      const std::vector<NumericMatrix>& boundary,
+      const std::vector<NumericVector>& param
+  ) const;
+private:
+  CharacterVector out_variable_;
+  std::vector<NumericMatrix> out_;
+  std::vector<double*> data_;
+  int n_time_, n_spat_;
+};
+
+// the length of an IUH or UH is taken from these parameters, NA has no length
+inline void modell_checkNA(const char* name, const NumericVector& x)
+{
+  for (double x_j : x) if (ISNAN(x_j)) stop("`%s` can not be NA.", name);
+}
+
+// a vector or matrix of R as input of the drivers of EDCHM_core.h
+inline EDCHM::view<const double> modell_view(const NumericVector& x)
+{
+  return EDCHM::view<const double>(x.begin(), x.size());
+}
+
+inline void modellOutput_store(double* out_j, int i, double value)
+{
+  if (out_j) out_j[i] = value;
+}
 #endif // __UTILITIES__
\ No newline at end of file
@@ -3,7 +3,11 @@
 #define EDCHM_GR4J_H
 
 #include <Rcpp.h>
+#include "00utilis.h"
+#include "../inst/include/EDCHM_kernel.h"
+#include "../inst/include/EDCHM_confluen.h"
 using namespace Rcpp;
+using namespace EDCHM;
 
 double sum_product(NumericVector lhs, NumericVector rhs);
 void resetVector(Rcpp::NumericVector& x);
@@ -0,0 +1,295 @@
+#include "00utilis.h"
+#include "../inst/include/EDCHM_engine.h"
+#include "../inst/include/EDCHM_cali.h"
+using namespace EDCHM;
+// [[Rcpp::interfaces(r, cpp)]]
+
+// The engine (EDCHM_engine.h) runs the model of a `process_method` vector
+// without compiling it, the functions here resolve its inputs from the lists of R.
+
+static core::engine engine_build(CharacterVector process_method, bool single)
+{
+  CharacterVector process_name = process_method.names();
+  return core::engine(as<std::vector<std::string>>(process_name), as<std::vector<std::string>>(process_method), single);
+}
+
+// the boundary matrices and parameters in the order of the engine
+static void engine_input(
+    const core::engine& modell,
+    int n_time,
+    int n_spat,
+    List boundary,
+    List param,
+    std::vector<view<const double>>& boundary_,
+    std::vector<view<const double>>& param_,
+    const std::vector<std::string>& param_skip = {}
+)
+{
+  for (const std::string& name_ : modell.boundary_name()) {
+    if (!boundary.containsElementNamed(name_.c_str())) stop("`boundary` has no `%s`, it is needed by the `process_method`.", name_);
+    NumericMatrix matrix_ = boundary[name_];
+    if (matrix_.nrow() < n_time || matrix_.ncol() < n_spat) stop("`boundary$%s` must be a `n_time` x `n_spat` matrix.", name_);
+    boundary_.push_back(view<const double>(matrix_.begin(), (size_t)matrix_.nrow() * n_spat));
+  }
+  for (const std::string& name_ : modell.param_name()) {
+    if (std::find(param_skip.begin(), param_skip.end(), name_) != param_skip.end()) {
+      param_.push_back(view<const double>());
+      continue;
+    }
+    if (!param.containsElementNamed(name_.c_str())) stop("`param` has no `%s`, it is needed by the `process_method`.", name_);
+    NumericVector value_ = param[name_];
+    param_.push_back(modell_view(value_));
+  }
+}
+
+//' run a model of the **EDCHM-standard-structure** without compiling it
+//' @name EDCHM_engine
+//' @description
+//' `EDCHM_engine()` takes the same `process_method` as [build_modell()] and runs the model at once,
+//' without generating and compiling C++ code, so many structures can be compared in one session.
+//' Every process is a precompiled stage, one time step of a spatial unit calls the stages in the
+//' order of the standard structure, the routing is streamed with the IUH of `confluenLand` and `confluenGround`.
+//'
+//' The engine supports the methods with a process functor in `EDCHM_compose.h`:
+//' `atmosSnow_ThresholdT`, `snowMelt_Factor`, `evatransActual_UBC`, `evatransActual_GR4J` (`evatransSoil`),
+//' `infilt_UBC`, `infilt_GR4J`, `percola_Arno`, `percola_GR4J`, `baseflow_GR4J`, `baseflow_GR4Jfix`, `lateral_GR4J`
+//' and all [confluenIUH] methods.
+//' The other processes must be `"NULL"`, for the other methods use [build_modell()].
+//' @param process_method named char vector, see [build_modell()]
+//' @param boundary named list of the boundary matrices (`n_time` x `n_spat`), e.g. `atmos_precipitation_mm`,
+//' `atmos_potentialEvatrans_mm` or `atmos_temperature_Cel`
+//' @param param named list of the initial conditions and parameters, every vector has the length `n_spat` or 1.
+//' The names are the same as the arguments of the model from [build_modell()],
+//' e.g. `soil_water_mm`, `soil_capacity_mm`, `confluenLand_responseTime_TS` or `param_confluenLand_kel_k`
+//' @param out_variable char vector, names of the output variables: `"evatrans_mm"`, `"soilwater_mm"`, `"groundwater_mm"`,
+//' `"runoff_mm"`, `"baseflow_mm"`, `"streamflow_mm"`, `"snowice_mm"`, `"snowmelt_mm"`, `"lateral_mm"`
+//' @param single `TRUE` to run the process stages and the routing in single precision (`float`):
+//' the states, fluxes and routing rings of a spatial unit take half the memory,
+//' the routed stream flow, the outlet and the objectives are still summed in double precision.
+//' The stream flow differs from the one in double precision by about 1e-6 of its maximum
+//' @inheritParams modells
+//' @return stream flow in mm/TS (`n_time` x `n_spat`), or with more than one `out_variable` a named list of them
+//' @export
+// [[Rcpp::export]]
+RObject EDCHM_engine(
+    CharacterVector process_method,
+    int n_time,
+    int n_spat,
+    List boundary,
+    List param,
+    int n_thread = 1,
+    CharacterVector out_variable = CharacterVector::create("streamflow_mm"),
+    bool single = false
+)
+{
+  core::engine modell_ = engine_build(process_method, single);
+  std::vector<view<const double>> boundary_, param_;
+  engine_input(modell_, n_time, n_spat, boundary, param, boundary_, param_);
+
+  modellOutput out_(out_variable, core::engine_output, n_time, n_spat);
+  modell_.run(n_time, n_spat, boundary_, param_, n_thread, out_.data());
+  return out_.result();
+}
+
+//' sum of squared errors of the outlet of a model of the **EDCHM-standard-structure**
+//' @name EDCHM_engine_SSE
+//' @description
+//' `EDCHM_engine_SSE()` runs the model of [EDCHM_engine()] to the outlet and returns only the sum of squared errors (SSE) against `observe`.
+//' With `SSE_bound` the run stops as soon as the SSE is above it: the SSE only grows with every step,
+//' so e.g. in the fitness function of [cali_DDS()] or [cali_UVS()] with the SSE of the best parameters as bound,
+//' a candidate that can not be better is rejected before the end of the period.
+//' @inheritParams EDCHM_engine
+//' @inheritParams cali_DDS_engine
+//' @param SSE_bound bound of the SSE, a negative bound runs the whole period
+//' @return the SSE, or when the run stopped early the SSE of the steps that ran, which is above `SSE_bound`
+//' @export
+// [[Rcpp::export]]
+double EDCHM_engine_SSE(
+    CharacterVector process_method,
+    int n_time,
+    int n_spat,
+    List boundary,
+    List param,
+    NumericVector observe,
+    double SSE_bound = -1,
+    NumericVector weight = NumericVector::create(),
+    int n_thread = 1,
+    bool single = false
+)
+{
+  core::engine modell_ = engine_build(process_method, single);
+  std::vector<view<const double>> boundary_, param_;
+  engine_input(modell_, n_time, n_spat, boundary, param, boundary_, param_);
+  std::vector<double> weight_(weight.begin(), weight.end());
+  if (weight_.empty()) weight_.push_back(1.0 / n_spat);
+
+  cali::engine_fitness fitness_(modell_, n_time, n_spat, boundary_, param_, {}, view<const double>(weight_), modell_view(observe), "NSE", n_thread);
+  return fitness_.SSE({}, SSE_bound);
+}
+
+//' objectives of the outlet of a model of the **EDCHM-standard-structure**
+//' @name EDCHM_engine_objective
+//' @description
+//' `EDCHM_engine_objective()` runs the model of [EDCHM_engine()] to the outlet and returns only the objectives against `observe`.
+//' They are summed step by step while the model runs (the outlet is not kept),
+//' and are the same as the ones of `hydroGOF` with the stream flow of [EDCHM_engine()].
+//' @inheritParams EDCHM_engine
+//' @inheritParams cali_DDS_engine
+//' @param out_objective char vector, names of the objectives: `"NSE"`, `"KGE"`, `"RMSE"`, `"PBIAS"` (in %), `"logNSE"`
+//' (NSE of `log(Q + epsilon)`, `epsilon` 1 % of the mean observation as in `hydroGOF`)
+//' @return named vector of the objectives
+//' @export
+// [[Rcpp::export]]
+NumericVector EDCHM_engine_objective(
+    CharacterVector process_method,
+    int n_time,
+    int n_spat,
+    List boundary,
+    List param,
+    NumericVector observe,
+    CharacterVector out_objective = CharacterVector::create("NSE", "KGE"),
+    NumericVector weight = NumericVector::create(),
+    int n_thread = 1,
+    bool single = false
+)
+{
+  core::engine modell_ = engine_build(process_method, single);
+  std::vector<view<const double>> boundary_, param_;
+  engine_input(modell_, n_time, n_spat, boundary, param, boundary_, param_);
+  std::vector<double> weight_(weight.begin(), weight.end());
+  if (weight_.empty()) weight_.push_back(1.0 / n_spat);
+
+  std::vector<int> objective_k(out_objective.size());
+  bool with_log = false;
+  for (int v = 0; v < out_objective.size(); v++) {
+    std::string name_v = as<std::string>(out_objective[v]);
+    objective_k[v] = objective::gof_index(name_v);
+    if (objective_k[v] < 0) stop("`%s` is not an objective.", name_v);
+    with_log = with_log || name_v == "logNSE";
+  }
+  cali::engine_fitness fitness_(modell_, n_time, n_spat, boundary_, param_, {}, view<const double>(weight_), modell_view(observe),
+                                with_log ? "logNSE" : "NSE", n_thread);
+  objective::gof_sum gof_ = fitness_.gof({});
+  NumericVector out_(objective_k.size());
+  for (size_t v = 0; v < objective_k.size(); v++) out_[v] = objective::gof_value(gof_, objective_k[v]);
+  out_.names() = out_objective;
+  return out_;
+}
+
+//' calibrate a model of the **EDCHM-standard-structure** with DDS in C++
+//' @name cali_DDS_engine
+//' @description
+//' `cali_DDS_engine()` is the DDS of [cali_DDS()] \insertCite{DDS_Tolson_2007}{EDCHM} with the model of [EDCHM_engine()]
+//' and the objective in C++: every iteration runs the engine to the outlet and compares it with `observe`,
+//' without a call of an R function, a copy of the stream flow to R or a progress bar.
+//' With `n_chain` or `async` the search itself is parallel, see the arguments.
+//' The objectives are summed step by step from the outlet (see [EDCHM_engine_objective()]);
+//' with the NSE, RMSE or log-NSE a candidate stops as soon as its SSE is above the one of the best (see [EDCHM_engine_SSE()]),
+//' the search is the same as with the whole period, only the objective of such a candidate in `trace`
+//' is the one of the steps that ran.
+//' The series the process stages pass on are kept (up to `cache_MB`): a candidate reruns only the stages
+//' that depend on the changed parameters, e.g. not the snow stages when it changes soil parameters,
+//' and a candidate that only changes the IUH parameters (e.g. `confluenLand_responseTime_TS`) only redoes the routing.
+//' The outlet is the weighted sum of the stream flow of the spatial units.
+//' The calibrated parameters (the names of `x_Min`) get one value for all spatial units,
+//' the other parameters keep their values from `param`.
+//' @inheritParams EDCHM_engine
+//' @param observe observed stream flow at the outlet (`n_time`), `NA` steps are left out
+//' @param x_Min,x_Max named vectors of the minimal and maximal parameters, the names are the calibrated parameters of `param`
+//' @param x_Init initial parameters, by default the middle of `x_Min` and `x_Max`
+//' @param objective name of the objective: `"NSE"`, `"KGE"`, `"logNSE"` (maximised), `"RMSE"` or `"PBIAS"` (its absolute value minimised)
+//' @param weight weights of the spatial units for the outlet (`n_spat` or 1), by default the mean of the units
+//' @param max_iter maximal number of iteration, the initial parameters are the first
+//' @param r parameter for algorithm
+//' @param seed seed of the random numbers, by default from the random numbers of R, so [set.seed()] repeats a calibration
+//' @param n_chain number of independent DDS chains (multi-start), the first starts at `x_Init`, the others at random points;
+//' the chains run in parallel on `n_thread` threads, every chain is the same for every number of threads
+//' @param async `TRUE` for the asynchronous parallel DDS: `n_thread` workers evaluate the candidates of one chain at the same time,
+//' every candidate is built from the best when the worker takes it, so the search depends on the order the runs end
+//' @param n_thread number of threads: without `n_chain` or `async` the spatial units of every run are parallel,
+//' with them the runs, which is faster when there are fewer spatial units than threads
+//' @param cache_MB memory for the kept series in MB, shared by the chains or workers, 0 keeps none
+//' @references
+//' \insertAllCited{}
+//' @return list of `x_Best`, `y_Best` (the best objective of all chains, for the PBIAS its absolute value) and `trace`,
+//' a matrix of the chain, the objective of the candidate and the best of every iteration
+//' @export
+// [[Rcpp::export]]
+List cali_DDS_engine(
+    CharacterVector process_method,
+    int n_time,
+    int n_spat,
+    List boundary,
+    List param,
+    NumericVector observe,
+    NumericVector x_Min,
+    NumericVector x_Max,
+    NumericVector x_Init = NumericVector::create(),
+    std::string objective = "NSE",
+    NumericVector weight = NumericVector::create(),
+    int max_iter = 100,
+    double r = 0.2,
+    int seed = -1,
+    int n_chain = 1,
+    bool async = false,
+    int n_thread = 1,
+    double cache_MB = 256,
+    bool single = false
+)
+{
+  core::engine modell_ = engine_build(process_method, single);
+  if (!x_Min.hasAttribute("names")) stop("`x_Min` must be named by the calibrated parameters.");
+  std::vector<std::string> cali_name = as<std::vector<std::string>>(CharacterVector(x_Min.names()));
+  std::vector<view<const double>> boundary_, param_;
+  engine_input(modell_, n_time, n_spat, boundary, param, boundary_, param_, cali_name);
+
+  std::vector<double> x_min(x_Min.begin(), x_Min.end()), x_max(x_Max.begin(), x_Max.end()), x_init(x_Init.begin(), x_Init.end());
+  if (x_init.empty() || std::any_of(x_init.begin(), x_init.end(), [](double x) { return std::isnan(x); })) {
+    x_init.resize(x_min.size());
+    for (size_t k = 0; k < x_min.size(); k++) x_init[k] = (x_min[k] + x_max[k]) / 2;
+  }
+  std::vector<double> weight_(weight.begin(), weight.end());
+  if (weight_.empty()) weight_.push_back(1.0 / n_spat);
+
+  if (n_chain < 1) stop("`n_chain` must be at least 1.");
+  if (n_chain > 1 && async) stop("`n_chain` and `async` can not be used together.");
+  bool parallel_search = n_chain > 1 || async;
+  int n_fitness = n_chain > 1 ? n_chain : async ? n_thread : 1;
+  std::size_t cache_byte = cache_MB > 0 ? (std::size_t)(cache_MB * 1048576.0 / n_fitness) : 0;
+  cali::engine_fitness fitness_(modell_, n_time, n_spat, boundary_, param_, cali_name, view<const double>(weight_), modell_view(observe), objective,
+                                parallel_search ? 1 : n_thread, cache_byte);
+  int objective_k = fitness_.objective_index();
+  std::uint64_t seed_ = seed < 0 ? (std::uint64_t)(R::unif_rand() * 4294967296.0) : (std::uint64_t)seed;
+
+  // the chains of the search, a parallel search runs every model single-threaded
+  std::vector<cali::DDS_result> result_;
+  if (n_chain > 1) {
+    std::vector<cali::engine_fitness> fitness_chain(n_chain, fitness_);
+    result_ = cali::DDS_multi(fitness_chain, x_min, x_max, x_init, max_iter, r, seed_, n_thread);
+  } else if (async) {
+    std::vector<cali::engine_fitness> fitness_worker(n_thread, fitness_);
+    result_.push_back(cali::DDS_async(fitness_worker, x_min, x_max, x_init, max_iter, r, seed_));
+  } else {
+    cali::random_stream random_(seed_);
+    result_.push_back(cali::DDS(fitness_, x_min, x_max, x_init, max_iter, r, random_, [](int i) {
+      if (i % 100 == 0) checkUserInterrupt();
+    }));
+  }
+
+  int c_best = 0;
+  for (int c = 1; c < (int)result_.size(); c++) {
+    if (cali::DDS_better(result_[c].y_best, result_[c_best].y_best)) c_best = c;
+  }
+  NumericVector x_Best(result_[c_best].x_best.begin(), result_[c_best].x_best.end());
+  x_Best.names() = x_Min.names();
+  NumericMatrix trace_(result_.size() * max_iter, 3);
+  for (int c = 0; c < (int)result_.size(); c++) {
+    for (int i = 0; i < max_iter; i++) {
+      trace_(c * max_iter + i, 0) = c + 1;
+      trace_(c * max_iter + i, 1) = objective::gof_unfitness(result_[c].y_new[i], objective_k);
+      trace_(c * max_iter + i, 2) = objective::gof_unfitness(result_[c].y_trace[i], objective_k);
+    }
+  }
+  colnames(trace_) = CharacterVector::create("chain", "objective", "best");
+  return List::create(_["x_Best"] = x_Best, _["y_Best"] = objective::gof_unfitness(result_[c_best].y_best, objective_k), _["trace"] = trace_);
+}
@@ -0,0 +1,144 @@
+#include "00utilis.h"
+#include "../inst/include/EDCHM_ensemble.h"
+using namespace EDCHM;
+// [[Rcpp::interfaces(r, cpp)]]
+
+// The members are the rows of `param`: every vector has one value per member
+// or one value for all, the vectors of length 1 are recycled here.
+static std::vector<std::vector<double>> ensemble_getParam(List param, const std::vector<std::string>& param_name, int& n_member)
+{
+  std::vector<NumericVector> value_;
+  n_member = 1;
+  for (const std::string& name_ : param_name) {
+    if (!param.containsElementNamed(name_.c_str())) stop("`param` has no `%s`.", name_);
+    NumericVector value_k = param[name_];
+    value_.push_back(value_k);
+    if (value_k.size() != 1) {
+      if (n_member != 1 && value_k.size() != n_member) stop("`param$%s` must have length 1 or the number of members.", name_);
+      n_member = value_k.size();
+    }
+  }
+  std::vector<std::vector<double>> param_(param_name.size());
+  for (size_t k = 0; k < param_name.size(); k++) {
+    if (value_[k].size() == 1) param_[k].assign(n_member, value_[k][0]);
+    else param_[k].assign(value_[k].begin(), value_[k].end());
+  }
+  return param_;
+}
+
+// the index of every objective in `out_objective`
+static std::vector<int> ensemble_objective(CharacterVector out_objective)
+{
+  std::vector<int> k_(out_objective.size());
+  for (int v = 0; v < out_objective.size(); v++) {
+    std::string name_v = as<std::string>(out_objective[v]);
+    k_[v] = objective::gof_index(name_v);
+    if (k_[v] < 0) stop("`%s` is not an objective.", name_v);
+  }
+  return k_;
+}
+
+// the objectives of every member, one as vector, more as a named list
+static RObject ensemble_result(const std::vector<objective::gof_sum>& gof_, const std::vector<int>& objective_k, CharacterVector out_objective)
+{
+  List out_list(objective_k.size());
+  for (size_t v = 0; v < objective_k.size(); v++) {
+    NumericVector value_(gof_.size());
+    for (size_t m = 0; m < gof_.size(); m++) value_[m] = objective::gof_value(gof_[m], objective_k[v]);
+    if (objective_k.size() == 1) return value_;
+    out_list[v] = value_;
+  }
+  out_list.attr("names") = out_objective;
+  return out_list;
+}
+
+typedef void (*ensemble_run)(int, int, view<const double>, view<const double>, const std::vector<view<const double>>&,
+              int, double*, view<const double>, objective::gof_sum*);
+
+static RObject ensemble_call(
+    ensemble_run run_,
+    const std::vector<std::string>& param_name,
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    NumericVector observe,
+    CharacterVector out_objective,
+    int n_thread
+)
+{
+  int n_member;
+  std::vector<std::vector<double>> param_ = ensemble_getParam(param, param_name, n_member);
+  std::vector<view<const double>> param_view(param_.begin(), param_.end());
+  if (out_objective.size() == 0) {
+    NumericMatrix out_(n_time, n_member);
+    run_(n_time, n_member, modell_view(atmos_potentialEvatrans_mm), modell_view(atmos_precipitation_mm), param_view,
+         n_thread, out_.begin(), modell_view(observe), nullptr);
+    return out_;
+  }
+  std::vector<int> objective_k = ensemble_objective(out_objective);
+  objective::gof_sum gof_0;
+  if (std::find(objective_k.begin(), objective_k.end(), objective::gof_index("logNSE")) != objective_k.end()) {
+    if (observe.size() < n_time) stop("`observe` must have at least `n_time` values.");
+    gof_0 = objective::gof_sum(objective::gof_logEpsilon(observe.begin(), n_time));
+  }
+  std::vector<objective::gof_sum> gof_(n_member, gof_0);
+  run_(n_time, n_member, modell_view(atmos_potentialEvatrans_mm), modell_view(atmos_precipitation_mm), param_view,
+       n_thread, nullptr, modell_view(observe), gof_.data());
+  return ensemble_result(gof_, objective_k, out_objective);
+}
+
+//' run many parameter sets of one model together
+//' @name ensemble
+//' @description
+//' The ensemble functions run K parameter sets (members) of a lumped model against one forcing series,
+//' for calibration, Monte-Carlo or GLUE, instead of calling the model once per parameter set.
+//' The members run in blocks: the forcing and the IUHs are set up once, the states and parameters of a block are arrays over its members,
+//' and every process takes a time step of all members of the block at once, with the `pow()` and `tanh()` of the block
+//' in one call of the vector math (see [EDCHM_mathMode()]) and the rest in vectorised loops; the blocks run in parallel.
+//' In the strict math mode every member gives bit for bit the stream flow of [EDCHM_GR4J()] or [EDCHM_mini()] with `n_spat = 1`.
+//' @param n_time number of time steps
+//' @param atmos_potentialEvatrans_mm,atmos_precipitation_mm forcing of the lumped model, vector of `n_time`
+//' @param param named list (or data.frame) of the initial conditions and parameters, one value per member or one value for all:
+//' - `EDCHM_GR4J_ensemble`: `S_`, `R_`, `X_1`, `X_2`, `X_3`, `X_4`
+//' - `EDCHM_mini_ensemble`: the same names as the vector arguments of [EDCHM_mini()]
+//' @param observe observed stream flow (`n_time`), only needed for `out_objective`, `NA` steps are left out
+//' @param out_objective char vector, names of the objectives: `"NSE"`, `"KGE"`, `"RMSE"`, `"PBIAS"` (in %), `"logNSE"`
+//' (NSE of `log(Q + epsilon)`, `epsilon` 1 % of the mean observation as in `hydroGOF`);
+//' they are summed step by step while the members run,
+//' when it is empty the stream flow of the members is returned
+//' @param n_thread number of threads, the blocks of members are run in parallel when the package is built with OpenMP
+//' @return stream flow in mm/TS (`n_time` x K), or with `out_objective` the objective of every member (K),
+//' with more than one objective a named list of them
+//' @export
+// [[Rcpp::export]]
+RObject EDCHM_GR4J_ensemble(
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    NumericVector observe = NumericVector::create(),
+    CharacterVector out_objective = CharacterVector::create(),
+    int n_thread = 1
+)
+{
+  return ensemble_call(core::EDCHM_GR4J_ensemble, core::EDCHM_GR4J_ensembleParam, n_time,
+                       atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, observe, out_objective, n_thread);
+}
+
+//' @rdname ensemble
+//' @export
+// [[Rcpp::export]]
+RObject EDCHM_mini_ensemble(
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    NumericVector observe = NumericVector::create(),
+    CharacterVector out_objective = CharacterVector::create(),
+    int n_thread = 1
+)
+{
+  return ensemble_call(core::EDCHM_mini_ensemble, core::EDCHM_mini_ensembleParam, n_time,
+                       atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, observe, out_objective, n_thread);
+}
@@ -1,7 +1,6 @@
 #include "EDCHM_mini.h"
 // [[Rcpp::interfaces(r, cpp)]]
 
-
 //' modells build with EDCHM modulas
 //' @name modells
 //' @description some example models with EDCHM modulas
@@ -9,9 +8,11 @@
 //' @inheritParams all_vari
 //' @references
 //' \insertAllCited{}
-//' @return 
-//' - `EDCHM_xxxx`: stream flow in mm/TS
-//' - `EDCHM_xxxx_full`: list of variablen
+//' @return stream flow in mm/TS (`n_time` x `n_spat`), or with more than one `out_variable` a named list of them
+//' 
+//' An `NA` in the forcing of a spatial unit makes all its outputs `NA` from that time step on,
+//' an `NA` parameter or initial value the whole unit.
+//' The response times of the routing (`X_4` in `EDCHM_GR4J`) can not be `NA`.
 //' @details
 //' # **EDCHM_mini**: 
 //' A model based on mini-structure with only six process:
@@ -23,9 +24,15 @@
 //' - confluenIUH (confluenGround)
 //' @param confluenLand_responseTime_TS,confluenGround_responseTime_TS,param_confluenLand_kel_k, parameters in modells
 //' @param n_time,n_spat number of time step and spatial unit
+//' @param n_thread number of threads, the spatial units are run in parallel when the package is built with OpenMP,
+//' the result is the same for every number of threads
+//' @param out_variable char vector, names of the output variables, only these are allocated and stored:
+//' - `EDCHM_mini`: `"evatrans_mm"`, `"soilwater_mm"`, `"groundwater_mm"`, `"runoff_mm"`, `"baseflow_mm"`, `"streamflow_mm"`
+//' - `EDCHM_snow`: the same as `EDCHM_mini` and `"snowice_mm"`, `"snowmelt_mm"`
+//' - `EDCHM_GR4J`: `"S"`, `"Q9"`, `"Q1"`, `"Perc"`, `"Pr"`, `"AE"`, `"R"`, `"Qr"`, `"Qd"`, `"Q"`
 //' @export
 // [[Rcpp::export]]
-NumericMatrix EDCHM_mini(
+RObject EDCHM_mini(
 int n_time, 
 int n_spat,
 NumericMatrix atmos_potentialEvatrans_mm, 
@@ -43,39 +50,50 @@ NumericVector param_confluenLand_kel_k,
 NumericVector param_evatrans_ubc_gamma, 
 NumericVector param_infilt_ubc_P0AGEN, 
 NumericVector param_percola_arn_k, 
-NumericVector param_percola_arn_thresh
+NumericVector param_percola_arn_thresh,
+int n_thread = 1,
+CharacterVector out_variable = CharacterVector::create("streamflow_mm")
 )
 {
-
-NumericVector land_water_mm, soil_evatrans_mm, soil_infilt_mm, soil_percolation_mm, confluenLand_iuh_1, confluenGround_iuh_1;
-NumericMatrix land_runoff_mm(n_time, n_spat), ground_baseflow_mm(n_time, n_spat), confluen_streamflow_mm(n_time, n_spat);
-for (int i= 0; i < n_time; i++) {
-
-soil_evatrans_mm = evatransActual_UBC(atmos_potentialEvatrans_mm(i, _), soil_water_mm, soil_capacity_mm, param_evatrans_ubc_gamma);
-soil_water_mm += - soil_evatrans_mm;
-land_water_mm = atmos_precipitation_mm(i, _);
-
-soil_infilt_mm = infilt_UBC(land_water_mm, land_impermeableFrac_1, soil_water_mm, soil_capacity_mm, param_infilt_ubc_P0AGEN);
-soil_water_mm += soil_infilt_mm;
-land_runoff_mm(i, _) = land_water_mm - soil_infilt_mm;
-
-soil_percolation_mm = percola_Arno(soil_water_mm, soil_capacity_mm, soil_potentialPercola_mm, param_percola_arn_thresh, param_percola_arn_k);
-ground_water_mm += soil_percolation_mm;
-soil_water_mm += - soil_percolation_mm;
-
-NumericVector baseflow_temp = ifelse(ground_water_mm < ground_capacity_mm, 0, ground_water_mm - ground_capacity_mm);
-
-ground_water_mm = ifelse(ground_water_mm < ground_capacity_mm,ground_water_mm, ground_capacity_mm);
-ground_baseflow_mm(i, _) = baseflow_GR4Jfix(ground_water_mm, ground_capacity_mm, param_baseflow_grf_gamma);
-ground_water_mm += - ground_baseflow_mm(i, _);
-ground_baseflow_mm(i, _) = ground_baseflow_mm(i, _) + baseflow_temp;
-
-}
-for (int j= 0; j < n_spat; j++) {
-confluenLand_iuh_1 = confluenIUH_Kelly(confluenLand_responseTime_TS(j), param_confluenLand_kel_k(j));
-confluenGround_iuh_1 = confluenIUH_GR4J1(confluenGround_responseTime_TS(j));
-
-confluen_streamflow_mm(_, j) = confluen_IUH2S(land_runoff_mm(_, j), ground_baseflow_mm(_, j), confluenLand_iuh_1, confluenGround_iuh_1);
-}
-return confluen_streamflow_mm;
+  modellOutput out_(out_variable, core::EDCHM_mini_output, n_time, n_spat);
+  modell_checkNA("confluenLand_responseTime_TS", confluenLand_responseTime_TS);
+  modell_checkNA("confluenGround_responseTime_TS", confluenGround_responseTime_TS);
+  core::EDCHM_mini(
+    n_time,
+    n_spat,
+    modell_view(atmos_potentialEvatrans_mm),
+    modell_view(atmos_precipitation_mm),
+    modell_view(ground_capacity_mm),
+    modell_view(ground_water_mm),
+    modell_view(land_impermeableFrac_1),
+    modell_view(soil_capacity_mm),
+    modell_view(soil_potentialPercola_mm),
+    modell_view(soil_water_mm),
+    modell_view(confluenLand_responseTime_TS),
+    modell_view(confluenGround_responseTime_TS),
+    modell_view(param_baseflow_grf_gamma),
+    modell_view(param_confluenLand_kel_k),
+    modell_view(param_evatrans_ubc_gamma),
+    modell_view(param_infilt_ubc_P0AGEN),
+    modell_view(param_percola_arn_k),
+    modell_view(param_percola_arn_thresh),
+    n_thread,
+    out_.data()
+  );
+  out_.propagateNA(
+    {atmos_potentialEvatrans_mm, atmos_precipitation_mm},
+    {ground_capacity_mm,
+     ground_water_mm,
+     land_impermeableFrac_1,
+     soil_capacity_mm,
+     soil_potentialPercola_mm,
+     soil_water_mm,
+     param_baseflow_grf_gamma,
+     param_confluenLand_kel_k,
+     param_evatrans_ubc_gamma,
+     param_infilt_ubc_P0AGEN,
+     param_percola_arn_k,
+     param_percola_arn_thresh}
+  );
+  return out_.result();
 }
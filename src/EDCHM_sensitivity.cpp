@@ -0,0 +1,113 @@
+#include "00utilis.h"
+#include "../inst/include/EDCHM_sensitivity.h"
+using namespace EDCHM;
+// [[Rcpp::interfaces(r, cpp)]]
+
+typedef void (*sensitivity_run)(int, view<const double>, view<const double>, const std::vector<double>&, const std::vector<int>&,
+              view<const double>, const objective::gof_sum&, int, double*, double*, double*, double*);
+
+static List sensitivity_call(
+    sensitivity_run run_,
+    const std::vector<std::string>& param_name,
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    CharacterVector sensitivity_param,
+    NumericVector observe,
+    std::string objective_name
+)
+{
+  // one parameter set, every parameter has one value
+  std::vector<double> param_;
+  for (const std::string& name_ : param_name) {
+    if (!param.containsElementNamed(name_.c_str())) stop("`param` has no `%s`.", name_);
+    NumericVector value_ = param[name_];
+    if (value_.size() != 1) stop("`param$%s` must have length 1.", name_);
+    param_.push_back(value_[0]);
+  }
+  // the parameters of the derivatives, all of the model by default
+  if (sensitivity_param.size() == 0) sensitivity_param = CharacterVector(param_name.begin(), param_name.end());
+  std::vector<int> seed_;
+  for (int k = 0; k < sensitivity_param.size(); k++) {
+    std::string name_k = as<std::string>(sensitivity_param[k]);
+    auto it_ = std::find(param_name.begin(), param_name.end(), name_k);
+    if (it_ == param_name.end()) stop("`%s` is not a parameter of the model.", name_k);
+    seed_.push_back(it_ - param_name.begin());
+  }
+
+  // the objective is only summed with an observation
+  int objective_k = -1;
+  objective::gof_sum gof_0;
+  if (observe.size() > 0) {
+    objective_k = objective::gof_index(objective_name);
+    if (objective_k < 0) stop("`%s` is not an objective.", objective_name);
+    if (observe.size() < n_time) stop("`observe` must have at least `n_time` values.");
+    if (objective_name == "logNSE") gof_0 = objective::gof_sum(objective::gof_logEpsilon(observe.begin(), n_time));
+  }
+
+  NumericVector streamflow_(n_time);
+  NumericMatrix sensitivity_(n_time, (int)seed_.size());
+  NumericVector gradient_(seed_.size());
+  double objective_ = NA_REAL;
+  run_(n_time, modell_view(atmos_potentialEvatrans_mm), modell_view(atmos_precipitation_mm), param_, seed_,
+       modell_view(observe), gof_0, objective_k, streamflow_.begin(), sensitivity_.begin(), &objective_, gradient_.begin());
+  colnames(sensitivity_) = sensitivity_param;
+  if (objective_k < 0) return List::create(_["streamflow_mm"] = streamflow_, _["sensitivity"] = sensitivity_);
+  gradient_.names() = sensitivity_param;
+  return List::create(_["streamflow_mm"] = streamflow_, _["sensitivity"] = sensitivity_,
+                      _["objective"] = objective_, _["gradient"] = gradient_);
+}
+
+//' parameter sensitivities of the lumped models
+//' @name sensitivity
+//' @description
+//' The sensitivity functions run one parameter set of a lumped model with dual numbers
+//' (forward-mode automatic differentiation): the process kernels, the routing and the objective
+//' carry the derivatives to the chosen parameters along, so one run gives the stream flow,
+//' its derivative to every parameter at every step and the gradient of the objective,
+//' instead of one extra run per parameter for finite differences.
+//' The stream flow is the same as of [EDCHM_GR4J()] or [EDCHM_mini()] with `n_spat = 1`.
+//' The derivatives are the ones of the branch every step takes:
+//' a limit (e.g. the soil at its capacity) or the length of an IUH has no derivative.
+//' @inheritParams ensemble
+//' @param param named list of one parameter set, one value for every name of [ensemble]
+//' @param sensitivity_param char vector, names of the parameters of the derivatives (at most 16), all parameters of the model when empty
+//' @param observe observed stream flow (`n_time`), `NA` steps are left out, the objective is only returned with it
+//' @param objective name of the objective: `"NSE"`, `"KGE"`, `"RMSE"`, `"PBIAS"` or `"logNSE"`
+//' @return list of
+//' - `streamflow_mm`: stream flow in mm/TS (`n_time`)
+//' - `sensitivity`: derivative of the stream flow to the parameters (`n_time` x K), the columns are named after `sensitivity_param`
+//' - `objective`, `gradient`: with `observe` the objective and its derivative to the parameters (K)
+//' @export
+// [[Rcpp::export]]
+List EDCHM_GR4J_sensitivity(
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    CharacterVector sensitivity_param = CharacterVector::create(),
+    NumericVector observe = NumericVector::create(),
+    std::string objective = "NSE"
+)
+{
+  return sensitivity_call(core::EDCHM_GR4J_sensitivity, core::EDCHM_GR4J_ensembleParam, n_time, atmos_potentialEvatrans_mm,
+                          atmos_precipitation_mm, param, sensitivity_param, observe, objective);
+}
+
+//' @rdname sensitivity
+//' @export
+// [[Rcpp::export]]
+List EDCHM_mini_sensitivity(
+    int n_time,
+    NumericVector atmos_potentialEvatrans_mm,
+    NumericVector atmos_precipitation_mm,
+    List param,
+    CharacterVector sensitivity_param = CharacterVector::create(),
+    NumericVector observe = NumericVector::create(),
+    std::string objective = "NSE"
+)
+{
+  return sensitivity_call(core::EDCHM_mini_sensitivity, core::EDCHM_mini_ensembleParam, n_time, atmos_potentialEvatrans_mm,
+                          atmos_precipitation_mm, param, sensitivity_param, observe, objective);
+}
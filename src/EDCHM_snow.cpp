@@ -1,14 +1,13 @@
 #include "EDCHM_snow.h"
 // [[Rcpp::interfaces(r, cpp)]]
 
-
 //' @name modells
 //' @details
 //' # **EDCHM_snow**: 
 //' A model with `snowMelt` and `atmosSnow` based on mini-modell
 //' @export
 // [[Rcpp::export]]
-NumericMatrix EDCHM_snow(
+RObject EDCHM_snow(
 int n_time,
 int n_spat,
 NumericMatrix atmos_potentialEvatrans_mm,
@@ -31,47 +30,59 @@ NumericVector param_infilt_ubc_P0AGEN,
 NumericVector param_percola_arn_k,
 NumericVector param_percola_arn_thresh,
 NumericVector param_snow_fac_f,
-NumericVector param_snow_fac_Tmelt
+NumericVector param_snow_fac_Tmelt,
+int n_thread = 1,
+CharacterVector out_variable = CharacterVector::create("streamflow_mm")
 )
 {
-
-NumericVector land_water_mm, atmos_snow_mm, soil_evatrans_mm, snow_melt_mm, soil_infilt_mm, soil_percolation_mm, confluenLand_iuh_1, confluenGround_iuh_1;
-NumericMatrix land_runoff_mm(n_time, n_spat), ground_baseflow_mm(n_time, n_spat), confluen_streamflow_mm(n_time, n_spat);
-for (int i= 0; i < n_time; i++) {
-
-atmos_snow_mm = atmosSnow_ThresholdT(atmos_precipitation_mm(i, _), atmos_temperature_Cel(i, _), param_atmos_thr_Ts);
-atmos_precipitation_mm(i, _) = atmos_precipitation_mm(i, _) - atmos_snow_mm;
-
-soil_evatrans_mm = evatransActual_UBC(atmos_potentialEvatrans_mm(i, _), soil_water_mm, soil_capacity_mm, param_evatrans_ubc_gamma);
-soil_water_mm += - soil_evatrans_mm;
-land_water_mm = atmos_precipitation_mm(i, _);
-
-snow_melt_mm = snowMelt_Factor(snow_ice_mm, atmos_temperature_Cel(i, _), param_snow_fac_f, param_snow_fac_Tmelt);
-land_water_mm += snow_melt_mm;
-snow_ice_mm += -snow_melt_mm;
-snow_ice_mm += atmos_snow_mm;
-
-soil_infilt_mm = infilt_UBC(land_water_mm, land_impermeableFrac_1, soil_water_mm, soil_capacity_mm, param_infilt_ubc_P0AGEN);
-soil_water_mm += soil_infilt_mm;
-land_runoff_mm(i, _) = land_water_mm - soil_infilt_mm;
-
-soil_percolation_mm = percola_Arno(soil_water_mm, soil_capacity_mm, soil_potentialPercola_mm, param_percola_arn_thresh, param_percola_arn_k);
-ground_water_mm += soil_percolation_mm;
-soil_water_mm += - soil_percolation_mm;
-
-NumericVector baseflow_temp = ifelse(ground_water_mm < ground_capacity_mm, 0, ground_water_mm - ground_capacity_mm);
-
-ground_water_mm = ifelse(ground_water_mm < ground_capacity_mm,ground_water_mm, ground_capacity_mm);
-ground_baseflow_mm(i, _) = baseflow_GR4Jfix(ground_water_mm, ground_capacity_mm, param_baseflow_grf_gamma);
-ground_water_mm += - ground_baseflow_mm(i, _);
-ground_baseflow_mm(i, _) = ground_baseflow_mm(i, _) + baseflow_temp;
-
-}
-for (int j= 0; j < n_spat; j++) {
-confluenLand_iuh_1 = confluenIUH_Kelly(confluenLand_responseTime_TS(j), param_confluenLand_kel_k(j));
-confluenGround_iuh_1 = confluenIUH_GR4J1(confluenGround_responseTime_TS(j));
-
-confluen_streamflow_mm(_, j) = confluen_IUH2S(land_runoff_mm(_, j), ground_baseflow_mm(_, j), confluenLand_iuh_1, confluenGround_iuh_1);
-}
-return confluen_streamflow_mm;
+  modellOutput out_(out_variable, core::EDCHM_snow_output, n_time, n_spat);
+  modell_checkNA("confluenLand_responseTime_TS", confluenLand_responseTime_TS);
+  modell_checkNA("confluenGround_responseTime_TS", confluenGround_responseTime_TS);
+  core::EDCHM_snow(
+    n_time,
+    n_spat,
+    modell_view(atmos_potentialEvatrans_mm),
+    modell_view(atmos_precipitation_mm),
+    modell_view(atmos_temperature_Cel),
+    modell_view(ground_capacity_mm),
+    modell_view(ground_water_mm),
+    modell_view(land_impermeableFrac_1),
+    modell_view(snow_ice_mm),
+    modell_view(soil_capacity_mm),
+    modell_view(soil_potentialPercola_mm),
+    modell_view(soil_water_mm),
+    modell_view(confluenLand_responseTime_TS),
+    modell_view(confluenGround_responseTime_TS),
+    modell_view(param_atmos_thr_Ts),
+    modell_view(param_baseflow_grf_gamma),
+    modell_view(param_confluenLand_kel_k),
+    modell_view(param_evatrans_ubc_gamma),
+    modell_view(param_infilt_ubc_P0AGEN),
+    modell_view(param_percola_arn_k),
+    modell_view(param_percola_arn_thresh),
+    modell_view(param_snow_fac_f),
+    modell_view(param_snow_fac_Tmelt),
+    n_thread,
+    out_.data()
+  );
+  out_.propagateNA(
+    {atmos_potentialEvatrans_mm, atmos_precipitation_mm, atmos_temperature_Cel},
+    {ground_capacity_mm,
+     ground_water_mm,
+     land_impermeableFrac_1,
+     snow_ice_mm,
+     soil_capacity_mm,
+     soil_potentialPercola_mm,
+     soil_water_mm,
+     param_atmos_thr_Ts,
+     param_baseflow_grf_gamma,
+     param_confluenLand_kel_k,
+     param_evatrans_ubc_gamma,
+     param_infilt_ubc_P0AGEN,
+     param_percola_arn_k,
+     param_percola_arn_thresh,
+     param_snow_fac_f,
+     param_snow_fac_Tmelt}
+  );
+  return out_.result();
 }
@@ -3,7 +3,12 @@
 #define EDCHM_SNOW_H
 
 #include <Rcpp.h>
+#include "00utilis.h"
+#include "../inst/include/EDCHM_kernel.h"
+#include "../inst/include/EDCHM_confluen.h"
+#include "../inst/include/EDCHM_compose.h"
 using namespace Rcpp;
+using namespace EDCHM;
 
 NumericVector atmosSnow_ThresholdT(
     NumericVector atmos_precipitation_mm, 
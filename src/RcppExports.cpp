@@ -13,9 +13,43 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// EDCHM_mathMode
+std::string EDCHM_mathMode(std::string mode);
+static SEXP _EDCHM_EDCHM_mathMode_try(SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_mathMode(mode));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_EDCHM_mathMode(SEXP modeSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mathMode_try(modeSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
 // EDCHM_GR4J
-NumericMatrix EDCHM_GR4J(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4);
-static SEXP _EDCHM_EDCHM_GR4J_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP) {
+RObject EDCHM_GR4J(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4, int n_thread, CharacterVector out_variable, bool fast_pow);
+static SEXP _EDCHM_EDCHM_GR4J_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP, SEXP n_threadSEXP, SEXP out_variableSEXP, SEXP fast_powSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
@@ -28,15 +62,18 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< NumericVector >::type X_2(X_2SEXP);
     Rcpp::traits::input_parameter< NumericVector >::type X_3(X_3SEXP);
     Rcpp::traits::input_parameter< NumericVector >::type X_4(X_4SEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_GR4J(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, S_, R_, X_1, X_2, X_3, X_4));
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_variable(out_variableSEXP);
+    Rcpp::traits::input_parameter< bool >::type fast_pow(fast_powSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_GR4J(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, S_, R_, X_1, X_2, X_3, X_4, n_thread, out_variable, fast_pow));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_GR4J(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP) {
+RcppExport SEXP _EDCHM_EDCHM_GR4J(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP, SEXP n_threadSEXP, SEXP out_variableSEXP, SEXP fast_powSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_GR4J_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, S_SEXP, R_SEXP, X_1SEXP, X_2SEXP, X_3SEXP, X_4SEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_GR4J_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, S_SEXP, R_SEXP, X_1SEXP, X_2SEXP, X_3SEXP, X_4SEXP, n_threadSEXP, out_variableSEXP, fast_powSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -56,30 +93,28 @@ RcppExport SEXP _EDCHM_EDCHM_GR4J(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_p
     UNPROTECT(1);
     return rcpp_result_gen;
 }
-// EDCHM_GR4J_full
-List EDCHM_GR4J_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector S_, NumericVector R_, NumericVector X_1, NumericVector X_2, NumericVector X_3, NumericVector X_4);
-static SEXP _EDCHM_EDCHM_GR4J_full_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP) {
+// EDCHM_engine
+RObject EDCHM_engine(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, int n_thread, CharacterVector out_variable, bool single);
+static SEXP _EDCHM_EDCHM_engine_try(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP, SEXP singleSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type process_method(process_methodSEXP);
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
     Rcpp::traits::input_parameter< int >::type n_spat(n_spatSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type S_(S_SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type R_(R_SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type X_1(X_1SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type X_2(X_2SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type X_3(X_3SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type X_4(X_4SEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_GR4J_full(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, S_, R_, X_1, X_2, X_3, X_4));
+    Rcpp::traits::input_parameter< List >::type boundary(boundarySEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_variable(out_variableSEXP);
+    Rcpp::traits::input_parameter< bool >::type single(singleSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_engine(process_method, n_time, n_spat, boundary, param, n_thread, out_variable, single));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_GR4J_full(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP S_SEXP, SEXP R_SEXP, SEXP X_1SEXP, SEXP X_2SEXP, SEXP X_3SEXP, SEXP X_4SEXP) {
+RcppExport SEXP _EDCHM_EDCHM_engine(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP, SEXP singleSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_GR4J_full_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, S_SEXP, R_SEXP, X_1SEXP, X_2SEXP, X_3SEXP, X_4SEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_engine_try(process_methodSEXP, n_timeSEXP, n_spatSEXP, boundarySEXP, paramSEXP, n_threadSEXP, out_variableSEXP, singleSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -99,38 +134,30 @@ RcppExport SEXP _EDCHM_EDCHM_GR4J_full(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP at
     UNPROTECT(1);
     return rcpp_result_gen;
 }
-// EDCHM_mini
-NumericMatrix EDCHM_mini(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh);
-static SEXP _EDCHM_EDCHM_mini_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP) {
+// EDCHM_engine_SSE
+double EDCHM_engine_SSE(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, double SSE_bound, NumericVector weight, int n_thread, bool single);
+static SEXP _EDCHM_EDCHM_engine_SSE_try(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP SSE_boundSEXP, SEXP weightSEXP, SEXP n_threadSEXP, SEXP singleSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type process_method(process_methodSEXP);
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
     Rcpp::traits::input_parameter< int >::type n_spat(n_spatSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type ground_capacity_mm(ground_capacity_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type ground_water_mm(ground_water_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type land_impermeableFrac_1(land_impermeableFrac_1SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_capacity_mm(soil_capacity_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_potentialPercola_mm(soil_potentialPercola_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_water_mm(soil_water_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type confluenLand_responseTime_TS(confluenLand_responseTime_TSSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type confluenGround_responseTime_TS(confluenGround_responseTime_TSSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_baseflow_grf_gamma(param_baseflow_grf_gammaSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_confluenLand_kel_k(param_confluenLand_kel_kSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_evatrans_ubc_gamma(param_evatrans_ubc_gammaSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_infilt_ubc_P0AGEN(param_infilt_ubc_P0AGENSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_k(param_percola_arn_kSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_thresh(param_percola_arn_threshSEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_mini(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh));
+    Rcpp::traits::input_parameter< List >::type boundary(boundarySEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< double >::type SSE_bound(SSE_boundSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< bool >::type single(singleSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_engine_SSE(process_method, n_time, n_spat, boundary, param, observe, SSE_bound, weight, n_thread, single));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_mini(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP) {
+RcppExport SEXP _EDCHM_EDCHM_engine_SSE(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP SSE_boundSEXP, SEXP weightSEXP, SEXP n_threadSEXP, SEXP singleSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mini_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_engine_SSE_try(process_methodSEXP, n_timeSEXP, n_spatSEXP, boundarySEXP, paramSEXP, observeSEXP, SSE_boundSEXP, weightSEXP, n_threadSEXP, singleSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -150,38 +177,30 @@ RcppExport SEXP _EDCHM_EDCHM_mini(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_p
     UNPROTECT(1);
     return rcpp_result_gen;
 }
-// EDCHM_mini_full
-List EDCHM_mini_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh);
-static SEXP _EDCHM_EDCHM_mini_full_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP) {
+// EDCHM_engine_objective
+NumericVector EDCHM_engine_objective(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, CharacterVector out_objective, NumericVector weight, int n_thread, bool single);
+static SEXP _EDCHM_EDCHM_engine_objective_try(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP weightSEXP, SEXP n_threadSEXP, SEXP singleSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type process_method(process_methodSEXP);
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
     Rcpp::traits::input_parameter< int >::type n_spat(n_spatSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type ground_capacity_mm(ground_capacity_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type ground_water_mm(ground_water_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type land_impermeableFrac_1(land_impermeableFrac_1SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_capacity_mm(soil_capacity_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_potentialPercola_mm(soil_potentialPercola_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type soil_water_mm(soil_water_mmSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type confluenLand_responseTime_TS(confluenLand_responseTime_TSSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type confluenGround_responseTime_TS(confluenGround_responseTime_TSSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_baseflow_grf_gamma(param_baseflow_grf_gammaSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_confluenLand_kel_k(param_confluenLand_kel_kSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_evatrans_ubc_gamma(param_evatrans_ubc_gammaSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_infilt_ubc_P0AGEN(param_infilt_ubc_P0AGENSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_k(param_percola_arn_kSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_thresh(param_percola_arn_threshSEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_mini_full(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh));
+    Rcpp::traits::input_parameter< List >::type boundary(boundarySEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_objective(out_objectiveSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< bool >::type single(singleSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_engine_objective(process_method, n_time, n_spat, boundary, param, observe, out_objective, weight, n_thread, single));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_mini_full(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP) {
+RcppExport SEXP _EDCHM_EDCHM_engine_objective(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP weightSEXP, SEXP n_threadSEXP, SEXP singleSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mini_full_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_engine_objective_try(process_methodSEXP, n_timeSEXP, n_spatSEXP, boundarySEXP, paramSEXP, observeSEXP, out_objectiveSEXP, weightSEXP, n_threadSEXP, singleSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -201,43 +220,252 @@ RcppExport SEXP _EDCHM_EDCHM_mini_full(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP at
     UNPROTECT(1);
     return rcpp_result_gen;
 }
-// EDCHM_snow
-NumericMatrix EDCHM_snow(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt);
-static SEXP _EDCHM_EDCHM_snow_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP) {
+// cali_DDS_engine
+List cali_DDS_engine(CharacterVector process_method, int n_time, int n_spat, List boundary, List param, NumericVector observe, NumericVector x_Min, NumericVector x_Max, NumericVector x_Init, std::string objective, NumericVector weight, int max_iter, double r, int seed, int n_chain, bool async, int n_thread, double cache_MB, bool single);
+static SEXP _EDCHM_cali_DDS_engine_try(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP x_MinSEXP, SEXP x_MaxSEXP, SEXP x_InitSEXP, SEXP objectiveSEXP, SEXP weightSEXP, SEXP max_iterSEXP, SEXP rSEXP, SEXP seedSEXP, SEXP n_chainSEXP, SEXP asyncSEXP, SEXP n_threadSEXP, SEXP cache_MBSEXP, SEXP singleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type process_method(process_methodSEXP);
+    Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
+    Rcpp::traits::input_parameter< int >::type n_spat(n_spatSEXP);
+    Rcpp::traits::input_parameter< List >::type boundary(boundarySEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type x_Min(x_MinSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type x_Max(x_MaxSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type x_Init(x_InitSEXP);
+    Rcpp::traits::input_parameter< std::string >::type objective(objectiveSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type max_iter(max_iterSEXP);
+    Rcpp::traits::input_parameter< double >::type r(rSEXP);
+    Rcpp::traits::input_parameter< int >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type n_chain(n_chainSEXP);
+    Rcpp::traits::input_parameter< bool >::type async(asyncSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< double >::type cache_MB(cache_MBSEXP);
+    Rcpp::traits::input_parameter< bool >::type single(singleSEXP);
+    rcpp_result_gen = Rcpp::wrap(cali_DDS_engine(process_method, n_time, n_spat, boundary, param, observe, x_Min, x_Max, x_Init, objective, weight, max_iter, r, seed, n_chain, async, n_thread, cache_MB, single));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_cali_DDS_engine(SEXP process_methodSEXP, SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP boundarySEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP x_MinSEXP, SEXP x_MaxSEXP, SEXP x_InitSEXP, SEXP objectiveSEXP, SEXP weightSEXP, SEXP max_iterSEXP, SEXP rSEXP, SEXP seedSEXP, SEXP n_chainSEXP, SEXP asyncSEXP, SEXP n_threadSEXP, SEXP cache_MBSEXP, SEXP singleSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_cali_DDS_engine_try(process_methodSEXP, n_timeSEXP, n_spatSEXP, boundarySEXP, paramSEXP, observeSEXP, x_MinSEXP, x_MaxSEXP, x_InitSEXP, objectiveSEXP, weightSEXP, max_iterSEXP, rSEXP, seedSEXP, n_chainSEXP, asyncSEXP, n_threadSEXP, cache_MBSEXP, singleSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// EDCHM_GR4J_ensemble
+RObject EDCHM_GR4J_ensemble(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, NumericVector observe, CharacterVector out_objective, int n_thread);
+static SEXP _EDCHM_EDCHM_GR4J_ensemble_try(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP n_threadSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_objective(out_objectiveSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_GR4J_ensemble(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, observe, out_objective, n_thread));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_EDCHM_GR4J_ensemble(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP n_threadSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_GR4J_ensemble_try(n_timeSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, paramSEXP, observeSEXP, out_objectiveSEXP, n_threadSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// EDCHM_mini_ensemble
+RObject EDCHM_mini_ensemble(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, NumericVector observe, CharacterVector out_objective, int n_thread);
+static SEXP _EDCHM_EDCHM_mini_ensemble_try(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP n_threadSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_objective(out_objectiveSEXP);
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_mini_ensemble(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, observe, out_objective, n_thread));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_EDCHM_mini_ensemble(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP observeSEXP, SEXP out_objectiveSEXP, SEXP n_threadSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mini_ensemble_try(n_timeSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, paramSEXP, observeSEXP, out_objectiveSEXP, n_threadSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// EDCHM_mini
+RObject EDCHM_mini(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, int n_thread, CharacterVector out_variable);
+static SEXP _EDCHM_EDCHM_mini_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
     Rcpp::traits::input_parameter< int >::type n_spat(n_spatSEXP);
     Rcpp::traits::input_parameter< NumericMatrix >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
     Rcpp::traits::input_parameter< NumericMatrix >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
-    Rcpp::traits::input_parameter< NumericMatrix >::type atmos_temperature_Cel(atmos_temperature_CelSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type ground_capacity_mm(ground_capacity_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type ground_water_mm(ground_water_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type land_impermeableFrac_1(land_impermeableFrac_1SEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type snow_ice_mm(snow_ice_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type soil_capacity_mm(soil_capacity_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type soil_potentialPercola_mm(soil_potentialPercola_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type soil_water_mm(soil_water_mmSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type confluenLand_responseTime_TS(confluenLand_responseTime_TSSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type confluenGround_responseTime_TS(confluenGround_responseTime_TSSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_atmos_thr_Ts(param_atmos_thr_TsSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_baseflow_grf_gamma(param_baseflow_grf_gammaSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_confluenLand_kel_k(param_confluenLand_kel_kSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_evatrans_ubc_gamma(param_evatrans_ubc_gammaSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_infilt_ubc_P0AGEN(param_infilt_ubc_P0AGENSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_k(param_percola_arn_kSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_thresh(param_percola_arn_threshSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_snow_fac_f(param_snow_fac_fSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type param_snow_fac_Tmelt(param_snow_fac_TmeltSEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_snow(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, atmos_temperature_Cel, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, snow_ice_mm, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_atmos_thr_Ts, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh, param_snow_fac_f, param_snow_fac_Tmelt));
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_variable(out_variableSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_mini(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh, n_thread, out_variable));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_EDCHM_mini(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mini_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP, n_threadSEXP, out_variableSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// EDCHM_GR4J_sensitivity
+List EDCHM_GR4J_sensitivity(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, CharacterVector sensitivity_param, NumericVector observe, std::string objective);
+static SEXP _EDCHM_EDCHM_GR4J_sensitivity_try(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP sensitivity_paramSEXP, SEXP observeSEXP, SEXP objectiveSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type sensitivity_param(sensitivity_paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type objective(objectiveSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_GR4J_sensitivity(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, sensitivity_param, observe, objective));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_EDCHM_GR4J_sensitivity(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP sensitivity_paramSEXP, SEXP observeSEXP, SEXP objectiveSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_GR4J_sensitivity_try(n_timeSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, paramSEXP, sensitivity_paramSEXP, observeSEXP, objectiveSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// EDCHM_mini_sensitivity
+List EDCHM_mini_sensitivity(int n_time, NumericVector atmos_potentialEvatrans_mm, NumericVector atmos_precipitation_mm, List param, CharacterVector sensitivity_param, NumericVector observe, std::string objective);
+static SEXP _EDCHM_EDCHM_mini_sensitivity_try(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP sensitivity_paramSEXP, SEXP observeSEXP, SEXP objectiveSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_potentialEvatrans_mm(atmos_potentialEvatrans_mmSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type atmos_precipitation_mm(atmos_precipitation_mmSEXP);
+    Rcpp::traits::input_parameter< List >::type param(paramSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type sensitivity_param(sensitivity_paramSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observe(observeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type objective(objectiveSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_mini_sensitivity(n_time, atmos_potentialEvatrans_mm, atmos_precipitation_mm, param, sensitivity_param, observe, objective));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_snow(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP) {
+RcppExport SEXP _EDCHM_EDCHM_mini_sensitivity(SEXP n_timeSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP paramSEXP, SEXP sensitivity_paramSEXP, SEXP observeSEXP, SEXP objectiveSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_snow_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, atmos_temperature_CelSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, snow_ice_mmSEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_atmos_thr_TsSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP, param_snow_fac_fSEXP, param_snow_fac_TmeltSEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_mini_sensitivity_try(n_timeSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, paramSEXP, sensitivity_paramSEXP, observeSEXP, objectiveSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -257,9 +485,9 @@ RcppExport SEXP _EDCHM_EDCHM_snow(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_p
     UNPROTECT(1);
     return rcpp_result_gen;
 }
-// EDCHM_snow_full
-List EDCHM_snow_full(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt);
-static SEXP _EDCHM_EDCHM_snow_full_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP) {
+// EDCHM_snow
+RObject EDCHM_snow(int n_time, int n_spat, NumericMatrix atmos_potentialEvatrans_mm, NumericMatrix atmos_precipitation_mm, NumericMatrix atmos_temperature_Cel, NumericVector ground_capacity_mm, NumericVector ground_water_mm, NumericVector land_impermeableFrac_1, NumericVector snow_ice_mm, NumericVector soil_capacity_mm, NumericVector soil_potentialPercola_mm, NumericVector soil_water_mm, NumericVector confluenLand_responseTime_TS, NumericVector confluenGround_responseTime_TS, NumericVector param_atmos_thr_Ts, NumericVector param_baseflow_grf_gamma, NumericVector param_confluenLand_kel_k, NumericVector param_evatrans_ubc_gamma, NumericVector param_infilt_ubc_P0AGEN, NumericVector param_percola_arn_k, NumericVector param_percola_arn_thresh, NumericVector param_snow_fac_f, NumericVector param_snow_fac_Tmelt, int n_thread, CharacterVector out_variable);
+static SEXP _EDCHM_EDCHM_snow_try(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::traits::input_parameter< int >::type n_time(n_timeSEXP);
@@ -285,15 +513,17 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< NumericVector >::type param_percola_arn_thresh(param_percola_arn_threshSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_snow_fac_f(param_snow_fac_fSEXP);
     Rcpp::traits::input_parameter< NumericVector >::type param_snow_fac_Tmelt(param_snow_fac_TmeltSEXP);
-    rcpp_result_gen = Rcpp::wrap(EDCHM_snow_full(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, atmos_temperature_Cel, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, snow_ice_mm, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_atmos_thr_Ts, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh, param_snow_fac_f, param_snow_fac_Tmelt));
+    Rcpp::traits::input_parameter< int >::type n_thread(n_threadSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type out_variable(out_variableSEXP);
+    rcpp_result_gen = Rcpp::wrap(EDCHM_snow(n_time, n_spat, atmos_potentialEvatrans_mm, atmos_precipitation_mm, atmos_temperature_Cel, ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, snow_ice_mm, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm, confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_atmos_thr_Ts, param_baseflow_grf_gamma, param_confluenLand_kel_k, param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh, param_snow_fac_f, param_snow_fac_Tmelt, n_thread, out_variable));
     return rcpp_result_gen;
 END_RCPP_RETURN_ERROR
 }
-RcppExport SEXP _EDCHM_EDCHM_snow_full(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP) {
+RcppExport SEXP _EDCHM_EDCHM_snow(SEXP n_timeSEXP, SEXP n_spatSEXP, SEXP atmos_potentialEvatrans_mmSEXP, SEXP atmos_precipitation_mmSEXP, SEXP atmos_temperature_CelSEXP, SEXP ground_capacity_mmSEXP, SEXP ground_water_mmSEXP, SEXP land_impermeableFrac_1SEXP, SEXP snow_ice_mmSEXP, SEXP soil_capacity_mmSEXP, SEXP soil_potentialPercola_mmSEXP, SEXP soil_water_mmSEXP, SEXP confluenLand_responseTime_TSSEXP, SEXP confluenGround_responseTime_TSSEXP, SEXP param_atmos_thr_TsSEXP, SEXP param_baseflow_grf_gammaSEXP, SEXP param_confluenLand_kel_kSEXP, SEXP param_evatrans_ubc_gammaSEXP, SEXP param_infilt_ubc_P0AGENSEXP, SEXP param_percola_arn_kSEXP, SEXP param_percola_arn_threshSEXP, SEXP param_snow_fac_fSEXP, SEXP param_snow_fac_TmeltSEXP, SEXP n_threadSEXP, SEXP out_variableSEXP) {
     SEXP rcpp_result_gen;
     {
         Rcpp::RNGScope rcpp_rngScope_gen;
-        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_snow_full_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, atmos_temperature_CelSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, snow_ice_mmSEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_atmos_thr_TsSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP, param_snow_fac_fSEXP, param_snow_fac_TmeltSEXP));
+        rcpp_result_gen = PROTECT(_EDCHM_EDCHM_snow_try(n_timeSEXP, n_spatSEXP, atmos_potentialEvatrans_mmSEXP, atmos_precipitation_mmSEXP, atmos_temperature_CelSEXP, ground_capacity_mmSEXP, ground_water_mmSEXP, land_impermeableFrac_1SEXP, snow_ice_mmSEXP, soil_capacity_mmSEXP, soil_potentialPercola_mmSEXP, soil_water_mmSEXP, confluenLand_responseTime_TSSEXP, confluenGround_responseTime_TSSEXP, param_atmos_thr_TsSEXP, param_baseflow_grf_gammaSEXP, param_confluenLand_kel_kSEXP, param_evatrans_ubc_gammaSEXP, param_infilt_ubc_P0AGENSEXP, param_percola_arn_kSEXP, param_percola_arn_threshSEXP, param_snow_fac_fSEXP, param_snow_fac_TmeltSEXP, n_threadSEXP, out_variableSEXP));
     }
     Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
     if (rcpp_isInterrupt_gen) {
@@ -903,6 +1133,77 @@ RcppExport SEXP _EDCHM_confluen_IUH3S(SEXP land_runoff_mmSEXP, SEXP soil_interfl
     UNPROTECT(1);
     return rcpp_result_gen;
 }
+// confluen_IIR_Clark
+NumericVector confluen_IIR_Clark(NumericVector confluen_inputWater_mm, double confluen_responseTime_TS);
+static SEXP _EDCHM_confluen_IIR_Clark_try(SEXP confluen_inputWater_mmSEXP, SEXP confluen_responseTime_TSSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type confluen_inputWater_mm(confluen_inputWater_mmSEXP);
+    Rcpp::traits::input_parameter< double >::type confluen_responseTime_TS(confluen_responseTime_TSSEXP);
+    rcpp_result_gen = Rcpp::wrap(confluen_IIR_Clark(confluen_inputWater_mm, confluen_responseTime_TS));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_confluen_IIR_Clark(SEXP confluen_inputWater_mmSEXP, SEXP confluen_responseTime_TSSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_confluen_IIR_Clark_try(confluen_inputWater_mmSEXP, confluen_responseTime_TSSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
+// confluen_IIR_Nash
+NumericVector confluen_IIR_Nash(NumericVector confluen_inputWater_mm, double confluen_responseTime_TS, double param_confluen_nas_n);
+static SEXP _EDCHM_confluen_IIR_Nash_try(SEXP confluen_inputWater_mmSEXP, SEXP confluen_responseTime_TSSEXP, SEXP param_confluen_nas_nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type confluen_inputWater_mm(confluen_inputWater_mmSEXP);
+    Rcpp::traits::input_parameter< double >::type confluen_responseTime_TS(confluen_responseTime_TSSEXP);
+    Rcpp::traits::input_parameter< double >::type param_confluen_nas_n(param_confluen_nas_nSEXP);
+    rcpp_result_gen = Rcpp::wrap(confluen_IIR_Nash(confluen_inputWater_mm, confluen_responseTime_TS, param_confluen_nas_n));
+    return rcpp_result_gen;
+END_RCPP_RETURN_ERROR
+}
+RcppExport SEXP _EDCHM_confluen_IIR_Nash(SEXP confluen_inputWater_mmSEXP, SEXP confluen_responseTime_TSSEXP, SEXP param_confluen_nas_nSEXP) {
+    SEXP rcpp_result_gen;
+    {
+        Rcpp::RNGScope rcpp_rngScope_gen;
+        rcpp_result_gen = PROTECT(_EDCHM_confluen_IIR_Nash_try(confluen_inputWater_mmSEXP, confluen_responseTime_TSSEXP, param_confluen_nas_nSEXP));
+    }
+    Rboolean rcpp_isInterrupt_gen = Rf_inherits(rcpp_result_gen, "interrupted-error");
+    if (rcpp_isInterrupt_gen) {
+        UNPROTECT(1);
+        Rf_onintr();
+    }
+    bool rcpp_isLongjump_gen = Rcpp::internal::isLongjumpSentinel(rcpp_result_gen);
+    if (rcpp_isLongjump_gen) {
+        Rcpp::internal::resumeJump(rcpp_result_gen);
+    }
+    Rboolean rcpp_isError_gen = Rf_inherits(rcpp_result_gen, "try-error");
+    if (rcpp_isError_gen) {
+        SEXP rcpp_msgSEXP_gen = Rf_asChar(rcpp_result_gen);
+        UNPROTECT(1);
+        Rf_error(CHAR(rcpp_msgSEXP_gen));
+    }
+    UNPROTECT(1);
+    return rcpp_result_gen;
+}
 // confluenIUH_GR4J1
 NumericVector confluenIUH_GR4J1(double confluen_responseTime_TS);
 static SEXP _EDCHM_confluenIUH_GR4J1_try(SEXP confluen_responseTime_TSSEXP) {
@@ -2707,12 +3008,18 @@ RcppExport SEXP _EDCHM_snowMelt_Factor(SEXP snow_ice_mmSEXP, SEXP atmos_temperat
 static int _EDCHM_RcppExport_validate(const char* sig) { 
     static std::set<std::string> signatures;
     if (signatures.empty()) {
-        signatures.insert("NumericMatrix(*EDCHM_GR4J)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-        signatures.insert("List(*EDCHM_GR4J_full)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-        signatures.insert("NumericMatrix(*EDCHM_mini)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-        signatures.insert("List(*EDCHM_mini_full)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-        signatures.insert("NumericMatrix(*EDCHM_snow)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
-        signatures.insert("List(*EDCHM_snow_full)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
+        signatures.insert("std::string(*EDCHM_mathMode)(std::string)");
+        signatures.insert("RObject(*EDCHM_GR4J)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector,bool)");
+        signatures.insert("RObject(*EDCHM_engine)(CharacterVector,int,int,List,List,int,CharacterVector,bool)");
+        signatures.insert("double(*EDCHM_engine_SSE)(CharacterVector,int,int,List,List,NumericVector,double,NumericVector,int,bool)");
+        signatures.insert("NumericVector(*EDCHM_engine_objective)(CharacterVector,int,int,List,List,NumericVector,CharacterVector,NumericVector,int,bool)");
+        signatures.insert("List(*cali_DDS_engine)(CharacterVector,int,int,List,List,NumericVector,NumericVector,NumericVector,NumericVector,std::string,NumericVector,int,double,int,int,bool,int,double,bool)");
+        signatures.insert("RObject(*EDCHM_GR4J_ensemble)(int,NumericVector,NumericVector,List,NumericVector,CharacterVector,int)");
+        signatures.insert("RObject(*EDCHM_mini_ensemble)(int,NumericVector,NumericVector,List,NumericVector,CharacterVector,int)");
+        signatures.insert("RObject(*EDCHM_mini)(int,int,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector)");
+        signatures.insert("List(*EDCHM_GR4J_sensitivity)(int,NumericVector,NumericVector,List,CharacterVector,NumericVector,std::string)");
+        signatures.insert("List(*EDCHM_mini_sensitivity)(int,NumericVector,NumericVector,List,CharacterVector,NumericVector,std::string)");
+        signatures.insert("RObject(*EDCHM_snow)(int,int,NumericMatrix,NumericMatrix,NumericMatrix,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,int,CharacterVector)");
         signatures.insert("NumericVector(*atmosSnow_ThresholdT)(NumericVector,NumericVector,NumericVector)");
         signatures.insert("NumericVector(*atmosSnow_UBC)(NumericVector,NumericVector,NumericVector)");
         signatures.insert("NumericVector(*baseflow_GR4J)(NumericVector,NumericVector)");
@@ -2729,6 +3036,8 @@ static int _EDCHM_RcppExport_validate(const char* sig) {
         signatures.insert("NumericVector(*confluen_IUH)(NumericVector,NumericVector)");
         signatures.insert("NumericVector(*confluen_IUH2S)(NumericVector,NumericVector,NumericVector,NumericVector)");
         signatures.insert("NumericVector(*confluen_IUH3S)(NumericVector,NumericVector,NumericVector,NumericVector,NumericVector,NumericVector)");
+        signatures.insert("NumericVector(*confluen_IIR_Clark)(NumericVector,double)");
+        signatures.insert("NumericVector(*confluen_IIR_Nash)(NumericVector,double,double)");
         signatures.insert("NumericVector(*confluenIUH_GR4J1)(double)");
         signatures.insert("NumericVector(*confluenIUH_GR4J2)(double)");
         signatures.insert("NumericVector(*confluenIUH_Kelly)(double,double)");
@@ -2784,12 +3093,18 @@ static int _EDCHM_RcppExport_validate(const char* sig) {
 
 // registerCCallable (register entry points for exported C++ functions)
 RcppExport SEXP _EDCHM_RcppExport_registerCCallable() { 
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_mathMode", (DL_FUNC)_EDCHM_EDCHM_mathMode_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_GR4J", (DL_FUNC)_EDCHM_EDCHM_GR4J_try);
-    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_full", (DL_FUNC)_EDCHM_EDCHM_GR4J_full_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_engine", (DL_FUNC)_EDCHM_EDCHM_engine_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_engine_SSE", (DL_FUNC)_EDCHM_EDCHM_engine_SSE_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_engine_objective", (DL_FUNC)_EDCHM_EDCHM_engine_objective_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_cali_DDS_engine", (DL_FUNC)_EDCHM_cali_DDS_engine_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_ensemble", (DL_FUNC)_EDCHM_EDCHM_GR4J_ensemble_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_mini_ensemble", (DL_FUNC)_EDCHM_EDCHM_mini_ensemble_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_mini", (DL_FUNC)_EDCHM_EDCHM_mini_try);
-    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_mini_full", (DL_FUNC)_EDCHM_EDCHM_mini_full_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_GR4J_sensitivity", (DL_FUNC)_EDCHM_EDCHM_GR4J_sensitivity_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_mini_sensitivity", (DL_FUNC)_EDCHM_EDCHM_mini_sensitivity_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_snow", (DL_FUNC)_EDCHM_EDCHM_snow_try);
-    R_RegisterCCallable("EDCHM", "_EDCHM_EDCHM_snow_full", (DL_FUNC)_EDCHM_EDCHM_snow_full_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_atmosSnow_ThresholdT", (DL_FUNC)_EDCHM_atmosSnow_ThresholdT_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_atmosSnow_UBC", (DL_FUNC)_EDCHM_atmosSnow_UBC_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_baseflow_GR4J", (DL_FUNC)_EDCHM_baseflow_GR4J_try);
@@ -2806,6 +3121,8 @@ RcppExport SEXP _EDCHM_RcppExport_registerCCallable() {
     R_RegisterCCallable("EDCHM", "_EDCHM_confluen_IUH", (DL_FUNC)_EDCHM_confluen_IUH_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_confluen_IUH2S", (DL_FUNC)_EDCHM_confluen_IUH2S_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_confluen_IUH3S", (DL_FUNC)_EDCHM_confluen_IUH3S_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_confluen_IIR_Clark", (DL_FUNC)_EDCHM_confluen_IIR_Clark_try);
+    R_RegisterCCallable("EDCHM", "_EDCHM_confluen_IIR_Nash", (DL_FUNC)_EDCHM_confluen_IIR_Nash_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_confluenIUH_GR4J1", (DL_FUNC)_EDCHM_confluenIUH_GR4J1_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_confluenIUH_GR4J2", (DL_FUNC)_EDCHM_confluenIUH_GR4J2_try);
     R_RegisterCCallable("EDCHM", "_EDCHM_confluenIUH_Kelly", (DL_FUNC)_EDCHM_confluenIUH_Kelly_try);
@@ -2860,12 +3177,18 @@ RcppExport SEXP _EDCHM_RcppExport_registerCCallable() {
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_EDCHM_EDCHM_GR4J", (DL_FUNC) &_EDCHM_EDCHM_GR4J, 10},
-    {"_EDCHM_EDCHM_GR4J_full", (DL_FUNC) &_EDCHM_EDCHM_GR4J_full, 10},
-    {"_EDCHM_EDCHM_mini", (DL_FUNC) &_EDCHM_EDCHM_mini, 18},
-    {"_EDCHM_EDCHM_mini_full", (DL_FUNC) &_EDCHM_EDCHM_mini_full, 18},
-    {"_EDCHM_EDCHM_snow", (DL_FUNC) &_EDCHM_EDCHM_snow, 23},
-    {"_EDCHM_EDCHM_snow_full", (DL_FUNC) &_EDCHM_EDCHM_snow_full, 23},
+    {"_EDCHM_EDCHM_mathMode", (DL_FUNC) &_EDCHM_EDCHM_mathMode, 1},
+    {"_EDCHM_EDCHM_GR4J", (DL_FUNC) &_EDCHM_EDCHM_GR4J, 13},
+    {"_EDCHM_EDCHM_engine", (DL_FUNC) &_EDCHM_EDCHM_engine, 8},
+    {"_EDCHM_EDCHM_engine_SSE", (DL_FUNC) &_EDCHM_EDCHM_engine_SSE, 10},
+    {"_EDCHM_EDCHM_engine_objective", (DL_FUNC) &_EDCHM_EDCHM_engine_objective, 10},
+    {"_EDCHM_cali_DDS_engine", (DL_FUNC) &_EDCHM_cali_DDS_engine, 19},
+    {"_EDCHM_EDCHM_GR4J_ensemble", (DL_FUNC) &_EDCHM_EDCHM_GR4J_ensemble, 7},
+    {"_EDCHM_EDCHM_mini_ensemble", (DL_FUNC) &_EDCHM_EDCHM_mini_ensemble, 7},
+    {"_EDCHM_EDCHM_mini", (DL_FUNC) &_EDCHM_EDCHM_mini, 20},
+    {"_EDCHM_EDCHM_GR4J_sensitivity", (DL_FUNC) &_EDCHM_EDCHM_GR4J_sensitivity, 7},
+    {"_EDCHM_EDCHM_mini_sensitivity", (DL_FUNC) &_EDCHM_EDCHM_mini_sensitivity, 7},
+    {"_EDCHM_EDCHM_snow", (DL_FUNC) &_EDCHM_EDCHM_snow, 25},
     {"_EDCHM_atmosSnow_ThresholdT", (DL_FUNC) &_EDCHM_atmosSnow_ThresholdT, 3},
     {"_EDCHM_atmosSnow_UBC", (DL_FUNC) &_EDCHM_atmosSnow_UBC, 3},
     {"_EDCHM_baseflow_GR4J", (DL_FUNC) &_EDCHM_baseflow_GR4J, 2},
@@ -2882,6 +3205,8 @@ static const R_CallMethodDef CallEntries[] = {
     {"_EDCHM_confluen_IUH", (DL_FUNC) &_EDCHM_confluen_IUH, 2},
     {"_EDCHM_confluen_IUH2S", (DL_FUNC) &_EDCHM_confluen_IUH2S, 4},
     {"_EDCHM_confluen_IUH3S", (DL_FUNC) &_EDCHM_confluen_IUH3S, 6},
+    {"_EDCHM_confluen_IIR_Clark", (DL_FUNC) &_EDCHM_confluen_IIR_Clark, 2},
+    {"_EDCHM_confluen_IIR_Nash", (DL_FUNC) &_EDCHM_confluen_IIR_Nash, 3},
     {"_EDCHM_confluenIUH_GR4J1", (DL_FUNC) &_EDCHM_confluenIUH_GR4J1, 1},
     {"_EDCHM_confluenIUH_GR4J2", (DL_FUNC) &_EDCHM_confluenIUH_GR4J2, 1},
     {"_EDCHM_confluenIUH_Kelly", (DL_FUNC) &_EDCHM_confluenIUH_Kelly, 2},
@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -56,7 +58,9 @@ NumericVector atmosSnow_ThresholdT(
     NumericVector param_atmos_thr_Ts
 )
 {
-  return ifelse(atmos_temperature_Cel > param_atmos_thr_Ts, 0, atmos_precipitation_mm);
+  NumericVector atmos_snow_mm(atmos_precipitation_mm.size());
+  span::atmosSnow_ThresholdT(atmos_precipitation_mm.size(), atmos_precipitation_mm.begin(), atmos_temperature_Cel.begin(), param_atmos_thr_Ts.begin(), atmos_snow_mm.begin());
+  return atmos_snow_mm;
 }
 
 //' @rdname atmosSnow
@@ -81,8 +85,7 @@ NumericVector atmosSnow_UBC(
     NumericVector param_atmos_ubc_A0FORM
 )
 {
-  NumericVector atmos_snow_mm;
-  atmos_snow_mm = (1 - atmos_temperature_Cel / param_atmos_ubc_A0FORM) * atmos_precipitation_mm;
-  atmos_snow_mm = ifelse(atmos_temperature_Cel <= 0, atmos_precipitation_mm, atmos_snow_mm);
-  return ifelse(atmos_temperature_Cel > param_atmos_ubc_A0FORM, 0, atmos_snow_mm);
+  NumericVector atmos_snow_mm(atmos_precipitation_mm.size());
+  span::atmosSnow_UBC(atmos_precipitation_mm.size(), atmos_precipitation_mm.begin(), atmos_temperature_Cel.begin(), param_atmos_ubc_A0FORM.begin(), atmos_snow_mm.begin());
+  return atmos_snow_mm;
 }
@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -58,12 +60,9 @@ NumericVector baseflow_GR4J(
     NumericVector ground_capacity_mm
 )
 {
-  NumericVector baseflow_, k_;
-  
-  k_ = 1 - pow((1 + pow(ground_water_mm / ground_capacity_mm, 4)), -0.25);
-  baseflow_ = k_ * ground_water_mm;
-  
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_GR4J(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 //' @rdname baseflow
@@ -87,12 +86,9 @@ NumericVector baseflow_GR4Jfix(
     NumericVector param_baseflow_grf_gamma
 )
 {
-  NumericVector baseflow_, k_;
-  
-  k_ = 1 - vecpow((1 + vecpow(ground_water_mm / ground_capacity_mm, param_baseflow_grf_gamma)), -1.0 / param_baseflow_grf_gamma);
-  baseflow_ = k_ * ground_water_mm;
-  
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_GR4Jfix(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), param_baseflow_grf_gamma.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 //' @rdname baseflow
@@ -113,9 +109,9 @@ NumericVector baseflow_SupplyRatio(
     NumericVector param_baseflow_sur_k
 )
 {
-  
-  return param_baseflow_sur_k * ground_water_mm;
-  
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_SupplyRatio(ground_water_mm.size(), ground_water_mm.begin(), param_baseflow_sur_k.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 
@@ -140,11 +136,9 @@ NumericVector baseflow_SupplyPow(
     NumericVector param_baseflow_sup_gamma
 )
 {
-  NumericVector baseflow_;
-  
-  baseflow_ = param_baseflow_sup_k * vecpow(ceil(ground_water_mm), param_baseflow_sup_gamma);
-
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_SupplyPow(ground_water_mm.size(), ground_water_mm.begin(), param_baseflow_sup_k.begin(), param_baseflow_sup_gamma.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 
@@ -169,11 +163,9 @@ NumericVector baseflow_MaxPow(
     NumericVector param_baseflow_map_gamma
 )
 {
-  NumericVector baseflow_;
-  
-  baseflow_ = ground_potentialBaseflow_mm * vecpow(ground_water_mm / ground_capacity_mm, param_baseflow_map_gamma);
-  
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_MaxPow(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialBaseflow_mm.begin(), param_baseflow_map_gamma.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 //' @rdname baseflow
@@ -201,14 +193,9 @@ NumericVector baseflow_ThreshPow(
     NumericVector param_baseflow_thp_gamma
 )
 {
-  NumericVector baseflow_, baseflow_temp;
-  baseflow_temp = (ground_water_mm / ground_capacity_mm - param_baseflow_thp_thresh);
-  baseflow_temp = ifelse(baseflow_temp < 0, 0, baseflow_temp);
-  
-  baseflow_ = ground_potentialBaseflow_mm * vecpow(baseflow_temp / (1 - param_baseflow_thp_thresh), param_baseflow_thp_gamma);
-  baseflow_ = ifelse(baseflow_ > ground_potentialBaseflow_mm, ground_potentialBaseflow_mm, baseflow_);
-  
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_ThreshPow(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialBaseflow_mm.begin(), param_baseflow_thp_thresh.begin(), param_baseflow_thp_gamma.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
 
 
@@ -238,12 +225,7 @@ NumericVector baseflow_Arno(
     NumericVector param_baseflow_arn_k
 )
 {
-  NumericVector baseflow_, baseflow_1, baseflow_2, Ws_Wc;
-  Ws_Wc = ground_capacity_mm * param_baseflow_arn_thresh;
-  baseflow_1 = param_baseflow_arn_k * ground_potentialBaseflow_mm / (ground_capacity_mm) * ground_water_mm;
-  baseflow_2 = param_baseflow_arn_k * ground_potentialBaseflow_mm / (ground_capacity_mm) * ground_water_mm + ground_potentialBaseflow_mm * (1 - param_baseflow_arn_k) * pow((ground_water_mm - Ws_Wc) / (ground_capacity_mm - Ws_Wc),2);
-  baseflow_ = ifelse(ground_water_mm < Ws_Wc, baseflow_1, baseflow_2);
-  baseflow_ = ifelse(ground_potentialBaseflow_mm > Ws_Wc, ground_water_mm, baseflow_);
-  baseflow_ = ifelse(baseflow_ > ground_potentialBaseflow_mm, ground_potentialBaseflow_mm, baseflow_);
-  return ifelse(baseflow_ > ground_water_mm, ground_water_mm, baseflow_) ;
+  NumericVector ground_baseflow_mm(ground_water_mm.size());
+  span::baseflow_Arno(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialBaseflow_mm.begin(), param_baseflow_arn_thresh.begin(), param_baseflow_arn_k.begin(), ground_baseflow_mm.begin());
+  return ground_baseflow_mm;
 }
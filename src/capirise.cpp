@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -63,13 +65,9 @@ NumericVector capirise_HBV(
     NumericVector soil_potentialCapirise_mm
 )
 {
-  NumericVector soil_diff_mm, capirise_mm, limit_mm;
-  soil_diff_mm = soil_capacity_mm  - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < 0, 0, soil_diff_mm);
-  capirise_mm = soil_potentialCapirise_mm * (soil_diff_mm / soil_capacity_mm);
-  
-  limit_mm = ifelse(soil_diff_mm > ground_water_mm, ground_water_mm, soil_diff_mm) ;
-  return ifelse(capirise_mm > limit_mm, limit_mm, capirise_mm) ;
+  NumericVector ground_capilarise_mm(ground_water_mm.size());
+  span::capirise_HBV(ground_water_mm.size(), ground_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialCapirise_mm.begin(), ground_capilarise_mm.begin());
+  return ground_capilarise_mm;
 }
 
 
@@ -94,13 +92,9 @@ NumericVector capirise_HBVfix(
     NumericVector soil_potentialCapirise_mm
 )
 {
-  NumericVector soil_diff_mm, capirise_mm, limit_mm;
-  soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < 0, 0, soil_diff_mm);
-  capirise_mm = soil_potentialCapirise_mm * (soil_diff_mm / soil_capacity_mm);
-  
-  limit_mm = ifelse(soil_diff_mm > ground_water_mm, ground_water_mm, soil_diff_mm) ;
-  return ifelse(capirise_mm > limit_mm, limit_mm, capirise_mm) ;
+  NumericVector ground_capilarise_mm(ground_water_mm.size());
+  span::capirise_HBVfix(ground_water_mm.size(), ground_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_fieldCapacityPerc_1.begin(), soil_potentialCapirise_mm.begin(), ground_capilarise_mm.begin());
+  return ground_capilarise_mm;
 }
 
 //' @rdname capirise
@@ -125,13 +119,9 @@ NumericVector capirise_AcceptRatio(
     NumericVector param_capirise_acr_k
 )
 {
-  NumericVector soil_diff_mm, capirise_mm, limit_mm;
-  soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < 0, 0, soil_diff_mm);
-  capirise_mm = soil_diff_mm * param_capirise_acr_k;
-  
-  limit_mm = ifelse(soil_diff_mm > ground_water_mm, ground_water_mm, soil_diff_mm) ;
-  return ifelse(capirise_mm > limit_mm, limit_mm, capirise_mm) ;
+  NumericVector ground_capilarise_mm(ground_water_mm.size());
+  span::capirise_AcceptRatio(ground_water_mm.size(), ground_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_fieldCapacityPerc_1.begin(), param_capirise_acr_k.begin(), ground_capilarise_mm.begin());
+  return ground_capilarise_mm;
 }
 
 
@@ -161,16 +151,9 @@ NumericVector capirise_AcceptPow(
     NumericVector param_capirise_acp_gamma
 )
 {
-  NumericVector capirise_mm, k_, soil_diff_mm, limit_mm;
-  soil_diff_mm = soil_capacity_mm * (1 - soil_fieldCapacityPerc_1) - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < 0, 0, soil_diff_mm);
-  
-  k_ = param_capirise_acp_k * vecpow((soil_diff_mm / (soil_capacity_mm * (1 - soil_fieldCapacityPerc_1))), param_capirise_acp_gamma);
-  capirise_mm = k_ * soil_diff_mm;
-  capirise_mm = ifelse(capirise_mm < 0, 0, capirise_mm);
-  
-  limit_mm = ifelse(soil_diff_mm > ground_water_mm, ground_water_mm, soil_diff_mm) ;
-  return ifelse(capirise_mm > limit_mm, limit_mm, capirise_mm) ;
+  NumericVector ground_capilarise_mm(ground_water_mm.size());
+  span::capirise_AcceptPow(ground_water_mm.size(), ground_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_fieldCapacityPerc_1.begin(), param_capirise_acp_k.begin(), param_capirise_acp_gamma.begin(), ground_capilarise_mm.begin());
+  return ground_capilarise_mm;
 }
 
 
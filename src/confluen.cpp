@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_confluen.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -18,6 +20,11 @@
 //' - `IUH2S`: IUH with two water sources, each with a different IUH vector, 
 //' - `IUH3S`: IUH with three water sources, each with a different IUH vector.
 //' 
+//' For IUH vectors shorter than 64 steps the convolution is the direct sum,
+//' for longer ones (e.g. slow groundwater with [confluenIUH_Nash()] or [confluenIUH_Clark()] on hourly data)
+//' an overlap-add FFT convolution is used, which gives the same result up to round-off.
+//' The water sources of `IUH2S` and `IUH3S` must have the same length.
+//' 
 //' Under the concept of the conceptual HM, the water flux to the water flow will be calculated using the confluence process. 
 //' This process does not calculate the water balance, but rather the time-varying nature of the water flow. 
 //' The "Instant Unit Hydrograph" method is the most effective way to deal with time-varying flows. 
@@ -46,22 +53,12 @@ NumericVector confluen_IUH(
     NumericVector confluen_iuh_1
 )
 {
-  
-  int n_iuh = confluen_iuh_1.size(), n_time = confluen_inputWater_mm.size();
+  int n_time = confluen_inputWater_mm.size();
   NumericVector confluen_outputWater_mm (n_time);
-  for (int i = 0; i < n_iuh; i++) {
-    for (int j = 0; j <= i; j++) {
-      confluen_outputWater_mm[i] += confluen_inputWater_mm[i-j] * confluen_iuh_1[j];
-    }
-  }
-  for (int i = n_iuh; i < n_time; i++) {
-    for (int j = 0; j < n_iuh; j++) {
-      confluen_outputWater_mm[i] += confluen_inputWater_mm[i-j] * confluen_iuh_1[j];
-    }
-  }
-  
+  kernel::confluen_IUH(n_time, confluen_inputWater_mm.begin(),
+                       confluen_iuh_1.size(), confluen_iuh_1.begin(),
+                       confluen_outputWater_mm.begin());
   return confluen_outputWater_mm;
-  
 }
 
 //' @rdname confluen
@@ -74,19 +71,14 @@ NumericVector confluen_IUH2S(
     NumericVector confluen_iuhGround_1
 )
 {
-  NumericVector confluen_runoff_mm (land_runoff_mm.size()), confluen_baseflow_mm (ground_baseflow_mm.size());
-  confluen_runoff_mm = confluen_IUH(
-    land_runoff_mm, 
-    confluen_iuhLand_1
-  );
-  confluen_baseflow_mm = confluen_IUH(
-    ground_baseflow_mm, 
-    confluen_iuhGround_1
-  );
-  
-
-  return confluen_runoff_mm + confluen_baseflow_mm;
-  
+  int n_time = land_runoff_mm.size();
+  if (ground_baseflow_mm.size() != n_time) stop("`ground_baseflow_mm` must have the length of `land_runoff_mm`.");
+  NumericVector confluen_streamflow_mm (n_time);
+  kernel::confluen_IUH2S(n_time, land_runoff_mm.begin(), ground_baseflow_mm.begin(),
+                         confluen_iuhLand_1.size(), confluen_iuhLand_1.begin(),
+                         confluen_iuhGround_1.size(), confluen_iuhGround_1.begin(),
+                         confluen_streamflow_mm.begin());
+  return confluen_streamflow_mm;
 }
 
 //' @rdname confluen
@@ -101,23 +93,62 @@ NumericVector confluen_IUH3S(
     NumericVector confluen_iuhGround_1
 )
 {
-  NumericVector confluen_runoff_mm (land_runoff_mm.size()), confluen_interflow_mm (soil_interflow_mm.size()), confluen_baseflow_mm (ground_baseflow_mm.size());
-  confluen_runoff_mm = confluen_IUH(
-    land_runoff_mm, 
-    confluen_iuhLand_1
-  );
-  confluen_interflow_mm = confluen_IUH(
-    soil_interflow_mm, 
-    confluen_iuhSoil_1
-  );
-  confluen_baseflow_mm = confluen_IUH(
-    ground_baseflow_mm, 
-    confluen_iuhGround_1
-  );
-  
-  
-  return confluen_runoff_mm + confluen_interflow_mm + confluen_baseflow_mm;
-  
+  int n_time = land_runoff_mm.size();
+  if (soil_interflow_mm.size() != n_time) stop("`soil_interflow_mm` must have the length of `land_runoff_mm`.");
+  if (ground_baseflow_mm.size() != n_time) stop("`ground_baseflow_mm` must have the length of `land_runoff_mm`.");
+  NumericVector confluen_streamflow_mm (n_time);
+  kernel::confluen_IUH3S(n_time, land_runoff_mm.begin(), soil_interflow_mm.begin(), ground_baseflow_mm.begin(),
+                         confluen_iuhLand_1.size(), confluen_iuhLand_1.begin(),
+                         confluen_iuhSoil_1.size(), confluen_iuhSoil_1.begin(),
+                         confluen_iuhGround_1.size(), confluen_iuhGround_1.begin(),
+                         confluen_streamflow_mm.begin());
+  return confluen_streamflow_mm;
+}
+
+//' @rdname confluen
+//' @details
+//' # **IIR**: 
+//' 
+//' `confluen_IIR_Clark` and `confluen_IIR_Nash` route with the recursive (IIR) form of 
+//' [confluenIUH_Clark()] and [confluenIUH_Nash()], one linear reservoir or a cascade of `n` linear reservoirs 
+//' with storage constant \mjseqn{t_r}, without IUH table, truncation and convolution:
+//' 
+//' \mjsdeqn{S_{t} = \Phi (S_{t-1} + F_t e_1), \quad Q_t = c^T (S_{t-1} + F_t e_1)}
+//' 
+//' where
+//' - \mjseqn{S} are the storages in the reservoirs, \mjseqn{\Phi_{ij} = e^{-1/t_r} (1/t_r)^{i-j} / (i-j)!}
+//' - \mjseqn{c_j} is the probability that a Poisson(\mjseqn{1/t_r}) variable is at least \mjseqn{n - j}
+//' - \mjseqn{n} is `param_confluen_nas_n`, rounded to a whole number
+//' 
+//' The result is the IUH integrated over every time step, so it differs slightly from the 
+//' sampled and truncated IUH tables.
+//' @inheritParams all_param
+//' @export
+// [[Rcpp::export]]
+NumericVector confluen_IIR_Clark(
+    NumericVector confluen_inputWater_mm, 
+    double confluen_responseTime_TS
+)
+{
+  int n_time = confluen_inputWater_mm.size();
+  NumericVector confluen_outputWater_mm (n_time);
+  kernel::confluen_IIR_Clark(n_time, confluen_inputWater_mm.begin(), confluen_responseTime_TS, confluen_outputWater_mm.begin());
+  return confluen_outputWater_mm;
+}
+
+//' @rdname confluen
+//' @export
+// [[Rcpp::export]]
+NumericVector confluen_IIR_Nash(
+    NumericVector confluen_inputWater_mm, 
+    double confluen_responseTime_TS,
+    double param_confluen_nas_n
+)
+{
+  int n_time = confluen_inputWater_mm.size();
+  NumericVector confluen_outputWater_mm (n_time);
+  kernel::confluen_IIR_Nash(n_time, confluen_inputWater_mm.begin(), confluen_responseTime_TS, param_confluen_nas_n, confluen_outputWater_mm.begin());
+  return confluen_outputWater_mm;
 }
 
 
@@ -161,13 +192,8 @@ NumericVector confluenIUH_GR4J1(
     double confluen_responseTime_TS
 )
 {
-  double t_max = ceil(confluen_responseTime_TS);
-  IntegerVector seq_t = seq(1, t_max);
-  NumericVector seq_t2 = as<NumericVector>(seq_t);
-  NumericVector SH_1 = pow(( seq_t2/ confluen_responseTime_TS), 2.5);
-  SH_1(t_max - 1) = 1;
-  SH_1[Range(1, t_max - 1)] = diff(SH_1);
-  return SH_1;
+  IUH_ptr iuh_ = confluenIUH_cached(IUH_GR4J1, confluen_responseTime_TS);
+  return NumericVector(iuh_->begin(), iuh_->end());
 }
 
 
@@ -192,21 +218,8 @@ NumericVector confluenIUH_GR4J2(
     double confluen_responseTime_TS
 )
 {
-  double t_max_1 = ceil(confluen_responseTime_TS);
-  double t_max_2 = ceil(2 * confluen_responseTime_TS);
-  IntegerVector seq_t1 = seq(1, t_max_1 - 1);
-  NumericVector seq_t12 = as<NumericVector>(seq_t1);
-  IntegerVector seq_t2 = seq(t_max_1, (t_max_2 - 1));
-  NumericVector seq_t22 = as<NumericVector>(seq_t2);
-  
-  NumericVector SH_2_1 = .5 * pow((seq_t12 / confluen_responseTime_TS),2.5);
-  NumericVector SH_2_2 = 1 - .5 * pow((2 - seq_t22 / confluen_responseTime_TS),2.5);
-  NumericVector SH_2(t_max_2, 1);
-  SH_2[Range(0, t_max_1 - 2)] = SH_2_1;
-  SH_2[Range(t_max_1 - 1, t_max_2 - 2)] = SH_2_2;
-  SH_2[Range(1, t_max_2 - 1)] = diff(SH_2);
-  
-  return SH_2;
+  IUH_ptr iuh_ = confluenIUH_cached(IUH_GR4J2, confluen_responseTime_TS);
+  return NumericVector(iuh_->begin(), iuh_->end());
 }
 
 
@@ -230,25 +243,8 @@ NumericVector confluenIUH_Kelly(
     double param_confluen_kel_k
 )
 {
-  double confluen_concentratTime_TS = confluen_responseTime_TS * param_confluen_kel_k;
-  double num_temp_tc2 = (confluen_concentratTime_TS * confluen_concentratTime_TS);
-  double num_temp_12_34 = 4 * confluen_responseTime_TS  / num_temp_tc2 * 
-    (1 - 2 * exp(confluen_concentratTime_TS / confluen_responseTime_TS * 0.5));
-  double num_temp_12_35 = 4 * confluen_responseTime_TS  / num_temp_tc2 * 
-    (1 - 2 * exp(confluen_concentratTime_TS / confluen_responseTime_TS * 0.5) + exp(confluen_concentratTime_TS / confluen_responseTime_TS));
-  double t_max = ceil(std::max(confluen_concentratTime_TS, - confluen_responseTime_TS * log(0.002 / num_temp_12_35)));
-  NumericVector iuh_1, iuh_2, iuh_3, iuh_, vct_iuh, temp_etK;
-  IntegerVector seq_t = seq(1, 20 * t_max);
-  NumericVector seq_t2 = as<NumericVector>(seq_t) / 20.0;
-  temp_etK = exp(- seq_t2 / confluen_responseTime_TS);
-  iuh_1 = 4 / num_temp_tc2 * (seq_t2 + confluen_responseTime_TS * (temp_etK - 1));
-  iuh_2 = num_temp_12_34 * temp_etK - 4 / num_temp_tc2 * (seq_t2 - confluen_responseTime_TS - confluen_concentratTime_TS);
-  iuh_3 = num_temp_12_35 * temp_etK;
-  iuh_ = ifelse(seq_t2 > confluen_concentratTime_TS * 0.5, iuh_2, iuh_1);
-  iuh_ = ifelse(seq_t2 > confluen_concentratTime_TS, iuh_3, iuh_);
-  NumericMatrix mat_iuh = NumericMatrix(20, t_max, iuh_.begin());
-  vct_iuh = colMeans(mat_iuh);
-  return vct_iuh / sum(vct_iuh);
+  IUH_ptr iuh_ = confluenIUH_cached(IUH_Kelly, confluen_responseTime_TS, param_confluen_kel_k);
+  return NumericVector(iuh_->begin(), iuh_->end());
 }
 
 
@@ -270,15 +266,8 @@ NumericVector confluenIUH_Nash(
     double param_confluen_nas_n
 )
 {
-  double t_max = ceil(std::max(4.0, param_confluen_nas_n) * 3 * confluen_responseTime_TS);
-  NumericVector iuh_, vct_iuh;
-  IntegerVector seq_t = seq(1, 20 * t_max);
-  NumericVector seq_t2 = as<NumericVector>(seq_t) / 20.0;
-  iuh_ = pow(seq_t2 / confluen_responseTime_TS, param_confluen_nas_n - 1) * exp(- seq_t2 / confluen_responseTime_TS) / 
-    confluen_responseTime_TS / tgamma(param_confluen_nas_n);
-  NumericMatrix mat_iuh = NumericMatrix(20, t_max, iuh_.begin());
-  vct_iuh = colMeans(mat_iuh);
-  return vct_iuh / sum(vct_iuh);
+  IUH_ptr iuh_ = confluenIUH_cached(IUH_Nash, confluen_responseTime_TS, param_confluen_nas_n);
+  return NumericVector(iuh_->begin(), iuh_->end());
 }
 
 //' @rdname confluenIUH
@@ -297,11 +286,6 @@ NumericVector confluenIUH_Clark(
     double confluen_responseTime_TS
 )
 {
-  double t_max = ceil(- confluen_responseTime_TS * log(confluen_responseTime_TS * 0.005));
-  IntegerVector seq_t = seq(1, 20 * t_max);
-  NumericVector seq_t2 = as<NumericVector>(seq_t) / 20.0;
-  NumericVector iuh_ = 1 / confluen_responseTime_TS * exp(- seq_t2 / confluen_responseTime_TS);
-  NumericMatrix mat_iuh = NumericMatrix(20, t_max, iuh_.begin());
-  NumericVector vct_iuh = colMeans(mat_iuh);
-  return vct_iuh / sum(vct_iuh);
+  IUH_ptr iuh_ = confluenIUH_cached(IUH_Clark, confluen_responseTime_TS);
+  return NumericVector(iuh_->begin(), iuh_->end());
 }
@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 //' **potential evapotranspiration**
@@ -37,8 +39,9 @@ NumericVector evatransPotential_TurcWendling(
     NumericVector param_evatrans_tur_k 
 )
 {
-  return (atmos_solarRadiat_MJ * 100 + 3.875 * 24 * param_evatrans_tur_k) * (atmos_temperature_Cel + 22) / 150 / (atmos_temperature_Cel + 123);
-  // return (atmos_solarRadiat_MJ * 100 + 3.875 * time_step_h * param_evatrans_tur_k) * (atmos_temperature_Cel + 22) / 150 / (atmos_temperature_Cel + 123);
+  NumericVector atmos_potentialEvatrans_mm(atmos_temperature_Cel.size());
+  span::evatransPotential_TurcWendling(atmos_temperature_Cel.size(), atmos_temperature_Cel.begin(), atmos_solarRadiat_MJ.begin(), param_evatrans_tur_k.begin(), atmos_potentialEvatrans_mm.begin());
+  return atmos_potentialEvatrans_mm;
 }
 
 //' @rdname evatransPotential
@@ -61,7 +64,9 @@ NumericVector evatransPotential_Linacre(
     NumericVector land_albedo_1
 )
 {
-  return ((0.75 - land_albedo_1) * 100 * (atmos_temperature_Cel + 0.006 * land_elevation_m) / (100 - land_latitude_Degree) + 3 * 100 * (1 - atmos_relativeHumidity_1)) / (80 - atmos_temperature_Cel);
+  NumericVector atmos_potentialEvatrans_mm(atmos_temperature_Cel.size());
+  span::evatransPotential_Linacre(atmos_temperature_Cel.size(), atmos_temperature_Cel.begin(), atmos_relativeHumidity_1.begin(), land_latitude_Degree.begin(), land_elevation_m.begin(), land_albedo_1.begin(), atmos_potentialEvatrans_mm.begin());
+  return atmos_potentialEvatrans_mm;
 }
 
 //' @rdname evatransPotential
@@ -88,46 +93,9 @@ NumericVector evatransPotential_FAO56(
     NumericVector land_elevation_m
 )
 {
-  NumericVector Delta_, e_s, e_a, R_n, P_, gamma_, u_2, ET_o;
-  
-  R_n = atmos_netRadiat_MJ;
-  u_2 = atmos_windSpeed2m_m_s;
-  e_a = atmos_vaporPress_hPa;
-  e_s = atmos_saturatVaporPress_hPa;
-  //// Delta_,
-  Delta_ = 4098 * (0.6108 * exp(17.27 * atmos_temperature_Cel / (atmos_temperature_Cel + 237.3))) / ((atmos_temperature_Cel + 237.3) * (atmos_temperature_Cel + 237.3)); // Eq.13
-  
-  //// e_s,
-  // e_s = 0.3054 * exp(17.27 * atmos_temperature_max_Cel / (atmos_temperature_max_Cel + 237.3)) + 0.3054 * exp(17.27 * atmos_temperature_min_Cel / (atmos_temperature_min_Cel + 237.3)); // Eq.11, 12
-  // 
-  // //// e_a,
-  // e_a = e_s * atmos_relative_humidity_Perc * 0.01; // Eq.19
-  // //// R_n,
-  // phi_ = M_PI / 180 * land_latitude_Degree; // Eq.22
-  // d_r = 1 + 0.033 * cos(2 * M_PI / 365 * time_dayOfYear_); // Eq.23
-  // delta_ = 0.409 * sin(2 * M_PI / 365 * time_dayOfYear_ - 1.39); // Eq.24
-  // omega_s = acos(-tan(phi_) * tan(delta_)); // Eq.25
-  // //// (24 (60)/M_PI) G_sc = 37.58603, G_sc <- 0.0820 MJ / (m^2 d)
-  // R_a = 37.58603 * d_r * (omega_s * sin(phi_) * sin(delta_) + cos(phi_) * cos(delta_) * sin(omega_s)); // Eq.21
-  // 
-  // R_so = (0.75 + 2e-5 * land_elevation_m) * R_a; // Eq.37
-  // R_ns = (1 - alpha_) * solar_radiation_MJ_m2d; // Eq.38
-  // R_nl = sigma_ * (pow((atmos_temperature_max_Cel + 273.16), 4) + pow((atmos_temperature_min_Cel + 273.16), 4)) / 2 * (0.34 - 0.14 * sqrt(e_a)) * (1.35 * solar_radiation_MJ_m2d / R_so - 0.35); // Eq.39
-  // R_n = R_ns - R_nl; // Eq.40
-  
-  //// G_,
-  // G_ = 0.; // Eq.42
-  
-  //// gamma_,
-  P_ = 101.3 * pow(((293 - 0.0065 * land_elevation_m) / 293), 5.26); // Eq.7
-  gamma_ = 0.665e-3 * P_; // Eq.8
-  
-  //// u_2,
-  // u_2 = wind_measure_height_m * 4.87 / (log(67.8 * wind_speed_m_s - 5.42)); // Eq.47
-  // u_2 = wind_measure_height_m
-  //// TE_o
-  ET_o = (0.408 * Delta_ * (R_n - 0.) + gamma_ * 90 * u_2 * (e_s - e_a) / (atmos_temperature_Cel + 273)) / (Delta_ + gamma_ * (1 + 0.34 * u_2));
-  return ET_o;
+  NumericVector atmos_potentialEvatrans_mm(atmos_temperature_Cel.size());
+  span::evatransPotential_FAO56(atmos_temperature_Cel.size(), atmos_temperature_Cel.begin(), atmos_vaporPress_hPa.begin(), atmos_saturatVaporPress_hPa.begin(), atmos_netRadiat_MJ.begin(), atmos_windSpeed2m_m_s.begin(), land_elevation_m.begin(), atmos_potentialEvatrans_mm.begin());
+  return atmos_potentialEvatrans_mm;
 }
 
 //' **actuall evapotranspiration**
@@ -189,11 +157,9 @@ NumericVector evatransActual_SupplyRatio(
     NumericVector param_evatrans_sur_k
 )
 {
-  NumericVector AET, k_;
-  
-  k_ = water_mm / capacity_mm * param_evatrans_sur_k;
-  AET = atmos_potentialEvatrans_mm * k_;
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_SupplyRatio(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_sur_k.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 //' @rdname evatransActual
@@ -221,11 +187,9 @@ NumericVector evatransActual_SupplyPow(
     NumericVector param_evatrans_sup_gamma
 )
 {
-  NumericVector AET, k_;
-  
-  k_ = param_evatrans_sup_k * vecpow((water_mm / capacity_mm), param_evatrans_sup_gamma);
-  AET = atmos_potentialEvatrans_mm * k_;
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_SupplyPow(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_sup_k.begin(), param_evatrans_sup_gamma.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 
@@ -251,11 +215,9 @@ NumericVector evatransActual_VIC(
     NumericVector param_evatrans_vic_gamma
 )
 {
-  NumericVector AET, k_;
-  
-  k_ = 1 - vecpow((1- water_mm / capacity_mm), param_evatrans_vic_gamma);
-  AET = atmos_potentialEvatrans_mm * k_;
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_VIC(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_vic_gamma.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 
@@ -280,12 +242,9 @@ NumericVector evatransActual_GR4J(
     NumericVector capacity_mm
 )
 {
-  NumericVector AET;
-  
-  
-  AET = water_mm * (2 - water_mm / capacity_mm) * tanh(atmos_potentialEvatrans_mm / capacity_mm) / (1 + (1 - water_mm / capacity_mm) * tanh(atmos_potentialEvatrans_mm / capacity_mm));
-  return ifelse(AET > water_mm, water_mm, AET);
-  
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_GR4J(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 //' @rdname evatransActual
@@ -310,14 +269,9 @@ NumericVector evatransActual_UBC(
     NumericVector param_evatrans_ubc_gamma
 )
 {
-  NumericVector diff_mm, AET, k_;
-  diff_mm = capacity_mm - water_mm;
-  
-  
-  
-  k_ = vecpow10(- diff_mm / (param_evatrans_ubc_gamma * capacity_mm));
-  AET = atmos_potentialEvatrans_mm * k_;
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_UBC(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_ubc_gamma.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 //' @rdname evatransActual
@@ -346,14 +300,9 @@ NumericVector evatransActual_LiangLand(
     NumericVector param_evatrans_lia_gamma
 )
 {
-  NumericVector AET, k_, f_;
-  
-  k_ = vecpow((water_mm / capacity_mm), param_evatrans_lia_gamma);
-  AET = atmos_potentialEvatrans_mm * k_;
-  f_ = water_mm / AET;
-  f_ = ifelse(f_ > 1, 1, f_);
-  AET = f_ * AET;
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_LiangLand(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_lia_gamma.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
 
@@ -382,29 +331,8 @@ NumericVector evatransActual_LiangSoil(
     NumericVector param_evatrans_lia_B
 )
 {
-  NumericVector AET, k_, f_, i_0, i_m, B_1, B_p_1, A_s, A_s_1;
-  
-  i_m = capacity_mm * (param_evatrans_lia_B + 1);
-  
-  B_p_1 = (param_evatrans_lia_B + 1);
-  B_1 = 1 / B_p_1;
-  
-  i_0 = i_m * (1 - vecpow(1 - water_mm / capacity_mm, B_1));
-  
-  // B_p_1 = (param_evatrans_lia_B + 1);
-  // B_1 = 1 / param_evatrans_lia_B;
-  // 
-  // i_0 = i_m * (1 - vecpow(1 - water_mm * B_p_1 / i_m, B_1));
-  A_s = 1 - vecpow((1 - i_0 / i_m), param_evatrans_lia_B);
-  A_s_1 = (1 - A_s);
-  
-  k_ = A_s + i_0 / i_m * A_s_1 * (1 + 
-    param_evatrans_lia_B / (1+param_evatrans_lia_B) * vecpow(A_s_1, 1 / param_evatrans_lia_B) +
-    param_evatrans_lia_B / (2+param_evatrans_lia_B) * vecpow(A_s_1, 2 / param_evatrans_lia_B) +
-    param_evatrans_lia_B / (3+param_evatrans_lia_B) * vecpow(A_s_1, 3 / param_evatrans_lia_B));
-  
-  AET = atmos_potentialEvatrans_mm * k_;
-  
-  return ifelse(AET > water_mm, water_mm, AET);
+  NumericVector evatrans_mm(atmos_potentialEvatrans_mm.size());
+  span::evatransActual_LiangSoil(atmos_potentialEvatrans_mm.size(), atmos_potentialEvatrans_mm.begin(), water_mm.begin(), capacity_mm.begin(), param_evatrans_lia_B.begin(), evatrans_mm.begin());
+  return evatrans_mm;
 }
 
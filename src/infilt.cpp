@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -55,18 +57,11 @@ NumericVector infilt_GR4J(
     NumericVector land_water_mm,
     NumericVector soil_water_mm,
     NumericVector soil_capacity_mm
-) 
+)
 {
-  NumericVector soil_diff_mm, tanh_pn_x1, s_x1, infilt_water_mm, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  tanh_pn_x1 = tanh(land_water_mm / soil_capacity_mm);
-  s_x1 = soil_water_mm / soil_capacity_mm;
-  infilt_water_mm = soil_capacity_mm * (1 - (s_x1) * (s_x1)) * tanh_pn_x1 / (1 + s_x1 * tanh_pn_x1); //// Eq.3
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_GR4J(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 //' @rdname infilt
@@ -92,15 +87,9 @@ NumericVector infilt_UBC(
     NumericVector param_infilt_ubc_P0AGEN
 )
 {
-  NumericVector soil_diff_mm, k_, infilt_water_mm, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  k_ = (1 - land_impermeableFrac_1 * vecpow10(- soil_diff_mm / (soil_capacity_mm * param_infilt_ubc_P0AGEN)));
-  infilt_water_mm = land_water_mm * k_;
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_UBC(land_water_mm.size(), land_water_mm.begin(), land_impermeableFrac_1.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_ubc_P0AGEN.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 //' @rdname infilt
@@ -125,14 +114,9 @@ NumericVector infilt_SupplyRatio(
     NumericVector param_infilt_sur_k
 )
 {
-  NumericVector soil_diff_mm, infilt_water_mm, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  infilt_water_mm = param_infilt_sur_k * land_water_mm;
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_SupplyRatio(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_sur_k.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 //' @rdname infilt
@@ -155,14 +139,9 @@ NumericVector infilt_AcceptRatio(
     NumericVector param_infilt_acr_k
 )
 {
-  NumericVector soil_diff_mm, infilt_water_mm, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  infilt_water_mm = soil_diff_mm * param_infilt_acr_k;
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_AcceptRatio(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_acr_k.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 
@@ -190,14 +169,9 @@ NumericVector infilt_SupplyPow(
     NumericVector param_infilt_sup_gamma
 )
 {
-  NumericVector soil_diff_mm, infilt_water_mm, k_, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  infilt_water_mm = param_infilt_sup_k * vecpow(ceil(land_water_mm), param_infilt_sup_gamma);
-  infilt_water_mm = ifelse(infilt_water_mm > land_water_mm, land_water_mm, infilt_water_mm);
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_SupplyPow(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_sup_k.begin(), param_infilt_sup_gamma.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 
@@ -225,14 +199,9 @@ NumericVector infilt_AcceptPow(
     NumericVector param_infilt_acp_gamma
 )
 {
-  NumericVector infilt_water_mm, k_, soil_diff_mm, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  k_ = param_infilt_acp_k * vecpow((soil_diff_mm / soil_capacity_mm), param_infilt_acp_gamma);
-  infilt_water_mm = k_ * soil_diff_mm;
-  return ifelse(infilt_water_mm > land_water_mm, land_water_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_AcceptPow(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_acp_k.begin(), param_infilt_acp_gamma.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 //' @rdname infilt
@@ -256,16 +225,9 @@ NumericVector infilt_HBV(
     NumericVector param_infilt_hbv_beta 
 )
 {
-  NumericVector soil_diff_mm, infilt_water_mm, k_, limit_mm;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm);
-  
-  k_ = (1 - vecpow(soil_water_mm / soil_capacity_mm, param_infilt_hbv_beta));
-  
-  infilt_water_mm = land_water_mm * k_;
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_HBV(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_hbv_beta.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 
@@ -295,27 +257,9 @@ NumericVector infilt_XAJ(
     NumericVector param_infilt_xaj_B
 )
 {
-  NumericVector soil_diff_mm, MM_, k_, infilt_water_mm, limit_mm, AU_, AU_L_MM, MM_AU, B_1, B_B_1, B_p_1;
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm) ;
-  
-  MM_ = soil_capacity_mm * (param_infilt_xaj_B + 1);
-  
-  B_p_1 = (param_infilt_xaj_B + 1);
-  B_B_1 = param_infilt_xaj_B / B_p_1;
-  B_1 = 1 / param_infilt_xaj_B;
-  
-  
-  AU_ = MM_ * (1 - vecpow(1 - soil_water_mm * B_p_1 / MM_, B_1));
-  
-  AU_L_MM = (MM_ - AU_ - land_water_mm) / MM_;
-  AU_L_MM = ifelse(AU_L_MM < 0, 0, AU_L_MM) ;
-  MM_AU = (MM_ - AU_) / MM_;
-  
-  infilt_water_mm = - MM_ * (vecpow(AU_L_MM, B_p_1) - vecpow(MM_AU, B_p_1)) / B_p_1;
-  
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm) ;
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_XAJ(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_xaj_B.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
 
 //' @rdname infilt
@@ -339,22 +283,7 @@ NumericVector infilt_VIC(
     NumericVector param_infilt_vic_B
 )
 {
-  NumericVector infilt_water_mm, limit_mm, soil_diff_mm, i_0, i_m, B_1, B_p_1, A_s;
-  
-  i_m = soil_capacity_mm * (param_infilt_vic_B + 1);
-  
-  B_p_1 = (param_infilt_vic_B + 1);
-  B_1 = 1 / B_p_1;
-  
-  i_0 = i_m * (1 - vecpow(1 - soil_water_mm / soil_capacity_mm, B_1));
-  
-  
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  infilt_water_mm = ifelse((i_0 + land_water_mm) > i_m, soil_diff_mm, 
-                           soil_diff_mm - soil_capacity_mm * vecpow((1 - (i_0 + land_water_mm) / i_m), B_p_1)) ;
-  // A_s = 1 - vecpow((1 - i_0 / i_m), param_infilt_vic_B);
-  // infilt_water_mm = i_0 * (1 - A_s);
-  
-  limit_mm = ifelse(soil_diff_mm > land_water_mm, land_water_mm, soil_diff_mm) ;
-  return ifelse(infilt_water_mm > limit_mm, limit_mm, infilt_water_mm);
+  NumericVector soil_infilt_mm(land_water_mm.size());
+  span::infilt_VIC(land_water_mm.size(), land_water_mm.begin(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_infilt_vic_B.begin(), soil_infilt_mm.begin());
+  return soil_infilt_mm;
 }
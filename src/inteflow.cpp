@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -58,9 +60,11 @@ NumericVector inteflow_GR4Jfix(
     NumericVector soil_capacity_mm,
     NumericVector param_inteflow_grf_k,
     NumericVector param_inteflow_grf_gamma
-) 
+)
 {
-  return soil_water_mm * (1 - vecpow((1 + vecpow(param_inteflow_grf_k * soil_water_mm / soil_capacity_mm, param_inteflow_grf_gamma)), -1.0 / param_inteflow_grf_gamma));
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_GR4Jfix(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_inteflow_grf_k.begin(), param_inteflow_grf_gamma.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 
@@ -85,11 +89,9 @@ NumericVector inteflow_MaxPow(
     NumericVector param_inteflow_map_gamma
 )
 {
-  NumericVector inteflow_;
-  
-  inteflow_ = soil_potentialInteflow_mm * vecpow(soil_water_mm / soil_capacity_mm, param_inteflow_map_gamma);
-  
-  return ifelse(inteflow_ > soil_water_mm, soil_water_mm, inteflow_) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_MaxPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialInteflow_mm.begin(), param_inteflow_map_gamma.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 //' @rdname inteflow
@@ -117,12 +119,9 @@ NumericVector inteflow_ThreshPow(
     NumericVector param_inteflow_thp_gamma
 )
 {
-  NumericVector inteflow_, inteflow_temp;
-  inteflow_temp = (soil_water_mm / soil_capacity_mm - param_inteflow_thp_thresh);
-  inteflow_temp = ifelse(inteflow_temp < 0, 0, inteflow_temp);
-  inteflow_ = soil_potentialInteflow_mm * vecpow(inteflow_temp / (1 - param_inteflow_thp_thresh), param_inteflow_thp_gamma);
-  inteflow_ = ifelse(inteflow_ > soil_potentialInteflow_mm, soil_potentialInteflow_mm, inteflow_);
-  return ifelse(inteflow_ > soil_water_mm, soil_water_mm, inteflow_) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_ThreshPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialInteflow_mm.begin(), param_inteflow_thp_thresh.begin(), param_inteflow_thp_gamma.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 
@@ -153,14 +152,9 @@ NumericVector inteflow_Arno(
     NumericVector param_inteflow_arn_k
 )
 {
-  NumericVector inteflow_, inteflow_1, inteflow_2, Ws_Wc;
-  Ws_Wc = soil_capacity_mm * param_inteflow_arn_thresh;
-  inteflow_1 = param_inteflow_arn_k * soil_potentialInteflow_mm / (soil_capacity_mm) * soil_water_mm;
-  inteflow_2 = param_inteflow_arn_k * soil_potentialInteflow_mm / (soil_capacity_mm) * soil_water_mm + soil_potentialInteflow_mm * (1 - param_inteflow_arn_k) * pow((soil_water_mm - Ws_Wc) / (soil_capacity_mm - Ws_Wc),2);
-  inteflow_ = ifelse(soil_water_mm < Ws_Wc, inteflow_1, inteflow_2);
-  inteflow_ = ifelse(soil_potentialInteflow_mm > Ws_Wc, soil_water_mm, inteflow_);
-  inteflow_ = ifelse(inteflow_ > soil_potentialInteflow_mm, soil_potentialInteflow_mm, inteflow_);
-  return ifelse(inteflow_ > soil_water_mm, soil_water_mm, inteflow_) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_Arno(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialInteflow_mm.begin(), param_inteflow_arn_thresh.begin(), param_inteflow_arn_k.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 
@@ -185,15 +179,9 @@ NumericVector inteflow_BevenWood(
     NumericVector soil_potentialInteflow_mm
 )
 {
-  NumericVector soil_inteflow_mm, soil_inteflowAvilibale_mm, soil_diff_mm, k_;
-  soil_inteflowAvilibale_mm = soil_water_mm - soil_capacity_mm * (1-soil_fieldCapacityPerc_1);
-  soil_inteflowAvilibale_mm = ifelse(soil_inteflowAvilibale_mm < 0, 0, soil_inteflowAvilibale_mm);
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < soil_water_mm, soil_water_mm, soil_diff_mm);
-  k_ = soil_water_mm / soil_diff_mm;
-  soil_inteflow_mm = k_ * soil_potentialInteflow_mm;
-  soil_inteflow_mm = ifelse(soil_water_mm > soil_inteflowAvilibale_mm, soil_inteflow_mm, 0.0);
-  return ifelse(soil_inteflow_mm > soil_inteflowAvilibale_mm, soil_inteflowAvilibale_mm, soil_inteflow_mm) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_BevenWood(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_fieldCapacityPerc_1.begin(), soil_potentialInteflow_mm.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 //' @rdname inteflow
@@ -217,11 +205,9 @@ NumericVector inteflow_SupplyPow0(
     NumericVector param_inteflow_sp0_gamma
 )
 {
-  NumericVector inteflow_;
-  
-  inteflow_ = param_inteflow_sp0_k * vecpow(ceil(soil_water_mm), param_inteflow_sp0_gamma);
-  
-  return ifelse(inteflow_ > soil_water_mm, soil_water_mm, inteflow_) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_SupplyPow0(soil_water_mm.size(), soil_water_mm.begin(), param_inteflow_sp0_k.begin(), param_inteflow_sp0_gamma.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 
@@ -247,11 +233,9 @@ NumericVector inteflow_SupplyPow(
     NumericVector param_inteflow_sup_gamma
 )
 {
-  NumericVector soil_inteflow_mm, k_;
-  
-  k_ = param_inteflow_sup_k * vecpow((soil_water_mm / soil_capacity_mm), param_inteflow_sup_gamma);
-  soil_inteflow_mm = k_ * soil_water_mm;
-  return ifelse(soil_inteflow_mm > soil_water_mm, soil_water_mm, soil_inteflow_mm) ;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_SupplyPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_inteflow_sup_k.begin(), param_inteflow_sup_gamma.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
 
 //' @rdname inteflow
@@ -272,6 +256,7 @@ NumericVector inteflow_SupplyRatio(
     NumericVector param_inteflow_sur_k
 )
 {
-  
-  return param_inteflow_sur_k * soil_water_mm;
+  NumericVector soil_interflow_mm(soil_water_mm.size());
+  span::inteflow_SupplyRatio(soil_water_mm.size(), soil_water_mm.begin(), param_inteflow_sur_k.begin(), soil_interflow_mm.begin());
+  return soil_interflow_mm;
 }
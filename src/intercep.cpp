@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -37,6 +39,7 @@ NumericVector intercep_Full(
     NumericVector land_interceptCapacity_mm
 )
 {
-  NumericVector water_diff_mm = land_interceptCapacity_mm - land_interceptWater_mm;
-  return ifelse(water_diff_mm > atmos_precipitation_mm, atmos_precipitation_mm, water_diff_mm) ;
+  NumericVector land_intercept_mm(atmos_precipitation_mm.size());
+  span::intercep_Full(atmos_precipitation_mm.size(), atmos_precipitation_mm.begin(), land_interceptWater_mm.begin(), land_interceptCapacity_mm.begin(), land_intercept_mm.begin());
+  return land_intercept_mm;
 }
@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -61,13 +63,9 @@ NumericVector lateral_SupplyPow(
     NumericVector param_lateral_sup_gamma
 )
 {
-  NumericVector ground_lateral_mm, k_;
-  NumericVector ground_diff_mm = (ground_capacity_mm - ground_water_mm);
-  
-  k_ = param_lateral_sup_k * vecpow((ground_water_mm / ground_capacity_mm), param_lateral_sup_gamma);
-  ground_lateral_mm = k_ * ground_water_mm;
-  ground_lateral_mm = ifelse(ground_lateral_mm > ground_diff_mm, ground_diff_mm, ground_lateral_mm) ;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_SupplyPow(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), param_lateral_sup_k.begin(), param_lateral_sup_gamma.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
 
 //' @rdname lateral
@@ -88,9 +86,9 @@ NumericVector lateral_SupplyRatio(
     NumericVector param_lateral_sur_k
 )
 {
-  
-  NumericVector ground_lateral_mm =  param_lateral_sur_k * ground_water_mm;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_SupplyRatio(ground_water_mm.size(), ground_water_mm.begin(), param_lateral_sur_k.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
 
 //' @rdname lateral
@@ -109,13 +107,11 @@ NumericVector lateral_GR4J(
     NumericVector ground_water_mm,
     NumericVector ground_capacity_mm,
     NumericVector ground_potentialLateral_mm
-) 
+)
 {
-  NumericVector ground_lateral_mm;
-  NumericVector ground_diff_mm = (ground_capacity_mm - ground_water_mm);
-  ground_lateral_mm = ground_potentialLateral_mm * pow((ground_water_mm / ground_capacity_mm), 3.5);
-  ground_lateral_mm = ifelse(ground_lateral_mm > ground_diff_mm, ground_diff_mm, ground_lateral_mm) ;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_GR4J(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialLateral_mm.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
 
 
@@ -138,13 +134,11 @@ NumericVector lateral_GR4Jfix(
     NumericVector ground_capacity_mm,
     NumericVector ground_potentialLateral_mm,
     NumericVector param_lateral_grf_gamma
-) 
+)
 {
-  NumericVector ground_lateral_mm;
-  NumericVector ground_diff_mm = (ground_capacity_mm - ground_water_mm);
-  ground_lateral_mm = ground_potentialLateral_mm * vecpow((ground_water_mm / ground_capacity_mm), param_lateral_grf_gamma);
-  ground_lateral_mm = ifelse(ground_lateral_mm > ground_diff_mm, ground_diff_mm, ground_lateral_mm) ;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_GR4Jfix(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialLateral_mm.begin(), param_lateral_grf_gamma.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
 
 
@@ -173,15 +167,9 @@ NumericVector lateral_ThreshPow(
     NumericVector param_lateral_thp_gamma
 )
 {
-  NumericVector ground_lateral_mm, lateral_temp;
-  NumericVector ground_diff_mm = (ground_capacity_mm - ground_water_mm);
-  lateral_temp = (ground_water_mm / ground_capacity_mm - param_lateral_thp_thresh);
-  lateral_temp = ifelse(lateral_temp < 0, 0, lateral_temp);
-  
-  ground_lateral_mm = ground_potentialLateral_mm * vecpow(lateral_temp / (1 - param_lateral_thp_thresh), param_lateral_thp_gamma);
-
-  ground_lateral_mm = ifelse(ground_lateral_mm > ground_diff_mm, ground_diff_mm, ground_lateral_mm) ;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_ThreshPow(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialLateral_mm.begin(), param_lateral_thp_thresh.begin(), param_lateral_thp_gamma.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
 
 
@@ -211,19 +199,7 @@ NumericVector lateral_Arno(
     NumericVector param_lateral_arn_k
 )
 {
-  NumericVector ground_lateral_mm, lateral_1, lateral_2, Ws_Wc;
-  NumericVector ground_diff_mm = (ground_capacity_mm - ground_water_mm);
-  Ws_Wc = ground_capacity_mm * param_lateral_arn_thresh;
-  
-  
-  lateral_1 = param_lateral_arn_k * ground_potentialLateral_mm / (ground_capacity_mm) * ground_water_mm;
-  lateral_2 = param_lateral_arn_k * ground_potentialLateral_mm / (ground_capacity_mm) * ground_water_mm + ground_potentialLateral_mm * (1 - param_lateral_arn_k) * pow((ground_water_mm - Ws_Wc) / (ground_capacity_mm - Ws_Wc),2);
-  ground_lateral_mm = ifelse(ground_water_mm < Ws_Wc, lateral_1, lateral_2);
-  ground_lateral_mm = ifelse(ground_potentialLateral_mm > Ws_Wc, ground_water_mm, ground_lateral_mm);
-  
-  ground_lateral_mm = ifelse((ground_lateral_mm < ground_potentialLateral_mm) & (ground_potentialLateral_mm < 0.), ground_potentialLateral_mm, ground_lateral_mm);
-  ground_lateral_mm = ifelse((ground_lateral_mm > ground_potentialLateral_mm) & (ground_potentialLateral_mm > 0.), ground_potentialLateral_mm, ground_lateral_mm);
-  
-  ground_lateral_mm = ifelse(ground_lateral_mm > ground_diff_mm, ground_diff_mm, ground_lateral_mm) ;
-  return ifelse(ground_lateral_mm > - ground_water_mm, ground_lateral_mm, - ground_water_mm) ;
+  NumericVector ground_lateral_mm(ground_water_mm.size());
+  span::lateral_Arno(ground_water_mm.size(), ground_water_mm.begin(), ground_capacity_mm.begin(), ground_potentialLateral_mm.begin(), param_lateral_arn_thresh.begin(), param_lateral_arn_k.begin(), ground_lateral_mm.begin());
+  return ground_lateral_mm;
 }
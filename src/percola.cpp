@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -55,9 +57,11 @@
 NumericVector percola_GR4J(
     NumericVector soil_water_mm,
     NumericVector soil_capacity_mm
-) 
+)
 {
-  return soil_water_mm * (1 - pow((1 + pow(4.0/9.0 * soil_water_mm / soil_capacity_mm, 4)), -0.25));
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_GR4J(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 //' @rdname percola
@@ -77,9 +81,11 @@ NumericVector percola_GR4Jfix(
     NumericVector soil_water_mm,
     NumericVector soil_capacity_mm,
     NumericVector param_percola_grf_k
-) 
+)
 {
-  return soil_water_mm * (1 - pow((1 + pow(param_percola_grf_k * soil_water_mm / soil_capacity_mm, 4)), -0.25));
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_GR4Jfix(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_percola_grf_k.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 
@@ -104,11 +110,9 @@ NumericVector percola_MaxPow(
     NumericVector param_percola_map_gamma
 )
 {
-  NumericVector percola_;
-  
-  percola_ = soil_potentialPercola_mm * vecpow(soil_water_mm / soil_capacity_mm, param_percola_map_gamma);
-  
-  return ifelse(percola_ > soil_water_mm, soil_water_mm, percola_) ;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_MaxPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialPercola_mm.begin(), param_percola_map_gamma.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 //' @rdname percola
@@ -136,12 +140,9 @@ NumericVector percola_ThreshPow(
     NumericVector param_percola_thp_gamma
 )
 {
-  NumericVector percola_, percola_temp;
-  percola_temp = (soil_water_mm / soil_capacity_mm - param_percola_thp_thresh);
-  percola_temp = ifelse(percola_temp < 0, 0, percola_temp);
-  percola_ = soil_potentialPercola_mm * vecpow(percola_temp / (1 - param_percola_thp_thresh), param_percola_thp_gamma);
-  percola_ = ifelse(percola_ > soil_potentialPercola_mm, soil_potentialPercola_mm, percola_);
-  return ifelse(percola_ > soil_water_mm, soil_water_mm, percola_) ;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_ThreshPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialPercola_mm.begin(), param_percola_thp_thresh.begin(), param_percola_thp_gamma.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 
@@ -172,14 +173,9 @@ NumericVector percola_Arno(
     NumericVector param_percola_arn_k
 )
 {
-  NumericVector percola_, percola_1, percola_2, Ws_Wc;
-  Ws_Wc = soil_capacity_mm * param_percola_arn_thresh;
-  percola_1 = param_percola_arn_k * soil_potentialPercola_mm / (soil_capacity_mm) * soil_water_mm;
-  percola_2 = param_percola_arn_k * soil_potentialPercola_mm / (soil_capacity_mm) * soil_water_mm + soil_potentialPercola_mm * (1 - param_percola_arn_k) * pow((soil_water_mm - Ws_Wc) / (soil_capacity_mm - Ws_Wc),2);
-  percola_ = ifelse(soil_water_mm < Ws_Wc, percola_1, percola_2);
-  percola_ = ifelse(soil_potentialPercola_mm > Ws_Wc, soil_water_mm, percola_);
-  percola_ = ifelse(percola_ > soil_potentialPercola_mm, soil_potentialPercola_mm, percola_);
-  return ifelse(percola_ > soil_water_mm, soil_water_mm, percola_) ;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_Arno(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_potentialPercola_mm.begin(), param_percola_arn_thresh.begin(), param_percola_arn_k.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 
@@ -204,15 +200,9 @@ NumericVector percola_BevenWood(
     NumericVector soil_potentialPercola_mm
 )
 {
-  NumericVector soil_percola_mm, soil_percolaAvilibale_mm, soil_diff_mm, k_;
-  soil_percolaAvilibale_mm = soil_water_mm - soil_capacity_mm * (1-soil_fieldCapacityPerc_1);
-  soil_percolaAvilibale_mm = ifelse(soil_percolaAvilibale_mm < 0, 0, soil_percolaAvilibale_mm);
-  soil_diff_mm = soil_capacity_mm - soil_water_mm;
-  soil_diff_mm = ifelse(soil_diff_mm < soil_water_mm, soil_water_mm, soil_diff_mm);
-  k_ = soil_water_mm / soil_diff_mm;
-  soil_percola_mm = k_ * soil_potentialPercola_mm;
-  soil_percola_mm = ifelse(soil_water_mm > soil_percolaAvilibale_mm, soil_percola_mm, 0.0);
-  return ifelse(soil_percola_mm > soil_percolaAvilibale_mm, soil_percolaAvilibale_mm, soil_percola_mm) ;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_BevenWood(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), soil_fieldCapacityPerc_1.begin(), soil_potentialPercola_mm.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 
@@ -239,11 +229,9 @@ NumericVector percola_SupplyPow(
     NumericVector param_percola_sup_gamma
 )
 {
-  NumericVector soil_percola_mm, k_;
-  
-  k_ = param_percola_sup_k * vecpow((soil_water_mm / soil_capacity_mm), param_percola_sup_gamma);
-  soil_percola_mm = k_ * soil_water_mm;
-  return ifelse(soil_percola_mm > soil_water_mm, soil_water_mm, soil_percola_mm) ;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_SupplyPow(soil_water_mm.size(), soil_water_mm.begin(), soil_capacity_mm.begin(), param_percola_sup_k.begin(), param_percola_sup_gamma.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
 
 //' @rdname percola
@@ -264,6 +252,7 @@ NumericVector percola_SupplyRatio(
     NumericVector param_percola_sur_k
 )
 {
-  
-  return param_percola_sur_k * soil_water_mm;
+  NumericVector soil_percolation_mm(soil_water_mm.size());
+  span::percola_SupplyRatio(soil_water_mm.size(), soil_water_mm.begin(), param_percola_sur_k.begin(), soil_percolation_mm.begin());
+  return soil_percolation_mm;
 }
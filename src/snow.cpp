@@ -1,4 +1,6 @@
 #include "00utilis.h"
+#include "../inst/include/EDCHM_span.h"
+using namespace EDCHM;
 // [[Rcpp::interfaces(r, cpp)]]
 
 
@@ -67,10 +69,9 @@ NumericVector snowMelt_Kustas(
     NumericVector param_snow_kus_fT
 )
 {
-  // NumericVector snow_melt_mm = ifelse(atmos_temperature_Cel < 0, 0, atmos_temperature_Cel) * param_snow_kus_fT * time_step_h + param_snow_kus_fE * atmos_netRadiat_MJ;
-  NumericVector snow_melt_mm = ifelse(atmos_temperature_Cel < 0, 0, atmos_temperature_Cel) * param_snow_kus_fT * 24 + param_snow_kus_fE * atmos_netRadiat_MJ;
-  return ifelse(snow_melt_mm > snow_ice_mm, snow_ice_mm, snow_melt_mm) ;
-  
+  NumericVector snow_melt_mm(snow_ice_mm.size());
+  span::snowMelt_Kustas(snow_ice_mm.size(), snow_ice_mm.begin(), atmos_temperature_Cel.begin(), atmos_netRadiat_MJ.begin(), param_snow_kus_fE.begin(), param_snow_kus_fT.begin(), snow_melt_mm.begin());
+  return snow_melt_mm;
 }
 
 //' @rdname snowMelt
@@ -96,12 +97,8 @@ NumericVector snowMelt_Factor(
     NumericVector param_snow_fac_Tmelt
 )
 {
-  NumericVector diff_T, snow_melt_mm;
-  diff_T = atmos_temperature_Cel - param_snow_fac_Tmelt;
-  diff_T = ifelse(diff_T > 0, diff_T, 0);
-  
-  snow_melt_mm = param_snow_fac_f * 24 * diff_T;
-  // snow_melt_mm = param_snow_fac_f * time_step_h * diff_T;
-  return ifelse(snow_melt_mm > snow_ice_mm, snow_ice_mm, snow_melt_mm) ;
+  NumericVector snow_melt_mm(snow_ice_mm.size());
+  span::snowMelt_Factor(snow_ice_mm.size(), snow_ice_mm.begin(), atmos_temperature_Cel.begin(), param_snow_fac_f.begin(), param_snow_fac_Tmelt.begin(), snow_melt_mm.begin());
+  return snow_melt_mm;
 }
 
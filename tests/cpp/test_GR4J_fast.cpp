@@ -0,0 +1,146 @@
+// Checks the fixed-power GR4J kernels (`fast_pow`) against the pow() forms, without R
+//
+// test_GR4J_fast draws the arguments of the fixed powers and the parameters of
+// GR4J from their ranges (X_1 100..1200, X_2 -5..3, X_3 20..300, X_4 1.1..2.9)
+// and fails when
+// - x^3.5 and x^2.5 (the UHs) are more than 3 ulp from pow(), x in (0, 2]
+// - percola, baseflow and lateral differ by more than 4 eps of their store
+// - a GR4J UH with `fast` differs by more than 8 eps
+// - the stream flow of `core::EDCHM_GR4J` (3650 steps x 40 units) with and
+//   without `fast_pow` differs by more than 1e-10 of its maximum
+// It is registered with CTest (see CMakeLists.txt).
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "EDCHM_core.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+
+static double uniform(double a, double b)
+{
+  return std::uniform_real_distribution<double>(a, b)(rng);
+}
+
+// distance in units in the last place of two positive doubles
+static int64_t ulp_diff(double a, double b)
+{
+  int64_t a_, b_;
+  std::memcpy(&a_, &a, sizeof a_);
+  std::memcpy(&b_, &b, sizeof b_);
+  return a_ > b_ ? a_ - b_ : b_ - a_;
+}
+
+static int report(const char* label, double err, double bound)
+{
+  bool fail_ = !(err <= bound);
+  std::printf("%-34s %.3g (bound %.3g): %s\n", label, err, bound, fail_ ? "FAIL" : "ok");
+  return fail_;
+}
+
+// the fixed powers themselves, in ulp
+static int test_power()
+{
+  const int n_draw = 1000000;
+  int64_t ulp_3_5 = 0, ulp_2_5 = 0;
+  for (int k = 0; k < n_draw; k++) {
+    double x = uniform(0, 2);
+    ulp_3_5 = std::max(ulp_3_5, ulp_diff(kernel::pow3_5(x), std::pow(x, 3.5)));
+    ulp_2_5 = std::max(ulp_2_5, ulp_diff(kernel::confluenIUH_GR4Jpow(x, true), kernel::confluenIUH_GR4Jpow(x, false)));
+  }
+  int n_fail = 0;
+  n_fail += report("x^3.5 max ulp", (double)ulp_3_5, 3);
+  n_fail += report("x^2.5 max ulp", (double)ulp_2_5, 3);
+  return n_fail;
+}
+
+// the kernels, in eps of the store they take water from: (1 + x^4)^-0.25 is
+// within 3 ulp (below 1, so 3 ulp <= 1.5 eps), the store times it adds one rounding
+static int test_kernel()
+{
+  const int n_draw = 1000000;
+  double err_percola = 0, err_baseflow = 0, err_lateral = 0;
+  for (int k = 0; k < n_draw; k++) {
+    double X_1 = uniform(100, 1200), X_2 = uniform(-5, 3), X_3 = uniform(20, 300);
+    double S = uniform(0, X_1), R = uniform(0, X_3);
+    double percola_ = kernel::percola_GR4Jfast(S, X_1) - kernel::percola_GR4J(S, X_1);
+    double baseflow_ = kernel::baseflow_GR4Jfast(R, X_3) - kernel::baseflow_GR4J(R, X_3);
+    double lateral_ = kernel::lateral_GR4Jfast(R, X_3, X_2) - kernel::lateral_GR4J(R, X_3, X_2);
+    if (S > 0) err_percola = std::max(err_percola, std::fabs(percola_) / S / DBL_EPSILON);
+    if (R > 0) err_baseflow = std::max(err_baseflow, std::fabs(baseflow_) / R / DBL_EPSILON);
+    err_lateral = std::max(err_lateral, std::fabs(lateral_) / std::fabs(X_2) / DBL_EPSILON);
+  }
+  int n_fail = 0;
+  n_fail += report("percola_GR4Jfast max |diff| / S", err_percola, 4);
+  n_fail += report("baseflow_GR4Jfast max |diff| / R", err_baseflow, 4);
+  n_fail += report("lateral_GR4Jfast max |diff| / X_2", err_lateral, 4);
+  return n_fail;
+}
+
+// the UHs, in eps (a UH is a difference of two S-curve values within 3 ulp)
+static int test_UH()
+{
+  double err_ = 0;
+  for (int k = 0; k < 10000; k++) {
+    double X_4 = uniform(1.1, 2.9);
+    std::vector<double> UH_1 = kernel::confluenIUH_GR4J1(X_4, true), UH_1pow = kernel::confluenIUH_GR4J1(X_4, false);
+    std::vector<double> UH_2 = kernel::confluenIUH_GR4J2(X_4, true), UH_2pow = kernel::confluenIUH_GR4J2(X_4, false);
+    if (UH_1.size() != UH_1pow.size() || UH_2.size() != UH_2pow.size()) return report("UH length", 1, 0);
+    for (size_t i = 0; i < UH_1.size(); i++) err_ = std::max(err_, std::fabs(UH_1[i] - UH_1pow[i]) / DBL_EPSILON);
+    for (size_t i = 0; i < UH_2.size(); i++) err_ = std::max(err_, std::fabs(UH_2[i] - UH_2pow[i]) / DBL_EPSILON);
+  }
+  return report("UH max |diff| / eps", err_, 8);
+}
+
+// the model, random daily forcing and parameters, one unit per parameter set
+static int test_modell()
+{
+  const int n_time = 3650, n_spat = 40;
+  std::size_t n_cell = (std::size_t)n_time * n_spat;
+  std::vector<double> E(n_cell), P(n_cell);
+  for (std::size_t i = 0; i < n_cell; i++) {
+    E[i] = uniform(0, 6);
+    P[i] = uniform(0, 1) < 0.6 ? 0 : uniform(0, 40);
+  }
+  std::vector<double> S_(n_spat), R_(n_spat), X_1(n_spat), X_2(n_spat), X_3(n_spat), X_4(n_spat);
+  for (int j = 0; j < n_spat; j++) {
+    X_1[j] = uniform(100, 1200);
+    X_2[j] = uniform(-5, 3);
+    X_3[j] = uniform(20, 300);
+    X_4[j] = uniform(1.1, 2.9);
+    S_[j] = uniform(0, 1) * X_1[j];
+    R_[j] = uniform(0, 1) * X_3[j];
+  }
+
+  enum { OUT_Q = 9 };
+  std::vector<double> Q_fast(n_cell), Q_pow(n_cell);
+  std::vector<double*> out_fast(core::EDCHM_GR4J_output.size(), nullptr), out_pow(core::EDCHM_GR4J_output.size(), nullptr);
+  out_fast[OUT_Q] = Q_fast.data();
+  out_pow[OUT_Q] = Q_pow.data();
+  core::EDCHM_GR4J(n_time, n_spat, view<const double>(E), view<const double>(P), view<const double>(S_), view<const double>(R_),
+                   view<const double>(X_1), view<const double>(X_2), view<const double>(X_3), view<const double>(X_4), 2, out_fast, true);
+  core::EDCHM_GR4J(n_time, n_spat, view<const double>(E), view<const double>(P), view<const double>(S_), view<const double>(R_),
+                   view<const double>(X_1), view<const double>(X_2), view<const double>(X_3), view<const double>(X_4), 2, out_pow, false);
+
+  double max_ = 0, diff_ = 0;
+  for (std::size_t i = 0; i < n_cell; i++) {
+    max_ = std::max(max_, std::fabs(Q_pow[i]));
+    diff_ = std::max(diff_, std::fabs(Q_fast[i] - Q_pow[i]));
+  }
+  return report("stream flow max |diff| / max", diff_ / max_, 1e-10);
+}
+
+int main()
+{
+  int n_fail = 0;
+  n_fail += test_power();
+  n_fail += test_kernel();
+  n_fail += test_UH();
+  n_fail += test_modell();
+  return n_fail ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+// Checks the recursive (IIR) Clark and Nash routing against the integrated IUH, without R
+//
+// test_confluen_IIR compares `kernel::confluen_IIR_Clark()` and
+// `kernel::confluen_IIR_Nash()` with the gamma IUH of n reservoirs with storage
+// constant t_r, integrated over every time step:
+// u[k] = Q(k) - Q(k + 1), Q(t) = sum_{m < n} e^{-t / t_r} (t / t_r)^m / m!
+// (computed in long double), and fails when
+// - the response to one unit of input differs from u by more than 1e-14
+// - the routing of random runoff differs from the convolution with u by more
+//   than 1e-13 of its maximum
+// - a non-whole `param_confluen_nas_n` is not rounded to the nearest number
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "EDCHM_confluen.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+
+// the step volumes of the gamma IUH, until the rest is below 1e-30
+static std::vector<double> iuh_integrated(double confluen_responseTime_TS, int n_reservoir, int n_max)
+{
+  auto Q = [&](long double t_) {
+    long double x_ = t_ / confluen_responseTime_TS, term_ = std::exp(- x_), sum_ = 0;
+    for (int m = 0; m < n_reservoir; m++) {
+      sum_ += term_;
+      term_ *= x_ / (m + 1);
+    }
+    return sum_;
+  };
+  std::vector<double> iuh_;
+  for (int k = 0; k < n_max; k++) {
+    long double Q_k = Q(k), Q_k1 = Q(k + 1);
+    iuh_.push_back((double)(Q_k - Q_k1));
+    if (Q_k1 < 1e-30L) break;
+  }
+  return iuh_;
+}
+
+// the number of failed checks of one response time and number of reservoirs
+static int test_case(double confluen_responseTime_TS, double param_confluen_nas_n)
+{
+  const int n_time = 5000;
+  int n_reservoir = (int)std::floor(param_confluen_nas_n + 0.5);
+  std::vector<double> iuh_ = iuh_integrated(confluen_responseTime_TS, n_reservoir, n_time);
+  int n_iuh = iuh_.size();
+
+  auto route = [&](const std::vector<double>& in_, std::vector<double>& out_) {
+    if (param_confluen_nas_n == 1) {
+      kernel::confluen_IIR_Clark(n_time, in_.data(), confluen_responseTime_TS, out_.data());
+    } else {
+      kernel::confluen_IIR_Nash(n_time, in_.data(), confluen_responseTime_TS, param_confluen_nas_n, out_.data());
+    }
+  };
+
+  // impulse response
+  std::vector<double> impulse_(n_time, 0.0), response_(n_time);
+  impulse_[0] = 1;
+  route(impulse_, response_);
+  double err_impulse = 0;
+  for (int k = 0; k < n_time; k++) err_impulse = std::max(err_impulse, std::fabs(response_[k] - (k < n_iuh ? iuh_[k] : 0.0)));
+
+  // random runoff
+  std::uniform_real_distribution<double> u_(0, 1), rain_(0, 30);
+  std::vector<double> in_(n_time), out_(n_time);
+  for (double& x : in_) x = u_(rng) < 0.6 ? 0 : rain_(rng);
+  route(in_, out_);
+  double max_ = 0, diff_ = 0;
+  for (int i = 0; i < n_time; i++) {
+    double conv_ = kernel::confluen_IUH_step(i, in_.data(), n_iuh, iuh_.data());
+    max_ = std::max(max_, std::fabs(conv_));
+    diff_ = std::max(diff_, std::fabs(out_[i] - conv_));
+  }
+
+  int n_fail = 0;
+  n_fail += !(err_impulse <= 1e-14);
+  n_fail += !(diff_ <= 1e-13 * max_);
+  std::printf("%-5s t_r %5.1f, n %3.1f: impulse max|diff| %.2e, runoff max|diff|/max %.2e: %s\n",
+              param_confluen_nas_n == 1 ? "Clark" : "Nash", confluen_responseTime_TS, param_confluen_nas_n,
+              err_impulse, diff_ / max_, n_fail ? "FAIL" : "ok");
+  return n_fail;
+}
+
+int main()
+{
+  int n_fail = 0;
+  n_fail += test_case(0.3, 1);
+  n_fail += test_case(2.5, 1);
+  n_fail += test_case(40, 1);
+  n_fail += test_case(0.7, 2);
+  n_fail += test_case(3, 3);
+  n_fail += test_case(12, 6);
+  n_fail += test_case(30, 4);
+  // rounded to 3 reservoirs
+  n_fail += test_case(5, 2.6);
+  int n_round = kernel::confluenIIR_NashN(2.6) != 3 || kernel::confluenIIR_NashN(0.2) != 1;
+  std::printf("confluenIIR_NashN rounds: %s\n", n_round ? "FAIL" : "ok");
+  n_fail += n_round;
+  return n_fail ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// Checks the FFT routing against the direct convolution sum, without R
+//
+// test_confluen_fft routes random runoff (40 % of the steps wet) with
+// `kernel::confluen_IUH()` and fails when
+// - an IUH shorter than `confluen_FFT_minIUH` does not give the direct sum
+//   (`confluen_IUH_step()`) bit for bit
+// - a longer one (FFT) differs from the direct sum by more than 1e-13 of its
+//   maximum, for IUHs from 64 to 1440 steps and series shorter and longer than them
+// - the output is written past n_time
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "EDCHM_confluen.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+
+static std::vector<double> runoff(int n)
+{
+  std::uniform_real_distribution<double> u_(0, 1), rain_(0, 30);
+  std::vector<double> x_(n);
+  for (double& x : x_) x = u_(rng) < 0.6 ? 0 : rain_(rng);
+  return x_;
+}
+
+// a smooth IUH with a long tail, normalised to a sum of 1
+static std::vector<double> iuh(int n_iuh)
+{
+  std::vector<double> iuh_(n_iuh);
+  double sum_ = 0;
+  for (int k = 0; k < n_iuh; k++) {
+    double t_ = (k + 0.5) / n_iuh * 6;
+    iuh_[k] = t_ * t_ * std::exp(- t_);
+    sum_ += iuh_[k];
+  }
+  for (double& u : iuh_) u /= sum_;
+  return iuh_;
+}
+
+// the number of failed checks of one IUH and series length
+static int test_case(int n_iuh, int n_time)
+{
+  std::vector<double> in_ = runoff(n_time), iuh_ = iuh(n_iuh);
+  int n_iuhRouted = std::min(n_iuh, n_time);
+  std::vector<double> direct_(n_time);
+  for (int i = 0; i < n_time; i++) direct_[i] = kernel::confluen_IUH_step(i, in_.data(), n_iuhRouted, iuh_.data());
+
+  // one guard value behind the output
+  const double guard_ = -12345.0;
+  std::vector<double> out_(n_time + 1, guard_);
+  kernel::confluen_IUH(n_time, in_.data(), n_iuh, iuh_.data(), out_.data());
+
+  double max_ = 0, diff_ = 0;
+  for (int i = 0; i < n_time; i++) {
+    max_ = std::max(max_, std::fabs(direct_[i]));
+    diff_ = std::max(diff_, std::fabs(out_[i] - direct_[i]));
+  }
+  bool fft_ = n_iuhRouted >= kernel::confluen_FFT_minIUH;
+  bool same_ = std::memcmp(out_.data(), direct_.data(), n_time * sizeof(double)) == 0;
+  int n_fail = 0;
+  n_fail += fft_ ? !(diff_ <= 1e-13 * max_) : !same_;
+  n_fail += out_[n_time] != guard_;
+  std::printf("IUH %5d, n_time %6d, %-6s max|diff|/max %.2e, bitwise %d: %s\n",
+              n_iuh, n_time, fft_ ? "FFT" : "direct", max_ > 0 ? diff_ / max_ : 0.0, same_, n_fail ? "FAIL" : "ok");
+  return n_fail;
+}
+
+int main()
+{
+  int n_fail = 0;
+  n_fail += test_case(8, 1000);
+  n_fail += test_case(63, 1000);
+  n_fail += test_case(64, 1000);
+  n_fail += test_case(100, 5000);
+  n_fail += test_case(333, 20000);
+  n_fail += test_case(1440, 87600);
+  // the IUH is longer than the series
+  n_fail += test_case(500, 70);
+  n_fail += test_case(1440, 1000);
+  return n_fail ? 1 : 0;
+}
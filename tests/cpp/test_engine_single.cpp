@@ -0,0 +1,133 @@
+// Checks the single-precision engine against the double one, without R
+//
+// test_engine_single runs the mini, snow and GR4J structures of `core::engine`
+// on random forcing and parameters (3000 steps x 30 units), once in double and
+// once with `single`, and fails when
+// - the stream flow differs by more than 2e-6 of its maximum
+// - the outlet volume differs by more than 1e-7 (relative)
+// - a single run with `check` or with the cache (filled and replayed) is not
+//   bitwise the plain single run
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "EDCHM_engine.h"
+
+using namespace EDCHM;
+
+static const int n_time = 3000, n_spat = 30;
+static std::mt19937 rng(42);
+
+static std::vector<double> uniform(std::size_t n, double a, double b)
+{
+  std::uniform_real_distribution<double> u_(a, b);
+  std::vector<double> x_(n);
+  for (double& x : x_) x = u_(rng);
+  return x_;
+}
+
+// rain on 40 % of the steps
+static std::vector<double> precipitation(std::size_t n)
+{
+  std::uniform_real_distribution<double> u_(0, 1), rain_(0, 40);
+  std::vector<double> x_(n);
+  for (double& x : x_) x = u_(rng) < 0.6 ? 0 : rain_(rng);
+  return x_;
+}
+
+static std::size_t n_cell = (std::size_t)n_time * n_spat;
+static std::map<std::string, std::vector<double>> boundary_value = {
+  {"atmos_precipitation_mm", precipitation(n_cell)},
+  {"atmos_potentialEvatrans_mm", uniform(n_cell, 0, 6)},
+  {"atmos_temperature_Cel", uniform(n_cell, -10, 20)},
+  {"atmos_snow_mm", uniform(n_cell, 0, 3)}
+};
+static std::map<std::string, std::vector<double>> param_value = {
+  {"ground_water_mm", uniform(n_spat, 0, 50)}, {"soil_water_mm", uniform(n_spat, 0, 50)}, {"snow_ice_mm", uniform(n_spat, 0, 50)},
+  {"ground_capacity_mm", uniform(n_spat, 100, 300)}, {"land_impermeableFrac_1", uniform(n_spat, 0, 0.3)},
+  {"param_baseflow_grf_gamma", uniform(n_spat, 1, 6)}, {"param_evatrans_ubc_gamma", uniform(n_spat, 0.5, 3)},
+  {"param_infilt_ubc_P0AGEN", uniform(n_spat, 0.5, 4)}, {"param_percola_arn_k", uniform(n_spat, 0, 1)},
+  {"param_percola_arn_thresh", uniform(n_spat, 0.1, 0.9)}, {"soil_capacity_mm", uniform(n_spat, 100, 400)},
+  {"soil_potentialPercola_mm", uniform(n_spat, 1, 20)}, {"confluenLand_responseTime_TS", uniform(n_spat, 1, 8)},
+  {"param_confluenLand_kel_k", uniform(n_spat, 1, 4)}, {"confluenGround_responseTime_TS", uniform(n_spat, 1, 12)},
+  {"param_atmos_thr_Ts", uniform(n_spat, -1, 2)}, {"param_snow_fac_f", uniform(n_spat, 0.05, 0.4)},
+  {"param_snow_fac_Tmelt", uniform(n_spat, -1, 2)}, {"ground_potentialLateral_mm", uniform(n_spat, -2, 2)}
+};
+
+static bool same(const std::vector<double>& a, const std::vector<double>& b)
+{
+  return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+// the number of failed checks of one structure
+static int test_structure(
+    const char* label,
+    const std::vector<std::string>& process,
+    const std::vector<std::string>& method
+)
+{
+  core::engine engine_double(process, method), engine_single(process, method, true);
+  std::vector<view<const double>> boundary_, param_;
+  for (const std::string& name : engine_double.boundary_name()) boundary_.push_back(view<const double>(boundary_value[name]));
+  for (const std::string& name : engine_double.param_name()) param_.push_back(view<const double>(param_value[name]));
+  std::vector<double> weight_(n_spat, 1.0 / n_spat);
+
+  enum { OUT_streamflow = 5 };
+  std::vector<double> streamflow_double(n_cell), streamflow_single(n_cell);
+  std::vector<double*> out_double(core::engine_output.size(), nullptr), out_single(core::engine_output.size(), nullptr);
+  out_double[OUT_streamflow] = streamflow_double.data();
+  out_single[OUT_streamflow] = streamflow_single.data();
+  std::vector<double> outlet_double(n_time), outlet_single(n_time);
+  engine_double.run(n_time, n_spat, boundary_, param_, 2, out_double, outlet_double.data(), view<const double>(weight_));
+  engine_single.run(n_time, n_spat, boundary_, param_, 2, out_single, outlet_single.data(), view<const double>(weight_));
+
+  double max_ = 0, diff_ = 0;
+  for (std::size_t i = 0; i < n_cell; i++) {
+    max_ = std::max(max_, std::fabs(streamflow_double[i]));
+    diff_ = std::max(diff_, std::fabs(streamflow_double[i] - streamflow_single[i]));
+  }
+  double volume_double = 0, volume_single = 0;
+  for (int i = 0; i < n_time; i++) {
+    volume_double += outlet_double[i];
+    volume_single += outlet_single[i];
+  }
+  double streamflow_err = diff_ / max_, volume_err = std::fabs(volume_single - volume_double) / volume_double;
+
+  // a check that never stops, the cache filled and then replayed
+  std::vector<double*> none_(core::engine_output.size(), nullptr);
+  std::vector<double> outlet_check(n_time), outlet_fill(n_time), outlet_replay(n_time);
+  core::engine_cache cache_;
+  engine_single.run(n_time, n_spat, boundary_, param_, 3, none_, outlet_check.data(), view<const double>(weight_), core::engine_check([](int) { return true; }));
+  engine_single.run(n_time, n_spat, boundary_, param_, 1, none_, outlet_fill.data(), view<const double>(weight_), core::engine_check(), &cache_);
+  engine_single.run(n_time, n_spat, boundary_, param_, 1, none_, outlet_replay.data(), view<const double>(weight_), core::engine_check(), &cache_);
+
+  int n_fail = 0;
+  n_fail += streamflow_err > 2e-6;
+  n_fail += volume_err > 1e-7;
+  n_fail += !same(outlet_single, outlet_check);
+  n_fail += !same(outlet_single, outlet_fill);
+  n_fail += !same(outlet_single, outlet_replay) || cache_.n_hit() == 0;
+  std::printf("%-5s stream flow max|diff|/max %.2e, outlet volume %.2e, check %d, cache fill %d, replay %d (hit %ld): %s\n",
+              label, streamflow_err, volume_err, same(outlet_single, outlet_check), same(outlet_single, outlet_fill),
+              same(outlet_single, outlet_replay), cache_.n_hit(), n_fail ? "FAIL" : "ok");
+  return n_fail;
+}
+
+int main()
+{
+  int n_fail = 0;
+  n_fail += test_structure("mini",
+    {"evatransSoil", "infilt", "percola", "baseflow", "confluenLand", "confluenGround"},
+    {"evatransActual_UBC", "infilt_UBC", "percola_Arno", "baseflow_GR4Jfix", "confluenIUH_Kelly", "confluenIUH_GR4J1"});
+  n_fail += test_structure("snow",
+    {"atmosSnow", "snowMelt", "evatransSoil", "infilt", "percola", "baseflow", "confluenLand", "confluenGround"},
+    {"atmosSnow_ThresholdT", "snowMelt_Factor", "evatransActual_UBC", "infilt_UBC", "percola_Arno", "baseflow_GR4Jfix", "confluenIUH_Kelly", "confluenIUH_GR4J1"});
+  n_fail += test_structure("GR4J",
+    {"evatransSoil", "infilt", "percola", "baseflow", "lateral", "confluenLand", "confluenGround"},
+    {"evatransActual_GR4J", "infilt_GR4J", "percola_GR4J", "baseflow_GR4J", "lateral_GR4J", "confluenIUH_GR4J1", "confluenIUH_GR4J2"});
+  return n_fail ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// Checks the ensembles against the models run alone, without R
+//
+// test_ensemble runs 150 random members (two full blocks of `ensemble_lane`
+// and a part one) of `core::EDCHM_GR4J_ensemble()` and
+// `core::EDCHM_mini_ensemble()` on 2000 random daily steps, and fails when
+// - in the strict math mode the stream flow of a member is not bitwise the one
+//   of `core::EDCHM_GR4J()` / `core::EDCHM_mini()` with one spatial unit, for
+//   1 and 2 threads
+// - the NSE summed while the members run is not bitwise the one of that series
+// - in the fast math mode the stream flow differs from the strict one by more
+//   than 1e-12 of its maximum
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "EDCHM_ensemble.h"
+#include "EDCHM_vecmath.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+static const int n_time = 2000, n_member = 150;
+
+static double uniform(double a, double b)
+{
+  return std::uniform_real_distribution<double>(a, b)(rng);
+}
+
+// the stream flow of member m run alone
+typedef void (*modell_single)(const std::vector<double>&, const std::vector<double>&, const std::vector<std::vector<double>>&, int, double*);
+
+typedef void (*modell_ensemble)(int, int, view<const double>, view<const double>, const std::vector<view<const double>>&,
+                                int, double*, view<const double>, objective::gof_sum*);
+
+static void single_GR4J(const std::vector<double>& E, const std::vector<double>& P, const std::vector<std::vector<double>>& param, int m, double* Q_)
+{
+  std::vector<double*> out_GR4J(core::EDCHM_GR4J_output.size(), nullptr);
+  out_GR4J.back() = Q_;
+  std::vector<view<const double>> v_;
+  for (const std::vector<double>& p : param) v_.push_back(view<const double>(&p[m], 1));
+  core::EDCHM_GR4J(n_time, 1, view<const double>(E), view<const double>(P), v_[0], v_[1], v_[2], v_[3], v_[4], v_[5], 1, out_GR4J, true);
+}
+
+static void single_mini(const std::vector<double>& E, const std::vector<double>& P, const std::vector<std::vector<double>>& param, int m, double* Q_)
+{
+  std::vector<double*> out_mini(core::EDCHM_mini_output.size(), nullptr);
+  out_mini.back() = Q_;
+  std::vector<view<const double>> v_;
+  for (const std::vector<double>& p : param) v_.push_back(view<const double>(&p[m], 1));
+  core::EDCHM_mini(n_time, 1, view<const double>(E), view<const double>(P), v_[0], v_[1], v_[2], v_[3], v_[4], v_[5], v_[6],
+                   v_[7], v_[8], v_[9], v_[10], v_[11], v_[12], v_[13], 1, out_mini);
+}
+
+// the number of failed checks of one model
+static int test_modell(
+    const char* label,
+    modell_ensemble modell_ens,
+    modell_single modell_,
+    const std::vector<std::vector<double>>& param,
+    const std::vector<double>& E,
+    const std::vector<double>& P,
+    const std::vector<double>& observe
+)
+{
+  int n_fail = 0;
+  std::vector<view<const double>> param_view;
+  for (const std::vector<double>& p : param) param_view.push_back(view<const double>(p));
+  std::vector<double> Q_single((std::size_t)n_time * n_member);
+  for (int m = 0; m < n_member; m++) modell_(E, P, param, m, Q_single.data() + (std::size_t)m * n_time);
+
+  vecmath::set_mode(vecmath::strict);
+  std::vector<double> Q_ens((std::size_t)n_time * n_member);
+  for (int n_thread : {1, 2}) {
+    modell_ens(n_time, n_member, view<const double>(E), view<const double>(P), param_view, n_thread, Q_ens.data(), view<const double>(), nullptr);
+    bool same_ = std::memcmp(Q_ens.data(), Q_single.data(), Q_single.size() * sizeof(double)) == 0;
+    std::printf("%-5s strict, %d threads, stream flow bitwise: %s\n", label, n_thread, same_ ? "ok" : "FAIL");
+    n_fail += !same_;
+  }
+
+  std::vector<objective::gof_sum> gof_(n_member);
+  modell_ens(n_time, n_member, view<const double>(E), view<const double>(P), param_view, 1, nullptr, view<const double>(observe), gof_.data());
+  bool same_gof = true;
+  for (int m = 0; m < n_member; m++) {
+    objective::gof_sum gof_single;
+    for (int i = 0; i < n_time; i++) gof_single.add(Q_single[(std::size_t)m * n_time + i], observe[i]);
+    double NSE_ens = gof_[m].NSE(), NSE_single = gof_single.NSE();
+    same_gof = same_gof && std::memcmp(&NSE_ens, &NSE_single, sizeof(double)) == 0;
+  }
+  std::printf("%-5s strict, NSE bitwise: %s\n", label, same_gof ? "ok" : "FAIL");
+  n_fail += !same_gof;
+
+  vecmath::set_mode(vecmath::fast);
+  bool vec_on = vecmath::vec_on();
+  modell_ens(n_time, n_member, view<const double>(E), view<const double>(P), param_view, 1, Q_ens.data(), view<const double>(), nullptr);
+  vecmath::set_mode(vecmath::strict);
+  double max_ = 0, diff_ = 0;
+  for (std::size_t k = 0; k < Q_single.size(); k++) {
+    max_ = std::max(max_, std::fabs(Q_single[k]));
+    diff_ = std::max(diff_, std::fabs(Q_ens[k] - Q_single[k]));
+  }
+  bool fail_fast = !(diff_ <= 1e-12 * max_);
+  std::printf("%-5s fast (vector lanes %d), max|diff|/max %.2e: %s\n", label, vec_on, diff_ / max_, fail_fast ? "FAIL" : "ok");
+  n_fail += fail_fast;
+  return n_fail;
+}
+
+int main()
+{
+  std::vector<double> E(n_time), P(n_time), observe(n_time);
+  for (int i = 0; i < n_time; i++) {
+    E[i] = uniform(0, 6);
+    P[i] = uniform(0, 1) < 0.6 ? 0 : uniform(0, 40);
+    observe[i] = uniform(0, 8);
+  }
+  int n_fail = 0;
+
+  // in the order of `EDCHM_GR4J_ensembleParam`
+  std::vector<std::vector<double>> param_GR4J(6, std::vector<double>(n_member));
+  for (int m = 0; m < n_member; m++) {
+    param_GR4J[2][m] = uniform(100, 1200);
+    param_GR4J[3][m] = uniform(-5, 3);
+    param_GR4J[4][m] = uniform(20, 300);
+    param_GR4J[5][m] = uniform(1.1, 2.9);
+    param_GR4J[0][m] = uniform(0, 1) * param_GR4J[2][m];
+    param_GR4J[1][m] = uniform(0, 1) * param_GR4J[4][m];
+  }
+  n_fail += test_modell("GR4J", core::EDCHM_GR4J_ensemble, single_GR4J, param_GR4J, E, P, observe);
+
+  // in the order of `EDCHM_mini_ensembleParam`
+  const double range_mini[14][2] = {{50, 300}, {0, 50}, {0, 0.5}, {100, 500}, {1, 20}, {0, 100}, {1.5, 10},
+                                    {1.5, 20}, {2, 7}, {1, 4}, {0.5, 2}, {0.1, 4}, {0.1, 1}, {0.1, 0.9}};
+  std::vector<std::vector<double>> param_mini(14, std::vector<double>(n_member));
+  for (int m = 0; m < n_member; m++) {
+    for (int k = 0; k < 14; k++) param_mini[k][m] = uniform(range_mini[k][0], range_mini[k][1]);
+  }
+  n_fail += test_modell("mini", core::EDCHM_mini_ensemble, single_mini, param_mini, E, P, observe);
+  return n_fail ? 1 : 0;
+}
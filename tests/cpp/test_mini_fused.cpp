@@ -0,0 +1,140 @@
+// Checks the fused per-cell EDCHM_mini against the vector composition, without R
+//
+// test_mini_fused runs `core::EDCHM_mini()` (one `compose::cell` per unit, the
+// routing streamed in the time loop or by FFT) and the composition of the former
+// Rcpp model: every process over all units per time step with the span kernels
+// of EDCHM_span.h (strict math), the capacity overflow of the ground added to
+// the baseflow, and `confluen_IUH2S()` per unit after the time loop. It fails when
+// - any of the six outputs differs in a bit, for 2 and 3 threads; every fifth
+//   unit has IUHs of `confluen_FFT_minIUH` steps or more, which both route by FFT
+// Forcing, parameters and initial states are random, 2000 daily steps x 50 units.
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "EDCHM_core.h"
+#include "EDCHM_span.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+static const int n_time = 2000, n_spat = 50;
+
+static double uniform(double a, double b)
+{
+  return std::uniform_real_distribution<double>(a, b)(rng);
+}
+
+// the parameters in the order of the arguments of `core::EDCHM_mini()`
+struct param_mini {
+  std::vector<double> ground_capacity_mm, ground_water_mm, land_impermeableFrac_1, soil_capacity_mm, soil_potentialPercola_mm, soil_water_mm,
+    confluenLand_responseTime_TS, confluenGround_responseTime_TS, param_baseflow_grf_gamma, param_confluenLand_kel_k,
+    param_evatrans_ubc_gamma, param_infilt_ubc_P0AGEN, param_percola_arn_k, param_percola_arn_thresh;
+};
+
+// the output matrices, in the order of `EDCHM_mini_output`
+typedef std::vector<std::vector<double>> output_mini;
+
+// the composition of the former model, the time loop over the processes of all units
+static output_mini modell_vector(const std::vector<double>& E, const std::vector<double>& P, const param_mini& p)
+{
+  output_mini out_(6, std::vector<double>((std::size_t)n_time * n_spat));
+  std::vector<double> soil_water_mm(p.soil_water_mm), ground_water_mm(p.ground_water_mm);
+  std::vector<double> PET_(n_spat), land_water_mm(n_spat), soil_evatrans_mm(n_spat), soil_infilt_mm(n_spat), soil_percolation_mm(n_spat), ground_baseflow_mm(n_spat);
+  std::vector<double> land_runoff((std::size_t)n_time * n_spat), ground_baseflow((std::size_t)n_time * n_spat);
+  for (int i = 0; i < n_time; i++) {
+    for (int j = 0; j < n_spat; j++) {
+      PET_[j] = E[(std::size_t)j * n_time + i];
+      land_water_mm[j] = P[(std::size_t)j * n_time + i];
+    }
+    span::evatransActual_UBC(n_spat, PET_.data(), soil_water_mm.data(), p.soil_capacity_mm.data(), p.param_evatrans_ubc_gamma.data(), soil_evatrans_mm.data());
+    for (int j = 0; j < n_spat; j++) soil_water_mm[j] += - soil_evatrans_mm[j];
+    span::infilt_UBC(n_spat, land_water_mm.data(), p.land_impermeableFrac_1.data(), soil_water_mm.data(), p.soil_capacity_mm.data(), p.param_infilt_ubc_P0AGEN.data(), soil_infilt_mm.data());
+    for (int j = 0; j < n_spat; j++) soil_water_mm[j] += soil_infilt_mm[j];
+    span::percola_Arno(n_spat, soil_water_mm.data(), p.soil_capacity_mm.data(), p.soil_potentialPercola_mm.data(), p.param_percola_arn_thresh.data(), p.param_percola_arn_k.data(), soil_percolation_mm.data());
+    std::vector<double> baseflow_temp(n_spat);
+    for (int j = 0; j < n_spat; j++) {
+      ground_water_mm[j] += soil_percolation_mm[j];
+      soil_water_mm[j] += - soil_percolation_mm[j];
+      baseflow_temp[j] = ground_water_mm[j] < p.ground_capacity_mm[j] ? 0 : ground_water_mm[j] - p.ground_capacity_mm[j];
+      ground_water_mm[j] = ground_water_mm[j] < p.ground_capacity_mm[j] ? ground_water_mm[j] : p.ground_capacity_mm[j];
+    }
+    span::baseflow_GR4Jfix(n_spat, ground_water_mm.data(), p.ground_capacity_mm.data(), p.param_baseflow_grf_gamma.data(), ground_baseflow_mm.data());
+    for (int j = 0; j < n_spat; j++) {
+      ground_water_mm[j] += - ground_baseflow_mm[j];
+      std::size_t ij = (std::size_t)j * n_time + i;
+      land_runoff[ij] = land_water_mm[j] - soil_infilt_mm[j];
+      ground_baseflow[ij] = ground_baseflow_mm[j] + baseflow_temp[j];
+      out_[0][ij] = soil_evatrans_mm[j];
+      out_[1][ij] = soil_water_mm[j];
+      out_[2][ij] = ground_water_mm[j];
+      out_[3][ij] = land_runoff[ij];
+      out_[4][ij] = ground_baseflow[ij];
+    }
+  }
+  for (int j = 0; j < n_spat; j++) {
+    std::vector<double> iuh_land = kernel::confluenIUH_Kelly(p.confluenLand_responseTime_TS[j], p.param_confluenLand_kel_k[j]);
+    std::vector<double> iuh_ground = kernel::confluenIUH_GR4J1(p.confluenGround_responseTime_TS[j]);
+    std::size_t j0 = (std::size_t)j * n_time;
+    kernel::confluen_IUH2S(n_time, land_runoff.data() + j0, ground_baseflow.data() + j0, iuh_land.size(), iuh_land.data(),
+                           iuh_ground.size(), iuh_ground.data(), out_[5].data() + j0);
+  }
+  return out_;
+}
+
+static output_mini modell_fused(const std::vector<double>& E, const std::vector<double>& P, const param_mini& p, int n_thread)
+{
+  output_mini out_(6, std::vector<double>((std::size_t)n_time * n_spat));
+  std::vector<double*> out_ptr;
+  for (std::vector<double>& o : out_) out_ptr.push_back(o.data());
+  core::EDCHM_mini(n_time, n_spat, view<const double>(E), view<const double>(P),
+                   view<const double>(p.ground_capacity_mm), view<const double>(p.ground_water_mm), view<const double>(p.land_impermeableFrac_1),
+                   view<const double>(p.soil_capacity_mm), view<const double>(p.soil_potentialPercola_mm), view<const double>(p.soil_water_mm),
+                   view<const double>(p.confluenLand_responseTime_TS), view<const double>(p.confluenGround_responseTime_TS),
+                   view<const double>(p.param_baseflow_grf_gamma), view<const double>(p.param_confluenLand_kel_k),
+                   view<const double>(p.param_evatrans_ubc_gamma), view<const double>(p.param_infilt_ubc_P0AGEN),
+                   view<const double>(p.param_percola_arn_k), view<const double>(p.param_percola_arn_thresh), n_thread, out_ptr);
+  return out_;
+}
+
+int main()
+{
+  std::vector<double> E((std::size_t)n_time * n_spat), P((std::size_t)n_time * n_spat);
+  for (std::size_t i = 0; i < E.size(); i++) {
+    E[i] = uniform(0, 6);
+    P[i] = uniform(0, 1) < 0.6 ? 0 : uniform(0, 40);
+  }
+  param_mini p;
+  for (int j = 0; j < n_spat; j++) {
+    p.ground_capacity_mm.push_back(uniform(50, 300));
+    p.ground_water_mm.push_back(uniform(0, 1) * p.ground_capacity_mm[j]);
+    p.land_impermeableFrac_1.push_back(uniform(0, 0.5));
+    p.soil_capacity_mm.push_back(uniform(100, 500));
+    p.soil_potentialPercola_mm.push_back(uniform(1, 20));
+    p.soil_water_mm.push_back(uniform(0, 1) * p.soil_capacity_mm[j]);
+    // every fifth unit with IUHs long enough for the FFT
+    bool long_ = j % 5 == 4;
+    p.confluenLand_responseTime_TS.push_back(long_ ? uniform(60, 150) : uniform(1.5, 10));
+    p.confluenGround_responseTime_TS.push_back(long_ ? uniform(70, 200) : uniform(1.5, 20));
+    p.param_baseflow_grf_gamma.push_back(uniform(2, 7));
+    p.param_confluenLand_kel_k.push_back(uniform(1, 4));
+    p.param_evatrans_ubc_gamma.push_back(uniform(0.5, 2));
+    p.param_infilt_ubc_P0AGEN.push_back(uniform(0.1, 4));
+    p.param_percola_arn_k.push_back(uniform(0.1, 1));
+    p.param_percola_arn_thresh.push_back(uniform(0.1, 0.9));
+  }
+
+  output_mini out_vector = modell_vector(E, P, p);
+  int n_fail = 0;
+  for (int n_thread : {2, 3}) {
+    output_mini out_fused = modell_fused(E, P, p, n_thread);
+    for (int k = 0; k < 6; k++) {
+      bool same_ = std::memcmp(out_fused[k].data(), out_vector[k].data(), out_vector[k].size() * sizeof(double)) == 0;
+      std::printf("%d threads, %-14s bitwise: %s\n", n_thread, core::EDCHM_mini_output[k].c_str(), same_ ? "ok" : "FAIL");
+      n_fail += !same_;
+    }
+  }
+  return n_fail ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+// Checks the streaming objectives against the two-pass formulas, without R
+//
+// test_objective feeds `objective::gof_sum` one step at a time with a
+// simulated and an observed flow series (20000 steps, 5 % NA observation) and
+// fails when the NSE, KGE, RMSE, PBIAS or log-NSE differ from the two-pass
+// formulas of `hydroGOF` (long double, NA steps left out, log epsilon 1 % of
+// the mean observation) by more than 1e-12 of max(1, |value|), or when an
+// accumulator without steps does not give NaN.
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "EDCHM_objective.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+
+// a flashy flow: a recession with random peaks
+static std::vector<double> flow(int n_time)
+{
+  std::uniform_real_distribution<double> u_(0, 1);
+  std::vector<double> x_(n_time);
+  double q_ = 5;
+  for (double& x : x_) {
+    q_ = q_ * 0.93 + (u_(rng) < 0.1 ? 200 * u_(rng) : 0);
+    x = q_;
+  }
+  return x_;
+}
+
+// the two-pass objectives, in the order of `objective::gof_name`
+static std::vector<long double> two_pass(const std::vector<double>& sim, const std::vector<double>& obs, double log_epsilon)
+{
+  long double n_ = 0, sum_sim = 0, sum_obs = 0, sum_logObs = 0;
+  for (size_t i = 0; i < obs.size(); i++) {
+    if (std::isnan(obs[i])) continue;
+    n_ += 1;
+    sum_sim += sim[i];
+    sum_obs += obs[i];
+    sum_logObs += std::log((long double)obs[i] + log_epsilon);
+  }
+  long double mean_sim = sum_sim / n_, mean_obs = sum_obs / n_, mean_logObs = sum_logObs / n_;
+  long double SSE = 0, SS_obs = 0, SS_sim = 0, C_ = 0, SSE_log = 0, SS_logObs = 0;
+  for (size_t i = 0; i < obs.size(); i++) {
+    if (std::isnan(obs[i])) continue;
+    long double s_ = sim[i], o_ = obs[i];
+    long double log_sim = std::log(s_ + log_epsilon), log_obs = std::log(o_ + log_epsilon);
+    SSE += (s_ - o_) * (s_ - o_);
+    SS_obs += (o_ - mean_obs) * (o_ - mean_obs);
+    SS_sim += (s_ - mean_sim) * (s_ - mean_sim);
+    C_ += (s_ - mean_sim) * (o_ - mean_obs);
+    SSE_log += (log_sim - log_obs) * (log_sim - log_obs);
+    SS_logObs += (log_obs - mean_logObs) * (log_obs - mean_logObs);
+  }
+  long double r_ = C_ / std::sqrt(SS_sim * SS_obs), alpha_ = std::sqrt(SS_sim / SS_obs), beta_ = mean_sim / mean_obs;
+  return {
+    1 - SSE / SS_obs,
+    1 - std::sqrt((r_ - 1) * (r_ - 1) + (alpha_ - 1) * (alpha_ - 1) + (beta_ - 1) * (beta_ - 1)),
+    std::sqrt(SSE / n_),
+    100 * (sum_sim - sum_obs) / sum_obs,
+    1 - SSE_log / SS_logObs
+  };
+}
+
+int main()
+{
+  const int n_time = 20000;
+  std::vector<double> obs = flow(n_time), sim(n_time);
+  std::uniform_real_distribution<double> u_(0, 1);
+  for (int i = 0; i < n_time; i++) {
+    sim[i] = obs[i] * (0.8 + 0.3 * u_(rng)) + 0.5;
+    if (u_(rng) < 0.05) obs[i] = std::nan("");
+  }
+
+  double log_epsilon = objective::gof_logEpsilon(obs.data(), n_time);
+  objective::gof_sum gof_(log_epsilon);
+  for (int i = 0; i < n_time; i++) gof_.add(sim[i], obs[i]);
+  std::vector<long double> value_ref = two_pass(sim, obs, log_epsilon);
+
+  int n_fail = 0;
+  for (size_t k = 0; k < objective::gof_name.size(); k++) {
+    double value_ = objective::gof_value(gof_, k);
+    double diff_ = (double)std::fabs(value_ - value_ref[k]) / std::max(1.0L, std::fabs(value_ref[k]));
+    bool fail_ = !(diff_ <= 1e-12);
+    std::printf("%-6s streaming %.15g, two-pass %.15Lg, diff %.2e: %s\n",
+                objective::gof_name[k].c_str(), value_, value_ref[k], diff_, fail_ ? "FAIL" : "ok");
+    n_fail += fail_;
+  }
+
+  // 1 % of the mean observation
+  long double sum_ = 0, n_ = 0;
+  for (double o_ : obs) if (!std::isnan(o_)) { sum_ += o_; n_ += 1; }
+  bool fail_epsilon = !(std::fabs(log_epsilon - sum_ / n_ / 100) <= 1e-12 * log_epsilon);
+  std::printf("log epsilon %.15g: %s\n", log_epsilon, fail_epsilon ? "FAIL" : "ok");
+  n_fail += fail_epsilon;
+
+  objective::gof_sum empty_(1.0);
+  empty_.add(1.0, std::nan(""));
+  bool fail_empty = false;
+  for (size_t k = 0; k < objective::gof_name.size(); k++) fail_empty = fail_empty || !std::isnan(objective::gof_value(empty_, k));
+  std::printf("no observation gives NaN: %s\n", fail_empty ? "FAIL" : "ok");
+  n_fail += fail_empty;
+  return n_fail ? 1 : 0;
+}
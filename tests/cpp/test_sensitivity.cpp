@@ -0,0 +1,135 @@
+// Checks the forward-mode sensitivities against central differences, without R
+//
+// test_sensitivity runs the lumped GR4J and mini of EDCHM_sensitivity.h on
+// random daily forcing (1500 steps) with every parameter seeded, and fails when
+// - the stream flow is not bitwise the one of `core::EDCHM_GR4J` /
+//   `core::EDCHM_mini` with one spatial unit
+// - d(stream flow) / d(parameter) differs from the central difference of the
+//   `double` model by more than 1e-6 of its largest value
+// - the gradient of the NSE and the KGE differs from the central difference
+//   by more than 1e-6 of the largest gradient entry
+// The step is 1e-6 of the parameter; the parameters sit away from the
+// thresholds, so no step of the difference takes another branch.
+// It is registered with CTest (see CMakeLists.txt).
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+#include "EDCHM_sensitivity.h"
+
+using namespace EDCHM;
+
+static std::mt19937 rng(42);
+static const int n_time = 1500;
+
+static double uniform(double a, double b)
+{
+  return std::uniform_real_distribution<double>(a, b)(rng);
+}
+
+// the stream flow of the `double` model with one parameter set
+typedef std::function<void(const std::vector<double>&, double*)> modell_double;
+
+typedef void (*modell_sensitivity)(int, view<const double>, view<const double>, const std::vector<double>&, const std::vector<int>&,
+                                   view<const double>, const objective::gof_sum&, int, double*, double*, double*, double*);
+
+// the number of failed checks of one model
+static int test_modell(
+    const char* label,
+    modell_sensitivity modell_dual,
+    modell_double modell_,
+    const std::vector<double>& param,
+    const std::vector<double>& E,
+    const std::vector<double>& P
+)
+{
+  int n_param = param.size(), n_fail = 0;
+  std::vector<int> seed(n_param);
+  for (int k = 0; k < n_param; k++) seed[k] = k;
+
+  // the observation: the model with other parameters and some noise
+  std::vector<double> param_obs(param), observe(n_time);
+  for (double& p : param_obs) p *= uniform(0.9, 1.1);
+  modell_(param_obs, observe.data());
+  for (double& o : observe) o *= uniform(0.9, 1.1);
+
+  std::vector<double> streamflow_(n_time), sensitivity_(n_time * n_param), streamflow_double(n_time);
+  modell_(param, streamflow_double.data());
+  std::vector<double> plus_(n_time), minus_(n_time);
+
+  for (int objective_k = 0; objective_k < 2; objective_k++) {
+    double objective_ = 0;
+    std::vector<double> gradient_(n_param);
+    modell_dual(n_time, view<const double>(E), view<const double>(P), param, seed, view<const double>(observe), objective::gof_sum(),
+                 objective_k, streamflow_.data(), sensitivity_.data(), &objective_, gradient_.data());
+    auto objective_of = [&](const std::vector<double>& Q_) {
+      objective::gof_sum gof_;
+      for (int i = 0; i < n_time; i++) gof_.add(Q_[i], observe[i]);
+      return objective::gof_value(gof_, objective_k);
+    };
+
+    bool same_ = std::memcmp(streamflow_.data(), streamflow_double.data(), n_time * sizeof(double)) == 0;
+    double err_sensitivity = 0, err_gradient = 0, max_gradient = 0;
+    for (int k = 0; k < n_param; k++) {
+      double h_ = 1e-6 * std::fabs(param[k]);
+      std::vector<double> param_plus(param), param_minus(param);
+      param_plus[k] += h_;
+      param_minus[k] -= h_;
+      modell_(param_plus, plus_.data());
+      modell_(param_minus, minus_.data());
+      double max_ = 0, diff_ = 0;
+      for (int i = 0; i < n_time; i++) {
+        double fd_ = (plus_[i] - minus_[i]) / (2 * h_);
+        max_ = std::max(max_, std::fabs(fd_));
+        diff_ = std::max(diff_, std::fabs(sensitivity_[(std::size_t)k * n_time + i] - fd_));
+      }
+      if (max_ > 0) err_sensitivity = std::max(err_sensitivity, diff_ / max_);
+      double fd_gradient = (objective_of(plus_) - objective_of(minus_)) / (2 * h_);
+      err_gradient = std::max(err_gradient, std::fabs(gradient_[k] - fd_gradient));
+      max_gradient = std::max(max_gradient, std::fabs(fd_gradient));
+    }
+    err_gradient /= max_gradient;
+
+    int n_fail_k = !same_ + !(err_sensitivity <= 1e-6) + !(err_gradient <= 1e-6);
+    std::printf("%-5s %s: stream flow bitwise %d, d(stream flow) max|diff|/max %.2e, gradient max|diff|/max %.2e: %s\n",
+                label, objective::gof_name[objective_k].c_str(), same_, err_sensitivity, err_gradient, n_fail_k ? "FAIL" : "ok");
+    n_fail += n_fail_k;
+  }
+  return n_fail;
+}
+
+int main()
+{
+  std::vector<double> E(n_time), P(n_time);
+  for (int i = 0; i < n_time; i++) {
+    E[i] = uniform(0, 5);
+    P[i] = uniform(0, 1) < 0.6 ? 0 : uniform(0, 30);
+  }
+  int n_fail = 0;
+
+  // S_, R_, X_1, X_2, X_3, X_4
+  std::vector<double> param_GR4J = {150, 40, 350, -1.2, 90, 2.3};
+  n_fail += test_modell("GR4J", core::EDCHM_GR4J_sensitivity,
+    [&](const std::vector<double>& p_, double* Q_) {
+      std::vector<double*> out_GR4J(core::EDCHM_GR4J_output.size(), nullptr);
+      out_GR4J.back() = Q_;
+      core::EDCHM_GR4J(n_time, 1, view<const double>(E), view<const double>(P), view<const double>(&p_[0], 1), view<const double>(&p_[1], 1),
+                       view<const double>(&p_[2], 1), view<const double>(&p_[3], 1), view<const double>(&p_[4], 1), view<const double>(&p_[5], 1),
+                       1, out_GR4J, true);
+    }, param_GR4J, E, P);
+
+  // in the order of `EDCHM_mini_ensembleParam`
+  std::vector<double> param_mini = {180, 60, 0.15, 260, 8, 90, 3.4, 6.3, 3.2, 2.2, 1.4, 2.1, 0.4, 0.6};
+  n_fail += test_modell("mini", core::EDCHM_mini_sensitivity,
+    [&](const std::vector<double>& p_, double* Q_) {
+      std::vector<double*> out_mini(core::EDCHM_mini_output.size(), nullptr);
+      out_mini.back() = Q_;
+      std::vector<view<const double>> v_;
+      for (const double& p : p_) v_.push_back(view<const double>(&p, 1));
+      core::EDCHM_mini(n_time, 1, view<const double>(E), view<const double>(P), v_[0], v_[1], v_[2], v_[3], v_[4], v_[5], v_[6],
+                       v_[7], v_[8], v_[9], v_[10], v_[11], v_[12], v_[13], 1, out_mini);
+    }, param_mini, E, P);
+  return n_fail ? 1 : 0;
+}